@@ -0,0 +1,387 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "ai_benchmark.hpp"
+
+#include <stdlib.h>
+#include <algorithm>
+
+#include "race_manager.hpp"
+#include "graphics/scene.hpp"
+#include "karts/kart.hpp"
+#include "modes/world.hpp"
+#include "network/network_manager.hpp"
+#include "robots/ai_properties.hpp"
+#include "tracks/track.hpp"
+#include "utils/random_generator.hpp"
+#include "utils/string_utils.hpp"
+#include "utils/worker_processes.hpp"
+
+AIBenchmark* ai_benchmark = 0;
+
+//-----------------------------------------------------------------------------
+AIBenchmark::AIBenchmark()
+{
+    m_num_seeds     = 3;
+    m_num_laps      = 3;
+    m_num_jobs      = 1;
+    m_first_race    = 0;
+    m_num_races     = 0;
+    m_races_done    = 0;
+    m_result_file   = NULL;
+    m_base_seed     = 0;
+    setDifficulties("easy,medium,hard");
+}   // AIBenchmark
+
+//-----------------------------------------------------------------------------
+/** Enables the benchmark for the specified robot types.
+ *  \param types Comma separated list of robot types (see
+ *         RaceManager::getRobotTypeName, e.g. default).
+ */
+void AIBenchmark::setTypes(const std::string &types)
+{
+    std::vector<std::string> names = StringUtils::split(types, ',');
+    m_types.clear();
+    for(unsigned int i=0; i<names.size(); i++)
+    {
+        int t;
+        for(t=0; t<RaceManager::RT_COUNT; t++)
+            if(names[i]==
+               RaceManager::getRobotTypeName((RaceManager::RobotType)t))
+                break;
+        if(t==RaceManager::RT_COUNT)
+        {
+            fprintf(stderr, "Robot type '%s' not found, use one of:",
+                    names[i].c_str());
+            for(t=0; t<RaceManager::RT_COUNT; t++)
+                fprintf(stderr, " %s", RaceManager::getRobotTypeName(
+                                           (RaceManager::RobotType)t));
+            fprintf(stderr, ".\n");
+            exit(-1);
+        }
+        m_types.push_back((RaceManager::RobotType)t);
+    }
+    if(m_types.size()>0) activate();
+}   // setTypes
+
+//-----------------------------------------------------------------------------
+/** Sets the difficulties each robot type is raced with.
+ *  \param difficulties Comma separated list of difficulties (easy, medium,
+ *         hard).
+ */
+void AIBenchmark::setDifficulties(const std::string &difficulties)
+{
+    std::vector<std::string> names = StringUtils::split(difficulties, ',');
+    m_difficulties.clear();
+    for(unsigned int i=0; i<names.size(); i++)
+    {
+        int d;
+        for(d=0; d<AIProperties::NUM_DIFFICULTIES; d++)
+            if(names[i]==AIProperties::getDifficultyName(
+                             (RaceManager::Difficulty)d))
+                break;
+        if(d==AIProperties::NUM_DIFFICULTIES)
+        {
+            fprintf(stderr, "Difficulty '%s' not found, use easy, medium "
+                            "or hard.\n", names[i].c_str());
+            exit(-1);
+        }
+        m_difficulties.push_back((RaceManager::Difficulty)d);
+    }
+}   // setDifficulties
+
+//-----------------------------------------------------------------------------
+/** Starts the worker processes (if more than one job is requested). This
+ *  must be called before the graphics are initialised. In the parent
+ *  process this function only returns after all workers are finished, and
+ *  it then prints the statistics and exits.
+ *  \return True in the process(es) that should run the races.
+ */
+bool AIBenchmark::forkWorkers()
+{
+    m_base_seed = RandomGenerator::getMasterSeed();
+    findTracks();
+    m_num_races = m_tracks.size()*m_types.size()*m_difficulties.size()
+                * m_num_seeds;
+    if(!WorkerProcesses::isSupported())
+    {
+        if(m_num_jobs>1)
+            fprintf(stderr, "Worker processes are not supported, "
+                            "using only one process.\n");
+        m_num_jobs = 1;
+    }
+    if(m_num_jobs<=1) return true;
+
+    // Distribute the races as evenly as possible to the workers.
+    const int num_races   = m_num_races;
+    const int num_workers = std::min(m_num_jobs, num_races);
+    WorkerProcesses workers;
+    int worker = workers.start(num_workers, /*use_commands*/false);
+    if(worker>=0)
+    {
+        m_result_file = workers.getResultFile(0);
+        m_first_race  = worker*(num_races/num_workers)
+                      + std::min(worker, num_races%num_workers);
+        m_num_races   = num_races/num_workers
+                      + (worker<num_races%num_workers ? 1 : 0);
+        return true;
+    }
+
+    // Parent process: collect all results.
+    for(int i=0; i<workers.getNumWorkers(); i++)
+        readResults(workers.getResultFile(i));
+    workers.finish();
+    printStatistics(stdout);
+    exit(0);
+    return true;
+}   // forkWorkers
+
+//-----------------------------------------------------------------------------
+/** Starts the first race. Called from main once everything is loaded.
+ */
+void AIBenchmark::start()
+{
+    race_manager->setMajorMode(RaceManager::MAJOR_MODE_SINGLE);
+    race_manager->setMinorMode(RaceManager::MINOR_MODE_QUICK_RACE);
+    network_manager->setupPlayerKartInfo();
+    m_races_done = 0;
+    if(m_num_races==0)
+    {
+        fprintf(stderr, "No tracks or difficulties for the AI benchmark.\n");
+        exit(-1);
+    }
+    startRace();
+}   // start
+
+//-----------------------------------------------------------------------------
+/** Returns the name under which the results of a race are collected, which
+ *  is the robot type and the difficulty (e.g. 'default/hard').
+ *  \param race Index of the race.
+ */
+std::string AIBenchmark::getName(int race) const
+{
+    const int n          = race / m_num_seeds;
+    const int difficulty = n % m_difficulties.size();
+    const int type       = (n / m_difficulties.size()) % m_types.size();
+    return std::string(RaceManager::getRobotTypeName(m_types[type])) + "/"
+         + AIProperties::getDifficultyName(m_difficulties[difficulty]);
+}   // getName
+
+//-----------------------------------------------------------------------------
+/** Starts the next race. The index of a race determines the track, robot
+ *  type, difficulty and seed, so the results don't depend on how the races
+ *  are distributed to workers. The seed doesn't depend on the robot type
+ *  or the difficulty, so all of them race with the same karts.
+ */
+void AIBenchmark::startRace()
+{
+    const int race       = m_first_race + m_races_done;
+    const int seed       = race % m_num_seeds;
+    const int n          = race / m_num_seeds;
+    const int difficulty = n % m_difficulties.size();
+    const int type       = (n / m_difficulties.size()) % m_types.size();
+    const int track      = n / (m_difficulties.size()*m_types.size());
+    RandomGenerator::setMasterSeed(m_base_seed + track*m_num_seeds + seed);
+    if(m_races_done>0) scene->clear();
+
+    race_manager->setRobotType(m_types[type]);
+    race_manager->setDifficulty(m_difficulties[difficulty]);
+    race_manager->setTrack(m_tracks[track]);
+    race_manager->setNumLaps(m_num_laps);
+    race_manager->computeRandomKartList();
+    race_manager->startNew();
+}   // startRace
+
+//-----------------------------------------------------------------------------
+/** Called from the world when the race is finished. It stores the results,
+ *  and marks the race to be finished. The next race is then started from
+ *  the main loop. Karts that didn't finish before the time limit get the
+ *  time limit as race time.
+ *  \param world The world of the finished race.
+ */
+void AIBenchmark::raceFinished(const World *world)
+{
+    const std::string &track = world->getTrack()->getIdent();
+    const std::string type   = getName(m_first_race + m_races_done);
+    for(unsigned int i=0; i<race_manager->getNumKarts(); i++)
+    {
+        const Kart *kart    = world->getKart(i);
+        const bool finished = kart->hasFinishedRace();
+        const float time    = finished ? kart->getFinishTime()
+                                       : getTimeLimit(world);
+        const float lap_time = time/race_manager->getNumLaps();
+        if(m_result_file)
+            fprintf(m_result_file, "race %s %s %d %f %d %d %d %d\n",
+                    track.c_str(), type.c_str(), finished ? 1 : 0, lap_time,
+                    kart->getNumRescues(), kart->getNumShortcuts(),
+                    kart->getNumKartCrashes(), kart->getNumTrackCrashes());
+        else
+            addKartResult(track, type, finished, lap_time,
+                          kart->getNumRescues(), kart->getNumShortcuts(),
+                          kart->getNumKartCrashes(),
+                          kart->getNumTrackCrashes());
+    }
+    if(m_result_file)
+        fprintf(m_result_file, "ai %s %s %f %d\n", track.c_str(),
+                type.c_str(), world->getAITotalTime(),
+                world->getAIKartUpdates());
+    else
+        addAIResult(track, type, world->getAITotalTime(),
+                    world->getAIKartUpdates());
+    m_race_finished = true;
+}   // raceFinished
+
+//-----------------------------------------------------------------------------
+/** Starts the next race, or prints the statistics and exits once all
+ *  races are done.
+ */
+void AIBenchmark::startNextRace()
+{
+    m_race_finished = false;
+    m_races_done++;
+    printf("Race %d of %d finished.\n", m_races_done, m_num_races);
+    if(m_races_done < m_num_races)
+    {
+        startRace();
+        return;
+    }
+    if(m_result_file)
+        fclose(m_result_file);
+    else
+        printStatistics(stdout);
+    exit(0);
+}   // startNextRace
+
+//-----------------------------------------------------------------------------
+/** Reads the results written by a worker process.
+ *  \param f The file to read from.
+ */
+void AIBenchmark::readResults(FILE *f)
+{
+    char  s[1024], track[256], type[256];
+    int   finished, rescues, shortcuts, kart_crashes, track_crashes, n;
+    float lap_time;
+    double ai_time;
+    while(fgets(s, 1023, f))
+    {
+        if(sscanf(s, "race %255s %255s %d %f %d %d %d %d", track, type,
+                  &finished, &lap_time, &rescues, &shortcuts, &kart_crashes,
+                  &track_crashes)==8)
+            addKartResult(track, type, finished!=0, lap_time, rescues,
+                          shortcuts, kart_crashes, track_crashes);
+        else if(sscanf(s, "ai %255s %255s %lf %d", track, type,
+                       &ai_time, &n)==4)
+            addAIResult(track, type, ai_time, n);
+        else
+            fprintf(stderr, "Invalid benchmark result '%s' ignored.\n", s);
+    }
+}   // readResults
+
+//-----------------------------------------------------------------------------
+/** Adds the result of one kart in a race to the overall and to the track
+ *  statistics of the robot type and difficulty.
+ */
+void AIBenchmark::addKartResult(const std::string &track,
+                                const std::string &type, bool finished,
+                                float lap_time, int rescues, int shortcuts,
+                                int kart_crashes, int track_crashes)
+{
+    TypeStatistics *all[2];
+    all[0] = &m_type_statistics[type];
+    all[1] = &m_track_statistics[track][type];
+    for(unsigned int i=0; i<2; i++)
+    {
+        TypeStatistics *s = all[i];
+        s->m_karts++;
+        s->m_total_lap_time += lap_time;
+        s->m_rescues        += rescues;
+        s->m_shortcuts      += shortcuts;
+        s->m_kart_crashes   += kart_crashes;
+        s->m_track_crashes  += track_crashes;
+        if(!finished) s->m_not_finished++;
+    }
+}   // addKartResult
+
+//-----------------------------------------------------------------------------
+/** Adds the AI time of one race to the overall and to the track
+ *  statistics of the robot type and difficulty.
+ */
+void AIBenchmark::addAIResult(const std::string &track,
+                              const std::string &type, double ai_time,
+                              int ai_kart_updates)
+{
+    TypeStatistics *all[2];
+    all[0] = &m_type_statistics[type];
+    all[1] = &m_track_statistics[track][type];
+    for(unsigned int i=0; i<2; i++)
+    {
+        all[i]->m_races++;
+        all[i]->m_ai_time         += ai_time;
+        all[i]->m_ai_kart_updates += ai_kart_updates;
+    }
+}   // addAIResult
+
+//-----------------------------------------------------------------------------
+/** Prints one table of statistics for each robot type and difficulty. All
+ *  values except the number of races and the number of karts that didn't
+ *  finish are means per kart and race.
+ *  \param out File to print to.
+ *  \param s The statistics to print.
+ */
+void AIBenchmark::printTypeStatistics(FILE *out,
+                                      const AllTypeStatistics &s) const
+{
+    fprintf(out, "  %-16s %6s %9s %8s %9s %10s %10s %8s %10s\n", "type",
+            "races", "lap time", "rescues", "shortcuts", "kart hits",
+            "track hits", "not fin.", "us/update");
+    for(AllTypeStatistics::const_iterator i=s.begin(); i!=s.end(); i++)
+    {
+        const TypeStatistics &t = i->second;
+        if(t.m_karts==0) continue;
+        fprintf(out, "  %-16s %6d %9.3f %8.3f %9.3f %10.3f %10.3f %8d "
+                     "%10.2f\n",
+                i->first.c_str(), t.m_races, t.m_total_lap_time/t.m_karts,
+                (float)t.m_rescues/t.m_karts, (float)t.m_shortcuts/t.m_karts,
+                (float)t.m_kart_crashes/t.m_karts,
+                (float)t.m_track_crashes/t.m_karts, t.m_not_finished,
+                t.m_ai_kart_updates>0 ? t.m_ai_time/t.m_ai_kart_updates
+                                      : 0.0);
+    }
+}   // printTypeStatistics
+
+//-----------------------------------------------------------------------------
+/** Prints the statistics for all robot types and difficulties, and for
+ *  each track.
+ *  \param out File to print to.
+ */
+void AIBenchmark::printStatistics(FILE *out) const
+{
+    fprintf(out, "\nAI benchmark: %d races on %d tracks, %d seeds, "
+            "%d laps.\n", m_num_races, (int)m_tracks.size(), m_num_seeds,
+            m_num_laps);
+    fprintf(out, "AI parameters: %s.\n\n", ai_properties->getFiles().c_str());
+    fprintf(out, "All tracks:\n");
+    printTypeStatistics(out, m_type_statistics);
+    for(std::map<std::string, AllTypeStatistics>::const_iterator
+        i=m_track_statistics.begin(); i!=m_track_statistics.end(); i++)
+    {
+        fprintf(out, "\nTrack '%s':\n", i->first.c_str());
+        printTypeStatistics(out, i->second);
+    }
+}   // printStatistics
+
+/* EOF */
@@ -0,0 +1,132 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_AI_BENCHMARK_HPP
+#define HEADER_AI_BENCHMARK_HPP
+
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "batch_race.hpp"
+#include "race_manager.hpp"
+
+class World;
+
+/** Runs races without graphics and with all karts driven by the AI on every
+ *  (non arena) track, once for each robot type, difficulty and random seed,
+ *  and prints the quality of the AI (lap times, rescues, shortcuts,
+ *  collisions, karts not finished) together with the time the AI needs per
+ *  kart update. Karts that don't finish before the time limit of the race
+ *  (see BatchRace::getTimeLimit) get the time limit as penalty race time. This
+ *  is used to check that changes to the AI keep the quality while reducing
+ *  the cost. The robot types are the AI classes (see World::loadRobot),
+ *  the difficulties the configurations of the AI. Each combination of type
+ *  and difficulty uses the same seeds, so it races with the same karts on
+ *  the same tracks.
+ *  Like the grand prix simulation the races can be distributed over several
+ *  worker processes (--ai-bench-jobs), which send the results of each race
+ *  through a pipe to the parent process.
+ */
+class AIBenchmark : public BatchRace
+{
+private:
+    /** Statistics of one robot type and difficulty (either overall, or for
+     *  one track). */
+    struct TypeStatistics
+    {
+        int    m_races;
+        /** Number of karts summed over all races. */
+        int    m_karts;
+        double m_total_lap_time;
+        int    m_rescues;
+        int    m_shortcuts;
+        int    m_kart_crashes;
+        int    m_track_crashes;
+        /** Number of karts that didn't finish a race in time. */
+        int    m_not_finished;
+        /** Time spent in the AI in microseconds. */
+        double m_ai_time;
+        int    m_ai_kart_updates;
+        TypeStatistics() : m_races(0), m_karts(0), m_total_lap_time(0.0),
+                           m_rescues(0), m_shortcuts(0), m_kart_crashes(0),
+                           m_track_crashes(0), m_not_finished(0),
+                           m_ai_time(0.0),
+                           m_ai_kart_updates(0) {}
+    };   // TypeStatistics
+    typedef std::map<std::string, TypeStatistics> AllTypeStatistics;
+
+    /** The robot types to compare. */
+    std::vector<RaceManager::RobotType>  m_types;
+    /** The difficulties each robot type is raced with. */
+    std::vector<RaceManager::Difficulty> m_difficulties;
+    /** Number of random seeds for each track, type and difficulty. */
+    int                      m_num_seeds;
+    /** Number of laps of each race. */
+    int                      m_num_laps;
+    /** Number of worker processes to use. */
+    int                      m_num_jobs;
+    /** Index of the first and number of races of this process. */
+    int                      m_first_race;
+    int                      m_num_races;
+    /** Number of races finished by this process. */
+    int                      m_races_done;
+    /** If this is a worker process, the results are written to this file
+     *  (a pipe to the parent process), otherwise this is NULL. */
+    FILE                    *m_result_file;
+    /** The master seed at startup, race seeds are this plus the seed index.*/
+    unsigned int             m_base_seed;
+
+    AllTypeStatistics        m_type_statistics;
+    std::map<std::string, AllTypeStatistics> m_track_statistics;
+
+    void addKartResult(const std::string &track, const std::string &type,
+                       bool finished, float lap_time, int rescues,
+                       int shortcuts, int kart_crashes, int track_crashes);
+    void addAIResult  (const std::string &track, const std::string &type,
+                       double ai_time, int ai_kart_updates);
+    void readResults  (FILE *f);
+    std::string getName(int race) const;
+    void startRace    ();
+    void printStatistics(FILE *out) const;
+    void printTypeStatistics(FILE *out, const AllTypeStatistics &s) const;
+public:
+         AIBenchmark();
+    void setTypes     (const std::string &types);
+    void setDifficulties(const std::string &difficulties);
+    virtual bool forkWorkers  ();
+    virtual void start        ();
+    virtual void raceFinished (const World *world);
+    virtual void startNextRace();
+    // ------------------------------------------------------------------------
+    /** Sets the number of random seeds for each track, robot type and
+     *  difficulty. */
+    void setNumSeeds(int n)            { m_num_seeds = n;        }
+    // ------------------------------------------------------------------------
+    /** Sets the number of laps of each race. */
+    void setNumLaps(int n)             { m_num_laps  = n;        }
+    // ------------------------------------------------------------------------
+    /** Sets the number of worker processes. */
+    void setNumJobs(int n)             { m_num_jobs  = n;        }
+};   // AIBenchmark
+
+extern AIBenchmark *ai_benchmark;
+
+#endif
+
+/* EOF */
@@ -0,0 +1,381 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "ai_tuner.hpp"
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "file_manager.hpp"
+#include "stk_config.hpp"
+#include "graphics/scene.hpp"
+#include "karts/kart.hpp"
+#include "modes/world.hpp"
+#include "network/network_manager.hpp"
+#include "utils/random_generator.hpp"
+#include "utils/worker_processes.hpp"
+
+AITuner* ai_tuner = 0;
+
+/** Time (in seconds) added to the fitness for each rescue of a kart. */
+static const float RESCUE_PENALTY     = 5.0f;
+/** Time (in seconds) added to the fitness for each kart that didn't finish
+ *  before the time limit (in addition to using the time limit as its lap
+ *  time). */
+static const float UNFINISHED_PENALTY = 60.0f;
+/** Initial step size as fraction of the range of a parameter. */
+static const float INITIAL_STEP       = 0.2f;
+/** Factors by which the step size changes after a successful or an
+ *  unsuccessful iteration. */
+static const float STEP_INCREASE      = 1.2f;
+static const float STEP_DECREASE      = 0.7f;
+/** Minimum number of candidates evaluated in each iteration. */
+static const int   MIN_CANDIDATES     = 4;
+
+//-----------------------------------------------------------------------------
+AITuner::AITuner()
+{
+    m_difficulty     = RaceManager::RD_HARD;
+    m_num_iterations = 20;
+    m_num_jobs       = 1;
+    m_base_seed      = 0;
+    m_command_file   = NULL;
+    m_result_file    = NULL;
+    m_candidate_id   = 0;
+    m_track_index    = 0;
+    m_races_started  = 0;
+    m_fitness_sum    = 0.0;
+}   // AITuner
+
+//-----------------------------------------------------------------------------
+/** Enables the tuner for the specified difficulty.
+ *  \param difficulty Name of the difficulty (easy, medium, hard).
+ */
+void AITuner::setDifficulty(const std::string &difficulty)
+{
+    for(int i=0; i<AIProperties::NUM_DIFFICULTIES; i++)
+    {
+        RaceManager::Difficulty d = (RaceManager::Difficulty)i;
+        if(difficulty==AIProperties::getDifficultyName(d))
+        {
+            m_difficulty = d;
+            activate();
+            return;
+        }
+    }
+    fprintf(stderr, "Difficulty '%s' not found, use easy, medium or hard.\n",
+            difficulty.c_str());
+    exit(-1);
+}   // setDifficulty
+
+//-----------------------------------------------------------------------------
+/** Starts the worker processes. This must be called before the graphics
+ *  are initialised. The parent process runs the search, writes the best
+ *  parameters and exits, so this function only returns in the workers.
+ *  \return True in the worker processes.
+ */
+bool AITuner::forkWorkers()
+{
+    m_base_seed = RandomGenerator::getMasterSeed();
+    findTracks();
+    if(m_tracks.size()==0)
+    {
+        fprintf(stderr, "No tracks found for the AI tuner.\n");
+        exit(-1);
+    }
+    if(m_output=="")
+        m_output = file_manager->getUserConfigFile("ai.data");
+    if(!WorkerProcesses::isSupported())
+    {
+        fprintf(stderr, "The AI tuner needs worker processes, which are "
+                        "not supported.\n");
+        exit(-1);
+    }
+    if(m_num_jobs<1) m_num_jobs = 1;
+
+    WorkerProcesses workers;
+    if(workers.start(m_num_jobs, /*use_commands*/true)>=0)
+    {
+        m_command_file = workers.getCommandFile(0);
+        m_result_file  = workers.getResultFile(0);
+        return true;
+    }
+
+    search(workers);
+
+    for(int i=0; i<workers.getNumWorkers(); i++)
+        fprintf(workers.getCommandFile(i), "quit\n");
+    workers.finish();
+    exit(0);
+    return true;
+}   // forkWorkers
+
+//-----------------------------------------------------------------------------
+/** The adaptive random search, run in the parent process. It starts with
+ *  the current parameters of the difficulty, and in each iteration
+ *  evaluates random variations of the best parameters found so far. Only
+ *  the tunable parameters are changed.
+ *  \param workers The worker processes.
+ */
+void AITuner::search(const WorkerProcesses &workers)
+{
+    const int num_params = AIProperties::AP_COUNT;
+    RandomGenerator random;
+    random.seed(m_base_seed);
+
+    std::vector<Candidate> candidates(1);
+    Candidate &start = candidates[0];
+    for(int p=0; p<num_params; p++)
+        start.m_values[p] =
+            ai_properties->get(m_difficulty, (AIProperties::Parameter)p);
+    evaluate(&candidates, workers);
+    Candidate best = candidates[0];
+    printf("AI tuner: '%s' on %d tracks, initial parameters from %s, "
+           "initial fitness %f.\n",
+           AIProperties::getDifficultyName(m_difficulty),
+           (int)m_tracks.size(), ai_properties->getFiles().c_str(),
+           best.m_fitness);
+
+    float step = INITIAL_STEP;
+    const int num_candidates = std::max(m_num_jobs, MIN_CANDIDATES);
+    for(int iteration=0; iteration<m_num_iterations; iteration++)
+    {
+        candidates.resize(num_candidates);
+        for(int i=0; i<num_candidates; i++)
+        {
+            Candidate &c = candidates[i];
+            for(int p=0; p<num_params; p++)
+            {
+                AIProperties::Parameter param = (AIProperties::Parameter)p;
+                c.m_values[p] = best.m_values[p];
+                if(!AIProperties::isTunable(param)) continue;
+                const float min   = AIProperties::getMin(param);
+                const float max   = AIProperties::getMax(param);
+                float v = c.m_values[p]
+                        + (2.0f*random.getFloat()-1.0f)*step*(max-min);
+                if(AIProperties::isInteger(param)) v = floorf(v+0.5f);
+                c.m_values[p] = std::min(max, std::max(min, v));
+            }
+        }   // for i<num_candidates
+        evaluate(&candidates, workers);
+
+        int best_index = -1;
+        for(int i=0; i<num_candidates; i++)
+        {
+            if(candidates[i].m_fitness < best.m_fitness &&
+               (best_index<0 ||
+                candidates[i].m_fitness < candidates[best_index].m_fitness))
+                best_index = i;
+        }
+        if(best_index>=0)
+        {
+            best  = candidates[best_index];
+            step *= STEP_INCREASE;
+        }
+        else
+            step *= STEP_DECREASE;
+        printf("Iteration %d of %d: best fitness %f, step size %f.\n",
+               iteration+1, m_num_iterations, best.m_fitness, step);
+    }   // for iteration<m_num_iterations
+
+    applyCandidate(best);
+    printf("\nBest parameters for '%s' (fitness %f):\n",
+           AIProperties::getDifficultyName(m_difficulty), best.m_fitness);
+    for(int p=0; p<num_params; p++)
+        printf("  %-20s %f\n",
+               AIProperties::getName((AIProperties::Parameter)p),
+               best.m_values[p]);
+    ai_properties->save(m_output);
+    printf("Written to '%s'.\n", m_output.c_str());
+    if(m_output==file_manager->getUserConfigFile("ai.data"))
+        printf("This file replaces data/ai.data in all following games, "
+               "delete it to\nuse the default parameters again.\n");
+}   // search
+
+//-----------------------------------------------------------------------------
+/** Evaluates the candidates with the worker processes and sets their
+ *  fitness. All commands are sent at once (the candidates are distributed
+ *  round robin to the workers), and each worker processes its commands in
+ *  order.
+ *  \param candidates The candidates to evaluate.
+ *  \param workers The worker processes.
+ */
+void AITuner::evaluate(std::vector<Candidate> *candidates,
+                       const WorkerProcesses &workers)
+{
+    const unsigned int num_workers = workers.getNumWorkers();
+    for(unsigned int i=0; i<candidates->size(); i++)
+    {
+        FILE *f = workers.getCommandFile(i%num_workers);
+        fprintf(f, "eval %d", i);
+        for(int p=0; p<AIProperties::AP_COUNT; p++)
+            fprintf(f, " %f", (*candidates)[i].m_values[p]);
+        fprintf(f, "\n");
+    }
+    for(unsigned int i=0; i<num_workers; i++)
+        fflush(workers.getCommandFile(i));
+
+    for(unsigned int i=0; i<candidates->size(); i++)
+    {
+        char  s[1024];
+        int   id;
+        float fitness;
+        if(!fgets(s, 1023, workers.getResultFile(i%num_workers)) ||
+            sscanf(s, "result %d %f", &id, &fitness)!=2 || id!=(int)i)
+        {
+            fprintf(stderr, "Invalid result from worker %d.\n",
+                    i%num_workers);
+            exit(-1);
+        }
+        (*candidates)[i].m_fitness = fitness;
+    }
+}   // evaluate
+
+//-----------------------------------------------------------------------------
+/** Sets the parameters of a candidate for the tuned difficulty.
+ *  \param c The candidate.
+ */
+void AITuner::applyCandidate(const Candidate &c) const
+{
+    for(int p=0; p<AIProperties::AP_COUNT; p++)
+        ai_properties->set(m_difficulty, (AIProperties::Parameter)p,
+                           c.m_values[p]);
+}   // applyCandidate
+
+//-----------------------------------------------------------------------------
+/** Reads the next command in a worker process, and sets the parameters
+ *  of the candidate to evaluate.
+ *  \return False if the worker should exit.
+ */
+bool AITuner::readCommand()
+{
+    char s[1024];
+    if(!fgets(s, 1023, m_command_file)) return false;
+    if(!strncmp(s, "quit", 4)) return false;
+
+    Candidate c;
+    int n;
+    if(sscanf(s, "eval %d%n", &m_candidate_id, &n)!=1)
+    {
+        fprintf(stderr, "Invalid tuner command '%s'.\n", s);
+        return false;
+    }
+    const char *p = s+n;
+    for(int i=0; i<AIProperties::AP_COUNT; i++)
+    {
+        char *end;
+        c.m_values[i] = (float)strtod(p, &end);
+        if(end==p)
+        {
+            fprintf(stderr, "Invalid tuner command '%s'.\n", s);
+            return false;
+        }
+        p = end;
+    }
+    applyCandidate(c);
+    m_track_index = 0;
+    m_fitness_sum = 0.0;
+    return true;
+}   // readCommand
+
+//-----------------------------------------------------------------------------
+/** Starts the first race of a worker. Called from main once everything is
+ *  loaded.
+ */
+void AITuner::start()
+{
+    race_manager->setMajorMode(RaceManager::MAJOR_MODE_SINGLE);
+    race_manager->setMinorMode(RaceManager::MINOR_MODE_QUICK_RACE);
+    race_manager->setDifficulty(m_difficulty);
+    network_manager->setupPlayerKartInfo();
+    // The time budget depends on the speed of the machine, which would
+    // make the fitness of a candidate non deterministic.
+    stk_config->m_ai_time_budget = 0;
+    m_races_started = 0;
+    if(!readCommand()) exit(0);
+    startRace();
+}   // start
+
+//-----------------------------------------------------------------------------
+/** Starts the race on the current track. The seed only depends on the
+ *  track, so all candidates race with the same karts.
+ */
+void AITuner::startRace()
+{
+    RandomGenerator::setMasterSeed(m_base_seed + m_track_index);
+    if(m_races_started>0) scene->clear();
+    m_races_started++;
+
+    race_manager->setTrack(m_tracks[m_track_index]);
+    race_manager->setNumLaps(1);
+    race_manager->computeRandomKartList();
+    race_manager->startNew();
+}   // startRace
+
+//-----------------------------------------------------------------------------
+/** Called from the world when the race is finished (all karts finished,
+ *  or the time limit was reached). It adds the fitness of this race, and
+ *  marks the race to be finished. The next race is then started from the
+ *  main loop.
+ *  \param world The world of the finished race.
+ */
+void AITuner::raceFinished(const World *world)
+{
+    const unsigned int num_karts = race_manager->getNumKarts();
+    double sum = 0.0;
+    for(unsigned int i=0; i<num_karts; i++)
+    {
+        const Kart *kart = world->getKart(i);
+        if(kart->hasFinishedRace())
+            sum += kart->getFinishTime()/race_manager->getNumLaps();
+        else
+            sum += getTimeLimit(world)/race_manager->getNumLaps()
+                 + UNFINISHED_PENALTY;
+        sum += RESCUE_PENALTY*kart->getNumRescues();
+    }
+    m_fitness_sum  += sum/num_karts;
+    m_race_finished = true;
+}   // raceFinished
+
+//-----------------------------------------------------------------------------
+/** Starts the next race. Once all tracks are done, the fitness of the
+ *  candidate is sent to the parent, and the next command is read.
+ */
+void AITuner::startNextRace()
+{
+    m_race_finished = false;
+    m_track_index++;
+    if(m_track_index < (int)m_tracks.size())
+    {
+        startRace();
+        return;
+    }
+    fprintf(m_result_file, "result %d %f\n", m_candidate_id,
+            m_fitness_sum/m_tracks.size());
+    fflush(m_result_file);
+    if(!readCommand())
+    {
+        fclose(m_command_file);
+        fclose(m_result_file);
+        exit(0);
+    }
+    startRace();
+}   // startNextRace
+
+/* EOF */
@@ -0,0 +1,116 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_AI_TUNER_HPP
+#define HEADER_AI_TUNER_HPP
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "batch_race.hpp"
+#include "race_manager.hpp"
+#include "robots/ai_properties.hpp"
+
+class World;
+class WorkerProcesses;
+
+/** Optimises the tunable AI parameters (see AIProperties) of one difficulty
+ *  offline. A candidate set of parameters is evaluated by racing one lap
+ *  on every (non arena) track without graphics and with all karts driven
+ *  by the AI; the fitness is the mean lap time plus a penalty for each
+ *  rescue (lower is better). A race is stopped at its time limit (see
+ *  BatchRace::getTimeLimit), so parameters that make karts get stuck can't
+ *  block a worker. A kart that didn't finish counts with the time limit
+ *  as lap time plus an additional penalty. The seeds only depend on the track, and the
+ *  AI time budget is disabled, so evaluating the same parameters twice
+ *  gives the same fitness.
+ *  The parent process runs an adaptive random search: in each iteration
+ *  a number of random variations of the best parameters are evaluated in
+ *  parallel by persistent worker processes. The step size is increased if
+ *  a better candidate was found, and decreased otherwise. The best
+ *  parameters are written in the format of ai.data, by default to ai.data
+ *  in the config directory, which the game loads after data/ai.data.
+ *  Other output files can be tested with --ai-config and the AI benchmark.
+ *  Each worker reads 'eval <id> <values>' lines from a command pipe, and
+ *  answers with 'result <id> <fitness>' on a result pipe.
+ */
+class AITuner : public BatchRace
+{
+private:
+    /** One set of parameters and its fitness. */
+    struct Candidate
+    {
+        float m_values[AIProperties::AP_COUNT];
+        float m_fitness;
+    };   // Candidate
+
+    /** The difficulty whose parameters are tuned. */
+    RaceManager::Difficulty  m_difficulty;
+    /** Number of iterations of the search. */
+    int                      m_num_iterations;
+    /** Number of worker processes to use. */
+    int                      m_num_jobs;
+    /** Name of the file the best parameters are written to. */
+    std::string              m_output;
+    /** The master seed at startup, race seeds are this plus the track
+     *  index. */
+    unsigned int             m_base_seed;
+
+    /** The following variables are only used in a worker process. */
+    /** Commands are read from this file (a pipe from the parent). */
+    FILE                    *m_command_file;
+    /** Results are written to this file (a pipe to the parent). */
+    FILE                    *m_result_file;
+    /** Id of the candidate that is currently evaluated. */
+    int                      m_candidate_id;
+    /** Index of the track of the current race. */
+    int                      m_track_index;
+    /** Number of races started by this worker. */
+    int                      m_races_started;
+    /** Sum of the fitness of all races of the current candidate. */
+    double                   m_fitness_sum;
+
+    void search        (const WorkerProcesses &workers);
+    void evaluate      (std::vector<Candidate> *candidates,
+                        const WorkerProcesses &workers);
+    void applyCandidate(const Candidate &c) const;
+    bool readCommand   ();
+    void startRace     ();
+public:
+         AITuner();
+    void setDifficulty(const std::string &difficulty);
+    virtual bool forkWorkers  ();
+    virtual void start        ();
+    virtual void raceFinished (const World *world);
+    virtual void startNextRace();
+    // ------------------------------------------------------------------------
+    /** Sets the number of iterations of the search. */
+    void setNumIterations(int n)            { m_num_iterations = n;    }
+    // ------------------------------------------------------------------------
+    /** Sets the number of worker processes. */
+    void setNumJobs(int n)                  { m_num_jobs = n;          }
+    // ------------------------------------------------------------------------
+    /** Sets the name of the file the best parameters are written to. */
+    void setOutput(const std::string &s)    { m_output = s;            }
+};   // AITuner
+
+extern AITuner *ai_tuner;
+
+#endif
+
+/* EOF */
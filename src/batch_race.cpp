@@ -0,0 +1,94 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "batch_race.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "race_manager.hpp"
+#include "user_config.hpp"
+#include "modes/world.hpp"
+#include "tracks/track.hpp"
+#include "tracks/track_manager.hpp"
+
+BatchRace *BatchRace::m_active = NULL;
+
+/** Speed (in m/s) that defines the reference lap time of a track. It is a
+ *  bit below the maximum speed of the karts on the easy difficulty. */
+static const float REFERENCE_SPEED   = 20.0f;
+/** A batch race is stopped after this multiple of the reference time. */
+static const float TIME_LIMIT_FACTOR = 4.0f;
+
+//-----------------------------------------------------------------------------
+BatchRace::BatchRace()
+{
+    m_race_finished = false;
+}   // BatchRace
+
+//-----------------------------------------------------------------------------
+BatchRace::~BatchRace()
+{
+    if(m_active==this) m_active = NULL;
+}   // ~BatchRace
+
+//-----------------------------------------------------------------------------
+/** Makes this batch mode the active one. This switches to batch mode (all
+ *  karts are AI karts, fixed time step) without graphics. Note that the
+ *  profile mode is not used, since it changes the game play (e.g. bananas
+ *  have no effect when profiling).
+ */
+void BatchRace::activate()
+{
+    if(m_active && m_active!=this)
+    {
+        fprintf(stderr, "Only one batch mode (grand prix simulation, "
+                        "AI benchmark or AI tuner) can be used.\n");
+        exit(-1);
+    }
+    m_active                   = this;
+    user_config->m_batch_mode  = true;
+    user_config->m_no_graphics = true;
+}   // activate
+
+//-----------------------------------------------------------------------------
+/** Collects all tracks to race on in m_tracks. Arenas are skipped, since
+ *  there are no laps to drive in a battle.
+ */
+void BatchRace::findTracks()
+{
+    m_tracks.clear();
+    for(unsigned int i=0; i<track_manager->getNumberOfTracks(); i++)
+    {
+        const Track *track = track_manager->getTrack(i);
+        if(!track->isArena()) m_tracks.push_back(track->getIdent());
+    }
+}   // findTracks
+
+//-----------------------------------------------------------------------------
+/** Returns the time after which a race is stopped, which is a fixed multiple
+ *  of the reference time for all laps (see REFERENCE_SPEED). Karts that
+ *  haven't finished by then count as not finished.
+ *  \param world The world of the race.
+ */
+float BatchRace::getTimeLimit(const World *world) const
+{
+    const float lap_time = world->getTrack()->getTrackLength()/REFERENCE_SPEED;
+    return TIME_LIMIT_FACTOR*race_manager->getNumLaps()*lap_time;
+}   // getTimeLimit
+
+/* EOF */
@@ -0,0 +1,86 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_BATCH_RACE_HPP
+#define HEADER_BATCH_RACE_HPP
+
+#include <string>
+#include <vector>
+
+class World;
+
+/** Base class of the batch modes, which run a series of races without
+ *  graphics and with all karts driven by the AI (e.g. the grand prix
+ *  simulation). At most one batch mode can be active. main() forks the
+ *  workers of the active batch mode and starts it, the race modes report
+ *  the end of a race to it, and the main loop then starts the next race
+ *  (the world can't be deleted during its update). So a batch mode only
+ *  has to implement what happens between the races.
+ *  A batch race is stopped once it reaches its time limit (see
+ *  getTimeLimit), so that a stuck kart can't block a batch run forever.
+ *  raceFinished is then called with some karts not finished.
+ */
+class BatchRace
+{
+private:
+    /** The active batch mode, or NULL. */
+    static BatchRace *m_active;
+
+protected:
+    /** Set when a race is finished, the next race is then started
+     *  from the main loop. */
+    bool              m_race_finished;
+    /** The tracks to race on, see findTracks(). */
+    std::vector<std::string> m_tracks;
+
+    void              activate();
+    void              findTracks();
+
+public:
+                      BatchRace();
+    virtual          ~BatchRace();
+    /** Starts the worker processes (if any). This must be called before
+     *  the graphics are initialised. The parent process does not return
+     *  from this function if workers are used.
+     *  \return True in the process(es) that run the races. */
+    virtual bool      forkWorkers  () = 0;
+    /** Starts the first race. Called from main once everything is
+     *  loaded. */
+    virtual void      start        () = 0;
+    /** Called from the world when the race is finished, i.e. all karts
+     *  have finished or the time limit is reached.
+     *  \param world The world of the finished race. */
+    virtual void      raceFinished (const World *world) = 0;
+    /** Called from the main loop once the world of a finished race is not
+     *  updated anymore. Starts the next race, or exits. */
+    virtual void      startNextRace() = 0;
+    float             getTimeLimit (const World *world) const;
+    // ------------------------------------------------------------------------
+    /** Returns the active batch mode, or NULL if no batch mode is used. */
+    static BatchRace *getActive()            { return m_active;        }
+    // ------------------------------------------------------------------------
+    /** Returns true if this batch mode is the active one. */
+    bool              isEnabled() const      { return m_active==this;  }
+    // ------------------------------------------------------------------------
+    /** Returns true if a race is finished, and the next race should be
+     *  started by calling startNextRace(). */
+    bool              isRaceFinished() const { return m_race_finished; }
+};   // BatchRace
+
+#endif
+
+/* EOF */
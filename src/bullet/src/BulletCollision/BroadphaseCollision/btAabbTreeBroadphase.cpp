@@ -0,0 +1,475 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btAabbTreeBroadphase.h"
+#include "BulletCollision/BroadphaseCollision/btDispatcher.h"
+#include "LinearMath/btMinMax.h"
+#include <new>
+#include <stdio.h>
+
+btAabbTreeBroadphase::btAabbTreeBroadphase(int maxProxies, btScalar margin, btOverlappingPairCache* overlappingPairCache)
+    :m_freeList(-1),
+    m_numProxies(0),
+    m_margin(margin),
+    m_pairCache(overlappingPairCache),
+    m_ownsPairCache(false)
+{
+    if (!overlappingPairCache)
+    {
+        void* mem = btAlignedAlloc(sizeof(btHashedOverlappingPairCache),16);
+        m_pairCache = new (mem)btHashedOverlappingPairCache();
+        m_ownsPairCache = true;
+    }
+    for (int i=0;i<NUM_TREES;i++)
+        m_root[i] = -1;
+
+    // allocate handles buffer and put all handles on free list
+    void* ptr = btAlignedAlloc(sizeof(btAabbTreeProxy)*maxProxies,16);
+    m_pHandles = new(ptr) btAabbTreeProxy[maxProxies];
+    m_maxHandles = maxProxies;
+    m_firstFreeHandle = 0;
+    for (int i=0;i<maxProxies;i++)
+    {
+        m_pHandles[i].m_nextFree = i+1;
+        m_pHandles[i].m_uniqueId = i+2;//avoid too trivial values (0,1) for debugging purposes
+    }
+    m_pHandles[maxProxies-1].m_nextFree = -1;
+}
+
+btAabbTreeBroadphase::~btAabbTreeBroadphase()
+{
+    btAlignedFree(m_pHandles);
+
+    if (m_ownsPairCache)
+    {
+        m_pairCache->~btOverlappingPairCache();
+        btAlignedFree(m_pairCache);
+    }
+}
+
+int btAabbTreeBroadphase::allocateNode()
+{
+    int node;
+    if (m_freeList!=-1)
+    {
+        node = m_freeList;
+        m_freeList = m_nodes[node].m_parent;
+    } else
+    {
+        node = m_nodes.size();
+        m_nodes.push_back(Node());
+    }
+    Node& n = m_nodes[node];
+    n.m_parent = -1;
+    n.m_child1 = -1;
+    n.m_child2 = -1;
+    n.m_height = 0;
+    n.m_proxy  = 0;
+    return node;
+}
+
+void btAabbTreeBroadphase::freeNode(int node)
+{
+    m_nodes[node].m_parent = m_freeList;
+    m_nodes[node].m_height = -1;
+    m_nodes[node].m_proxy  = 0;
+    m_freeList = node;
+}
+
+///enlarges the aabb by the margin, and by twice the displacement in the direction of movement
+void btAabbTreeBroadphase::setFatAabb(int leaf,const btVector3& aabbMin,const btVector3& aabbMax,const btVector3& displacement)
+{
+    btVector3 margin(m_margin,m_margin,m_margin);
+    Node& n = m_nodes[leaf];
+    n.m_aabbMin = aabbMin-margin;
+    n.m_aabbMax = aabbMax+margin;
+    for (int i=0;i<3;i++)
+    {
+        if (displacement[i]<0)
+            n.m_aabbMin[i] += btScalar(2.)*displacement[i];
+        else
+            n.m_aabbMax[i] += btScalar(2.)*displacement[i];
+    }
+}
+
+///recomputes the height and aabb of an internal node from its children
+void btAabbTreeBroadphase::updateNode(int node)
+{
+    Node& n = m_nodes[node];
+    const Node& c1 = m_nodes[n.m_child1];
+    const Node& c2 = m_nodes[n.m_child2];
+    n.m_height  = 1+btMax(c1.m_height,c2.m_height);
+    n.m_aabbMin = c1.m_aabbMin; n.m_aabbMin.setMin(c2.m_aabbMin);
+    n.m_aabbMax = c1.m_aabbMax; n.m_aabbMax.setMax(c2.m_aabbMax);
+}
+
+///inserts a leaf, the sibling is found by descending the tree using the surface area heuristic
+void btAabbTreeBroadphase::insertLeaf(int tree,int leaf)
+{
+    if (m_root[tree]==-1)
+    {
+        m_root[tree] = leaf;
+        m_nodes[leaf].m_parent = -1;
+        return;
+    }
+
+    const btVector3 leafMin = m_nodes[leaf].m_aabbMin;
+    const btVector3 leafMax = m_nodes[leaf].m_aabbMax;
+    int index = m_root[tree];
+    while (!m_nodes[index].isLeaf())
+    {
+        const Node& n = m_nodes[index];
+        btVector3 combinedMin = n.m_aabbMin; combinedMin.setMin(leafMin);
+        btVector3 combinedMax = n.m_aabbMax; combinedMax.setMax(leafMax);
+        btScalar area         = surfaceArea(n.m_aabbMin,n.m_aabbMax);
+        btScalar combinedArea = surfaceArea(combinedMin,combinedMax);
+
+        //cost of creating a new parent for this node and the leaf
+        btScalar cost = btScalar(2.)*combinedArea;
+        //minimum cost of pushing the leaf further down the tree
+        btScalar inheritanceCost = btScalar(2.)*(combinedArea-area);
+
+        btScalar childCost[2];
+        int children[2] = {n.m_child1,n.m_child2};
+        for (int c=0;c<2;c++)
+        {
+            const Node& child = m_nodes[children[c]];
+            btVector3 mn = child.m_aabbMin; mn.setMin(leafMin);
+            btVector3 mx = child.m_aabbMax; mx.setMax(leafMax);
+            if (child.isLeaf())
+            {
+                childCost[c] = surfaceArea(mn,mx)+inheritanceCost;
+            } else
+            {
+                childCost[c] = surfaceArea(mn,mx)-surfaceArea(child.m_aabbMin,child.m_aabbMax)
+                             + inheritanceCost;
+            }
+        }
+
+        if (cost<childCost[0] && cost<childCost[1])
+            break;
+
+        index = childCost[0]<childCost[1] ? children[0] : children[1];
+    }
+
+    int sibling   = index;
+    int oldParent = m_nodes[sibling].m_parent;
+    int newParent = allocateNode();
+    {
+        Node& p = m_nodes[newParent];
+        p.m_parent  = oldParent;
+        p.m_aabbMin = m_nodes[sibling].m_aabbMin; p.m_aabbMin.setMin(leafMin);
+        p.m_aabbMax = m_nodes[sibling].m_aabbMax; p.m_aabbMax.setMax(leafMax);
+        p.m_height  = m_nodes[sibling].m_height+1;
+        p.m_child1  = sibling;
+        p.m_child2  = leaf;
+    }
+
+    if (oldParent!=-1)
+    {
+        if (m_nodes[oldParent].m_child1==sibling)
+            m_nodes[oldParent].m_child1 = newParent;
+        else
+            m_nodes[oldParent].m_child2 = newParent;
+    } else
+    {
+        m_root[tree] = newParent;
+    }
+    m_nodes[sibling].m_parent = newParent;
+    m_nodes[leaf].m_parent    = newParent;
+
+    //walk back up the tree fixing heights and aabbs
+    index = m_nodes[leaf].m_parent;
+    while (index!=-1)
+    {
+        index = balance(tree,index);
+        updateNode(index);
+        index = m_nodes[index].m_parent;
+    }
+}
+
+void btAabbTreeBroadphase::removeLeaf(int tree,int leaf)
+{
+    if (leaf==m_root[tree])
+    {
+        m_root[tree] = -1;
+        return;
+    }
+
+    int parent      = m_nodes[leaf].m_parent;
+    int grandParent = m_nodes[parent].m_parent;
+    int sibling     = m_nodes[parent].m_child1==leaf ? m_nodes[parent].m_child2
+                                                      : m_nodes[parent].m_child1;
+
+    if (grandParent!=-1)
+    {
+        //connect the sibling to the grand parent and remove the parent
+        if (m_nodes[grandParent].m_child1==parent)
+            m_nodes[grandParent].m_child1 = sibling;
+        else
+            m_nodes[grandParent].m_child2 = sibling;
+        m_nodes[sibling].m_parent = grandParent;
+        freeNode(parent);
+
+        int index = grandParent;
+        while (index!=-1)
+        {
+            index = balance(tree,index);
+            updateNode(index);
+            index = m_nodes[index].m_parent;
+        }
+    } else
+    {
+        m_root[tree] = sibling;
+        m_nodes[sibling].m_parent = -1;
+        freeNode(parent);
+    }
+}
+
+///performs a left or right rotation if node a is imbalanced, returns the new root of the subtree
+int btAabbTreeBroadphase::balance(int tree,int iA)
+{
+    if (m_nodes[iA].isLeaf() || m_nodes[iA].m_height<2)
+        return iA;
+
+    int iB = m_nodes[iA].m_child1;
+    int iC = m_nodes[iA].m_child2;
+    int diff = m_nodes[iC].m_height-m_nodes[iB].m_height;
+
+    if (diff>1 || diff<-1)
+    {
+        //rotate the higher child (iUp) up, its higher child stays below it
+        //and its lower child replaces iUp as child of a
+        int  iUp     = diff>1 ? iC : iB;
+        int  iStay   = diff>1 ? iB : iC;
+        int  iF      = m_nodes[iUp].m_child1;
+        int  iG      = m_nodes[iUp].m_child2;
+
+        m_nodes[iUp].m_child1 = iA;
+        m_nodes[iUp].m_parent = m_nodes[iA].m_parent;
+        m_nodes[iA].m_parent  = iUp;
+
+        if (m_nodes[iUp].m_parent!=-1)
+        {
+            Node& p = m_nodes[m_nodes[iUp].m_parent];
+            if (p.m_child1==iA)
+                p.m_child1 = iUp;
+            else
+                p.m_child2 = iUp;
+        } else
+        {
+            m_root[tree] = iUp;
+        }
+
+        int iHigh = m_nodes[iF].m_height>m_nodes[iG].m_height ? iF : iG;
+        int iLow  = iHigh==iF ? iG : iF;
+        m_nodes[iUp].m_child2  = iHigh;
+        if (diff>1)
+            m_nodes[iA].m_child2 = iLow;
+        else
+            m_nodes[iA].m_child1 = iLow;
+        m_nodes[iLow].m_parent = iA;
+
+        Node& a = m_nodes[iA];
+        a.m_aabbMin = m_nodes[iStay].m_aabbMin; a.m_aabbMin.setMin(m_nodes[iLow].m_aabbMin);
+        a.m_aabbMax = m_nodes[iStay].m_aabbMax; a.m_aabbMax.setMax(m_nodes[iLow].m_aabbMax);
+        a.m_height  = 1+btMax(m_nodes[iStay].m_height,m_nodes[iLow].m_height);
+
+        Node& up = m_nodes[iUp];
+        up.m_aabbMin = a.m_aabbMin; up.m_aabbMin.setMin(m_nodes[iHigh].m_aabbMin);
+        up.m_aabbMax = a.m_aabbMax; up.m_aabbMax.setMax(m_nodes[iHigh].m_aabbMax);
+        up.m_height  = 1+btMax(a.m_height,m_nodes[iHigh].m_height);
+        return iUp;
+    }
+    return iA;
+}
+
+btBroadphaseProxy* btAabbTreeBroadphase::createProxy(const btVector3& aabbMin,const btVector3& aabbMax,int shapeType,void* userPtr,short int collisionFilterGroup,short int collisionFilterMask,btDispatcher* dispatcher,void* multiSapProxy)
+{
+    (void)shapeType;
+    (void)dispatcher;
+    if (m_firstFreeHandle==-1)
+    {
+        btAssert(0);
+        return 0; //should never happen, but don't let the game crash ;-)
+    }
+    btAssert(aabbMin[0]<= aabbMax[0] && aabbMin[1]<= aabbMax[1] && aabbMin[2]<= aabbMax[2]);
+
+    int handle = m_firstFreeHandle;
+    m_firstFreeHandle = m_pHandles[handle].m_nextFree;
+    btAabbTreeProxy* proxy = new (&m_pHandles[handle])btAabbTreeProxy(aabbMin,aabbMax,userPtr,collisionFilterGroup,collisionFilterMask,multiSapProxy);
+    proxy->m_uniqueId = handle+2;
+    proxy->m_tree     = (collisionFilterGroup & btBroadphaseProxy::StaticFilter) ? STATIC_TREE : DYNAMIC_TREE;
+
+    int leaf = allocateNode();
+    m_nodes[leaf].m_proxy = proxy;
+    setFatAabb(leaf,aabbMin,aabbMax,btVector3(0,0,0));
+    insertLeaf(proxy->m_tree,leaf);
+    proxy->m_leaf  = leaf;
+    proxy->m_moved = true;
+    m_moveBuffer.push_back(proxy);
+    m_numProxies++;
+    return proxy;
+}
+
+void btAabbTreeBroadphase::destroyProxy(btBroadphaseProxy* proxyOrg,btDispatcher* dispatcher)
+{
+    btAabbTreeProxy* proxy = static_cast<btAabbTreeProxy*>(proxyOrg);
+    removeLeaf(proxy->m_tree,proxy->m_leaf);
+    freeNode(proxy->m_leaf);
+    if (proxy->m_moved)
+        m_moveBuffer.remove(proxy);
+
+    m_pairCache->removeOverlappingPairsContainingProxy(proxyOrg,dispatcher);
+
+    int handle = int(proxy-m_pHandles);
+    proxy->m_nextFree = m_firstFreeHandle;
+    m_firstFreeHandle = handle;
+    m_numProxies--;
+}
+
+void btAabbTreeBroadphase::setAabb(btBroadphaseProxy* proxyOrg,const btVector3& aabbMin,const btVector3& aabbMax,btDispatcher* dispatcher)
+{
+    (void)dispatcher;
+    btAabbTreeProxy* proxy = static_cast<btAabbTreeProxy*>(proxyOrg);
+    btVector3 displacement = aabbMin-proxy->m_aabbMin;
+    proxy->m_aabbMin = aabbMin;
+    proxy->m_aabbMax = aabbMax;
+
+    //btCollisionWorld::updateAabbs calls this for every object each frame,
+    //nothing needs to be done as long as the object stays inside its fat aabb
+    const Node& leaf = m_nodes[proxy->m_leaf];
+    if (leaf.m_aabbMin[0]<=aabbMin[0] && leaf.m_aabbMin[1]<=aabbMin[1] && leaf.m_aabbMin[2]<=aabbMin[2] &&
+        aabbMax[0]<=leaf.m_aabbMax[0] && aabbMax[1]<=leaf.m_aabbMax[1] && aabbMax[2]<=leaf.m_aabbMax[2])
+        return;
+
+    removeLeaf(proxy->m_tree,proxy->m_leaf);
+    setFatAabb(proxy->m_leaf,aabbMin,aabbMax,displacement);
+    insertLeaf(proxy->m_tree,proxy->m_leaf);
+
+    if (!proxy->m_moved)
+    {
+        proxy->m_moved = true;
+        m_moveBuffer.push_back(proxy);
+    }
+}
+
+bool btAabbTreeBroadphase::testAabbOverlap(btBroadphaseProxy* proxy0,btBroadphaseProxy* proxy1) const
+{
+    const Node& n0 = m_nodes[static_cast<btAabbTreeProxy*>(proxy0)->m_leaf];
+    const Node& n1 = m_nodes[static_cast<btAabbTreeProxy*>(proxy1)->m_leaf];
+    return aabbOverlap(n0.m_aabbMin,n0.m_aabbMax,n1.m_aabbMin,n1.m_aabbMax);
+}
+
+///removes pairs whose fat aabbs don't overlap anymore
+class btAabbTreeRemoveCallback : public btOverlapCallback
+{
+    const btAabbTreeBroadphase* m_broadphase;
+public:
+    btAabbTreeRemoveCallback(const btAabbTreeBroadphase* broadphase) : m_broadphase(broadphase) {}
+    virtual bool processOverlap(btBroadphasePair& pair)
+    {
+        //only pairs with at least one moved proxy can have changed
+        if (!static_cast<btAabbTreeProxy*>(pair.m_pProxy0)->m_moved &&
+            !static_cast<btAabbTreeProxy*>(pair.m_pProxy1)->m_moved)
+            return false;
+        return !m_broadphase->testAabbOverlap(pair.m_pProxy0,pair.m_pProxy1);
+    }
+};
+
+///adds pairs of the proxy with all objects in a tree which overlap it
+void btAabbTreeBroadphase::queryTree(int tree,btAabbTreeProxy* proxy)
+{
+    const Node& leaf = m_nodes[proxy->m_leaf];
+    m_stack.resize(0);
+    if (m_root[tree]!=-1)
+        m_stack.push_back(m_root[tree]);
+    while (m_stack.size()>0)
+    {
+        int index = m_stack[m_stack.size()-1];
+        m_stack.pop_back();
+        const Node& n = m_nodes[index];
+        if (!aabbOverlap(n.m_aabbMin,n.m_aabbMax,leaf.m_aabbMin,leaf.m_aabbMax))
+            continue;
+        if (n.isLeaf())
+        {
+            btAabbTreeProxy* other = n.m_proxy;
+            if (other==proxy)
+                continue;
+            //if both proxies moved, the pair is only added by the one with the lower id
+            if (other->m_moved && other->m_uniqueId<proxy->m_uniqueId)
+                continue;
+            m_pairCache->addOverlappingPair(proxy,other);
+        } else
+        {
+            m_stack.push_back(n.m_child1);
+            m_stack.push_back(n.m_child2);
+        }
+    }
+}
+
+void btAabbTreeBroadphase::calculateOverlappingPairs(btDispatcher* dispatcher)
+{
+    if (m_moveBuffer.size()==0)
+        return;
+
+    //first add new overlapping pairs: only the moved proxies are queried,
+    //static objects only need to be tested against dynamic objects
+    for (int i=0;i<m_moveBuffer.size();i++)
+    {
+        btAabbTreeProxy* proxy = m_moveBuffer[i];
+        queryTree(DYNAMIC_TREE,proxy);
+        if (proxy->m_tree!=STATIC_TREE)
+            queryTree(STATIC_TREE,proxy);
+    }
+
+    //then remove non-overlapping ones
+    if (!m_pairCache->hasDeferredRemoval())
+    {
+        btAabbTreeRemoveCallback removeCallback(this);
+        m_pairCache->processAllOverlappingPairs(&removeCallback,dispatcher);
+    }
+
+    for (int i=0;i<m_moveBuffer.size();i++)
+        m_moveBuffer[i]->m_moved = false;
+    m_moveBuffer.resize(0);
+}
+
+void btAabbTreeBroadphase::getBroadphaseAabb(btVector3& aabbMin,btVector3& aabbMax) const
+{
+    if (m_root[DYNAMIC_TREE]==-1 && m_root[STATIC_TREE]==-1)
+    {
+        aabbMin.setValue(-1e30f,-1e30f,-1e30f);
+        aabbMax.setValue(1e30f,1e30f,1e30f);
+        return;
+    }
+    aabbMin.setValue(1e30f,1e30f,1e30f);
+    aabbMax.setValue(-1e30f,-1e30f,-1e30f);
+    for (int i=0;i<NUM_TREES;i++)
+    {
+        if (m_root[i]==-1)
+            continue;
+        aabbMin.setMin(m_nodes[m_root[i]].m_aabbMin);
+        aabbMax.setMax(m_nodes[m_root[i]].m_aabbMax);
+    }
+}
+
+void btAabbTreeBroadphase::printStats()
+{
+    printf("btAabbTreeBroadphase: proxies=%d/%d nodes=%d height=%d/%d pairs=%d\n",
+           m_numProxies,m_maxHandles,m_nodes.size(),
+           getTreeHeight(DYNAMIC_TREE),getTreeHeight(STATIC_TREE),
+           m_pairCache->getNumOverlappingPairs());
+}
@@ -0,0 +1,149 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef AABB_TREE_BROADPHASE_H
+#define AABB_TREE_BROADPHASE_H
+
+#include "btBroadphaseInterface.h"
+#include "btOverlappingPairCache.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+struct btAabbTreeProxy : public btBroadphaseProxy
+{
+    ///the actual aabb of the object (the tree stores an enlarged aabb)
+    btVector3   m_aabbMin;
+    btVector3   m_aabbMax;
+    ///index of the leaf node in the tree
+    int         m_leaf;
+    ///the tree containing the proxy, see btAabbTreeBroadphase::TreeType
+    int         m_tree;
+    ///true if the enlarged aabb changed and the proxy is in the move buffer
+    bool        m_moved;
+    ///next free handle, only used while the proxy is unused
+    int         m_nextFree;
+
+    btAabbTreeProxy() {};
+
+    btAabbTreeProxy(const btVector3& aabbMin,const btVector3& aabbMax,void* userPtr,short int collisionFilterGroup,short int collisionFilterMask,void* multiSapProxy)
+        :btBroadphaseProxy(userPtr,collisionFilterGroup,collisionFilterMask,multiSapProxy),
+        m_aabbMin(aabbMin),m_aabbMax(aabbMax),m_leaf(-1),m_tree(0),m_moved(false),m_nextFree(-1)
+    {
+    }
+};
+
+///btAabbTreeBroadphase is an incremental broadphase based on a dynamic aabb tree.
+///Each proxy is stored as a leaf with an enlarged ('fat') aabb, which is also extended in the direction of
+///the last movement. Only when an object leaves its fat aabb is it reinserted and queried against the tree,
+///so objects which don't move (or move slowly) cost nothing. Pairs are reported when the fat aabbs overlap,
+///i.e. a pair can be reported shortly before the objects actually touch (this is handled by the narrowphase).
+///Unlike btAxisSweep3 it doesn't need the world size in advance, and adding/removing proxies is O(log n).
+///Inserting uses the surface area heuristic, and the tree is kept balanced with rotations.
+///Static objects are kept in a separate tree: the track mesh covers the whole world, and would otherwise
+///make the surface area heuristic useless for all other objects.
+///The proxies are preallocated in one array (like btSimpleBroadphase), so that their addresses are in the
+///same order as their unique ids, which btHashedOverlappingPairCache depends on.
+class btAabbTreeBroadphase : public btBroadphaseInterface
+{
+public:
+    enum TreeType
+    {
+        DYNAMIC_TREE = 0,
+        STATIC_TREE,
+        NUM_TREES
+    };
+
+private:
+    struct Node
+    {
+        btVector3           m_aabbMin;
+        btVector3           m_aabbMax;
+        ///parent node, or next free node if the node is unused
+        int                 m_parent;
+        int                 m_child1;
+        int                 m_child2;
+        ///height of the subtree, 0 for leaves, -1 for free nodes
+        int                 m_height;
+        btAabbTreeProxy*    m_proxy;
+
+        bool    isLeaf() const { return m_child1 == -1; }
+    };
+
+    btAlignedObjectArray<Node>              m_nodes;
+    int                                     m_root[NUM_TREES];
+    int                                     m_freeList;
+    btAabbTreeProxy*                        m_pHandles;
+    int                                     m_maxHandles;
+    int                                     m_firstFreeHandle;
+    int                                     m_numProxies;
+    btScalar                                m_margin;
+    btAlignedObjectArray<btAabbTreeProxy*>  m_moveBuffer;
+    btAlignedObjectArray<int>               m_stack;
+
+    btOverlappingPairCache* m_pairCache;
+    bool                    m_ownsPairCache;
+
+    int     allocateNode();
+    void    freeNode(int node);
+    void    insertLeaf(int tree,int leaf);
+    void    removeLeaf(int tree,int leaf);
+    int     balance(int tree,int node);
+    void    updateNode(int node);
+    void    queryTree(int tree,btAabbTreeProxy* proxy);
+    void    setFatAabb(int leaf,const btVector3& aabbMin,const btVector3& aabbMax,const btVector3& displacement);
+
+    static btScalar surfaceArea(const btVector3& aabbMin,const btVector3& aabbMax)
+    {
+        btVector3 d = aabbMax-aabbMin;
+        return btScalar(2.)*(d.getX()*d.getY()+d.getY()*d.getZ()+d.getZ()*d.getX());
+    }
+    static bool aabbOverlap(const btVector3& min0,const btVector3& max0,const btVector3& min1,const btVector3& max1)
+    {
+        return min0.getX() <= max1.getX() && min1.getX() <= max0.getX() &&
+               min0.getY() <= max1.getY() && min1.getY() <= max0.getY() &&
+               min0.getZ() <= max1.getZ() && min1.getZ() <= max0.getZ();
+    }
+
+public:
+    ///margin: the tree aabbs are enlarged by this value, so objects moving less than this don't change the tree.
+    btAabbTreeBroadphase(int maxProxies=16384,btScalar margin=btScalar(0.2),btOverlappingPairCache* overlappingPairCache=0);
+    virtual ~btAabbTreeBroadphase();
+
+    virtual btBroadphaseProxy*  createProxy(const btVector3& aabbMin,const btVector3& aabbMax,int shapeType,void* userPtr,short int collisionFilterGroup,short int collisionFilterMask,btDispatcher* dispatcher,void* multiSapProxy);
+    virtual void    destroyProxy(btBroadphaseProxy* proxy,btDispatcher* dispatcher);
+    virtual void    setAabb(btBroadphaseProxy* proxy,const btVector3& aabbMin,const btVector3& aabbMax,btDispatcher* dispatcher);
+
+    virtual void    calculateOverlappingPairs(btDispatcher* dispatcher);
+
+    virtual btOverlappingPairCache* getOverlappingPairCache()
+    {
+        return m_pairCache;
+    }
+    virtual const btOverlappingPairCache*   getOverlappingPairCache() const
+    {
+        return m_pairCache;
+    }
+
+    virtual void    getBroadphaseAabb(btVector3& aabbMin,btVector3& aabbMax) const;
+
+    ///returns true if the (fat) aabbs of the two proxies overlap
+    bool    testAabbOverlap(btBroadphaseProxy* proxy0,btBroadphaseProxy* proxy1) const;
+
+    ///returns the height of a tree, useful to check the balancing
+    int     getTreeHeight(int tree=DYNAMIC_TREE) const { return m_root[tree]==-1 ? 0 : m_nodes[m_root[tree]].m_height; }
+
+    virtual void    printStats();
+};
+
+#endif //AABB_TREE_BROADPHASE_H
@@ -69,7 +69,7 @@ protected:
     
     void    updateActivationState(btScalar timeStep);
 
-    void    updateVehicles(btScalar timeStep);
+    virtual void    updateVehicles(btScalar timeStep);
 
     void    startProfiling(btScalar timeStep);
 
@@ -19,6 +19,16 @@
 
 static btClock gProfileClock;
 
+#if defined(_MSC_VER)
+#define BT_THREAD_LOCAL __declspec(thread)
+#else
+#define BT_THREAD_LOCAL __thread
+#endif
+
+/// The profile tree is not thread safe, so only the thread which called
+/// CProfileManager::Reset is profiled (e.g. solver worker threads are not).
+static BT_THREAD_LOCAL bool gIsProfilingThread = false;
+
 inline void Profile_Get_Ticks(unsigned long int * ticks)
 {
     *ticks = gProfileClock.getTimeMicroseconds();
@@ -213,6 +223,8 @@ unsigned long int            CProfileManager::ResetTime = 0;
  *=============================================================================================*/
 void    CProfileManager::Start_Profile( const char * name )
 {
+    if (!gIsProfilingThread)
+        return;
     if (name != CurrentNode->Get_Name()) {
         CurrentNode = CurrentNode->Get_Sub_Node( name );
     } 
@@ -226,6 +238,8 @@ void    CProfileManager::Start_Profile( const char * name )
  *=============================================================================================*/
 void    CProfileManager::Stop_Profile( void )
 {
+    if (!gIsProfilingThread)
+        return;
     // Return will indicate whether we should back up to our parent (we may
     // be profiling a recursive function)
     if (CurrentNode->Return()) {
@@ -241,6 +255,7 @@ void    CProfileManager::Stop_Profile( void )
  *=============================================================================================*/
 void    CProfileManager::Reset( void )
 { 
+    gIsProfilingThread = true;
     Root.Reset();
     Root.Call();
     FrameCounter = 0;
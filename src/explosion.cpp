@@ -32,8 +32,9 @@ Explosion::Explosion(const Vec3& coord, const int explosion_sound) : ssgTransfor
     addKid(cut);  // derefing the explosion will free the cutout
     m_seq   = projectile_manager->getExplosionModel();
     cut->addKid(m_seq);
+    m_sound_type    = explosion_sound;
     m_explode_sound = sfx_manager->newSFX((SFXManager::SFXType)explosion_sound);
-    init(coord);
+    init(coord, explosion_sound);
 }   // Explosion
 
 //-----------------------------------------------------------------------------
@@ -46,8 +47,18 @@ Explosion::~Explosion()
     // cut will be cleaned up when the explosion is rerefed by plib
 }
 //-----------------------------------------------------------------------------
-void Explosion::init(const Vec3& coord)
+/** Starts a new or recycled explosion.
+ *  \param coord Position of the explosion.
+ *  \param explosion_sound The sound (SFXManager::SFXType) to play.
+ */
+void Explosion::init(const Vec3& coord, const int explosion_sound)
 {
+    if(explosion_sound!=m_sound_type)
+    {
+        sfx_manager->deleteSFX(m_explode_sound);
+        m_sound_type    = explosion_sound;
+        m_explode_sound = sfx_manager->newSFX((SFXManager::SFXType)explosion_sound);
+    }
     m_explode_sound->position(coord);
     m_explode_sound->play();
 
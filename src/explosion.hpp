@@ -29,6 +29,8 @@ class Explosion : public ssgTransform
 {
 private:
     SFXBase*    m_explode_sound;
+    /** The SFXManager::SFXType of m_explode_sound. */
+    int         m_sound_type;
     bool        m_has_ended;
 
 public:
@@ -37,10 +39,11 @@ public:
 
          Explosion(const Vec3& coord, const int explosion_sound);
         ~Explosion();
-    void init     (const Vec3& coord);
+    void init     (const Vec3& coord, const int explosion_sound);
     void update   (float delta_t);
     int  inUse    () { return (m_step >= 0); }
     bool hasEnded () { return  m_has_ended;  }
+    int  getSoundType() const { return m_sound_type; }
 
 } ;
 
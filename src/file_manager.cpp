@@ -28,6 +28,7 @@
 #  include <io.h>
 #  include <stdio.h>
 #  ifndef __CYGWIN__
+#    include <direct.h>
 #    define S_ISDIR(mode)  (((mode) & S_IFMT) == S_IFDIR)
      //   Some portabilty defines
 #    define snprintf       _snprintf
@@ -293,6 +294,25 @@ std::string FileManager::getLogFile(const std::string& fname) const
     return getHomeDir()+"/"+fname;
 }   // getLogFile
 
+//-----------------------------------------------------------------------------
+/** Returns the name of a file in the user's config directory. Files there
+ *  can replace the default settings from the data directory (see
+ *  getConfigFile), e.g. the AI parameters written by the AI tuner.
+ */
+std::string FileManager::getUserConfigFile(const std::string& fname) const
+{
+    return getHomeDir()+"/"+fname;
+}   // getUserConfigFile
+
+//-----------------------------------------------------------------------------
+/** Returns the name of a file in the cache directory, which stores data
+ *  that can be recomputed (e.g. the collision meshes of tracks).
+ */
+std::string FileManager::getCacheFile(const std::string& fname) const
+{
+    return getHomeDir()+"/cache/"+fname;
+}   // getCacheFile
+
 //-----------------------------------------------------------------------------
 std::string FileManager::getMusicFile(const std::string& fname) const
 {
@@ -316,21 +336,32 @@ std::string FileManager::getHighscoreFile(const std::string& fname) const
 {
     return getHomeDir()+"/"+fname;
 }   // getHighscoreFile
+//-----------------------------------------------------------------------------
+/** Returns true if the specified file (or directory) exists.
+ *  \param path Full path of the file.
+ */
+bool FileManager::fileExists(const std::string& path) const
+{
+    struct stat mystat;
+    return stat(path.c_str(), &mystat) >= 0;
+}   // fileExists
+
 //-----------------------------------------------------------------------------
 void FileManager::initConfigDir()
 {
-#ifdef WIN32
-    /*nothing*/
+    // Create the config directory, and the cache directory in it. If the
+    // directories exist already, mkdir just fails.
+    std::string pathname = getHomeDir();
+    if(pathname.size()>1 && pathname[pathname.size()-1]=='/')
+        pathname.erase(pathname.size()-1);
+#if defined(WIN32) && !defined(__CYGWIN__)
+    _mkdir(pathname.c_str());
+    pathname += "/cache";
+    _mkdir(pathname.c_str());
 #else
-    /*if HOME environment variable exists
-    create directory $HOME/.supertuxkart*/
-    if(getenv("HOME")!=NULL)
-    {
-        std::string pathname;
-        pathname = getenv("HOME");
-        pathname += "/.supertuxkart";
-        mkdir(pathname.c_str(), 0755);
-    }
+    mkdir(pathname.c_str(), 0755);
+    pathname += "/cache";
+    mkdir(pathname.c_str(), 0755);
 #endif
 }   // initConfigDir
 
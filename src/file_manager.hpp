@@ -55,10 +55,13 @@ public:
     std::string getConfigFile    (const std::string& fname) const;
     std::string getHighscoreFile (const std::string& fname) const;
     std::string getLogFile       (const std::string& fname) const;
+    std::string getUserConfigFile(const std::string& fname) const;
+    std::string getCacheFile     (const std::string& fname) const;
     std::string getMusicFile     (const std::string& fname) const;
     std::string getSFXFile       (const std::string& fname) const;
     std::string getFontFile      (const std::string& fname) const;
     std::string getModelFile     (const std::string& fname) const;
+    bool        fileExists       (const std::string& path) const;
 
     void listFiles(std::set<std::string>& result, const std::string& dir,
                    bool is_full_path=false, bool make_full_path=false)
@@ -0,0 +1,328 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "gp_simulation.hpp"
+
+#include <stdlib.h>
+#include <algorithm>
+
+#include "grand_prix_manager.hpp"
+#include "race_manager.hpp"
+#include "graphics/scene.hpp"
+#include "karts/kart.hpp"
+#include "modes/world.hpp"
+#include "network/network_manager.hpp"
+#include "tracks/track.hpp"
+#include "utils/random_generator.hpp"
+#include "utils/worker_processes.hpp"
+
+GPSimulation* gp_simulation = 0;
+
+//-----------------------------------------------------------------------------
+GPSimulation::GPSimulation()
+{
+    m_num_gps       = 10;
+    m_num_jobs      = 1;
+    m_first_gp      = 0;
+    m_gps_done      = 0;
+    m_races_done    = 0;
+    m_result_file   = NULL;
+    m_base_seed     = 0;
+}   // GPSimulation
+
+//-----------------------------------------------------------------------------
+/** Enables the simulation of the specified grand prix.
+ *  \param ident Ident of the grand prix.
+ */
+void GPSimulation::setGrandPrix(const std::string &ident)
+{
+    if(!grand_prix_manager->getGrandPrix(ident))
+    {
+        fprintf(stderr, "Grand prix '%s' not found.\n", ident.c_str());
+        exit(-1);
+    }
+    m_gp_ident = ident;
+    activate();
+}   // setGrandPrix
+
+//-----------------------------------------------------------------------------
+/** Starts the worker processes (if more than one job is requested). This
+ *  must be called before the graphics are initialised, so that each worker
+ *  creates its own window and GL context. In the parent process this
+ *  function only returns after all workers are finished, and it then
+ *  prints the statistics and exits.
+ *  \return True in the process(es) that should do the actual simulation.
+ */
+bool GPSimulation::forkWorkers()
+{
+    m_base_seed = RandomGenerator::getMasterSeed();
+    if(!WorkerProcesses::isSupported())
+    {
+        if(m_num_jobs>1)
+            fprintf(stderr, "Worker processes are not supported, "
+                            "using only one process.\n");
+        m_num_jobs = 1;
+    }
+    if(m_num_jobs<=1) return true;
+
+    // Distribute the grand prix as evenly as possible to the workers.
+    const int num_workers = std::min(m_num_jobs, m_num_gps);
+    WorkerProcesses workers;
+    int worker = workers.start(num_workers, /*use_commands*/false);
+    if(worker>=0)
+    {
+        m_result_file = workers.getResultFile(0);
+        m_first_gp    = worker*(m_num_gps/num_workers) 
+                      + std::min(worker, m_num_gps%num_workers);
+        m_num_gps     = m_num_gps/num_workers 
+                      + (worker<m_num_gps%num_workers ? 1 : 0);
+        return true;
+    }
+
+    // Parent process: collect all results. Reading one pipe after the
+    // other is fine, a worker just blocks if its pipe is full.
+    for(int i=0; i<workers.getNumWorkers(); i++)
+        readResults(workers.getResultFile(i));
+    workers.finish();
+    printStatistics(stdout);
+    exit(0);
+    return true;
+}   // forkWorkers
+
+//-----------------------------------------------------------------------------
+/** Starts the first grand prix. Called from main once everything is loaded.
+ */
+void GPSimulation::start()
+{
+    race_manager->setMajorMode(RaceManager::MAJOR_MODE_GRAND_PRIX);
+    race_manager->setMinorMode(RaceManager::MINOR_MODE_QUICK_RACE);
+    race_manager->setGrandPrix(*grand_prix_manager->getGrandPrix(m_gp_ident));
+    network_manager->setupPlayerKartInfo();
+    m_gps_done = 0;
+    startGP();
+}   // start
+
+//-----------------------------------------------------------------------------
+/** Starts the next grand prix. Each GP uses its own random seed, so that
+ *  the results don't depend on how the GPs are distributed to workers.
+ */
+void GPSimulation::startGP()
+{
+    RandomGenerator::setMasterSeed(m_base_seed + m_first_gp + m_gps_done);
+    m_races_done = 0;
+    if(m_gps_done>0) scene->clear();
+    // The AI karts are selected using the seed of this GP.
+    race_manager->computeRandomKartList();
+    race_manager->startNew();
+}   // startGP
+
+//-----------------------------------------------------------------------------
+/** Called from the world when the race is finished. It stores the results,
+ *  and marks the race to be finished. The next race is then started from
+ *  the main loop. Karts that didn't finish before the time limit get the
+ *  time limit as finish time (and no points in the grand prix).
+ *  \param world The world of the finished race.
+ */
+void GPSimulation::raceFinished(const World *world)
+{
+    const std::string &track = world->getTrack()->getIdent();
+    for(unsigned int i=0; i<race_manager->getNumKarts(); i++)
+    {
+        const Kart *kart = world->getKart(i);
+        const float time = kart->hasFinishedRace() ? kart->getFinishTime()
+                                                   : getTimeLimit(world);
+        if(m_result_file)
+            fprintf(m_result_file, "race %s %s %d %f\n", track.c_str(),
+                    kart->getIdent().c_str(), kart->getPosition(), time);
+        else
+            addRaceResult(track, kart->getIdent(), kart->getPosition(), time);
+    }
+    m_race_finished = true;
+}   // raceFinished
+
+//-----------------------------------------------------------------------------
+/** Starts the next race of the current grand prix, or the next grand prix.
+ */
+void GPSimulation::startNextRace()
+{
+    m_race_finished = false;
+    m_races_done++;
+    if(m_races_done < (int)race_manager->getGrandPrix()->getTrackCount())
+        race_manager->next();
+    else
+        gpFinished();
+}   // startNextRace
+
+//-----------------------------------------------------------------------------
+/** Computes the final ranking of a grand prix (in the same way as
+ *  RaceManager::exit_race, but without showing the GP ending screen), and
+ *  either starts the next GP, or prints the statistics and exits.
+ */
+void GPSimulation::gpFinished()
+{
+    const int num_karts = race_manager->getNumKarts();
+    std::vector<int> order;
+    for(int i=0; i<num_karts; i++)
+        order.push_back(i);
+    // Simple sort by points, then time (the number of karts is small)
+    for(int i=0; i<num_karts; i++)
+    {
+        for(int j=i+1; j<num_karts; j++)
+        {
+            int a=order[i], b=order[j];
+            if(race_manager->getKartScore(b) > race_manager->getKartScore(a) ||
+               (race_manager->getKartScore(b)==race_manager->getKartScore(a) &&
+                race_manager->getOverallTime(b) < race_manager->getOverallTime(a)))
+                std::swap(order[i], order[j]);
+        }
+    }
+    for(int rank=0; rank<num_karts; rank++)
+    {
+        const std::string &kart = race_manager->getKartName(order[rank]);
+        if(m_result_file)
+            fprintf(m_result_file, "gp %s %d\n", kart.c_str(), rank+1);
+        else
+            addGPResult(kart, rank+1);
+    }
+
+    m_gps_done++;
+    printf("Grand prix %d of %d finished.\n", m_gps_done, m_num_gps);
+    if(m_gps_done < m_num_gps)
+    {
+        startGP();
+        return;
+    }
+    if(m_result_file)
+        fclose(m_result_file);
+    else
+        printStatistics(stdout);
+    exit(0);
+}   // gpFinished
+
+//-----------------------------------------------------------------------------
+/** Reads the results written by a worker process.
+ *  \param f The file to read from.
+ */
+void GPSimulation::readResults(FILE *f)
+{
+    char s[1024], track[256], kart[256];
+    int   n;
+    float time;
+    while(fgets(s, 1023, f))
+    {
+        if(sscanf(s, "race %255s %255s %d %f", track, kart, &n, &time)==4)
+            addRaceResult(track, kart, n, time);
+        else if(sscanf(s, "gp %255s %d", kart, &n)==2)
+            addGPResult(kart, n);
+        else
+            fprintf(stderr, "Invalid simulation result '%s' ignored.\n", s);
+    }
+}   // readResults
+
+//-----------------------------------------------------------------------------
+/** Adds the result of one kart in a race to the overall and to the track
+ *  statistics.
+ */
+void GPSimulation::addRaceResult(const std::string &track,
+                                 const std::string &kart,
+                                 int position, float time)
+{
+    KartStatistics *all[2];
+    all[0] = &m_kart_statistics[kart];
+    all[1] = &m_track_statistics[track][kart];
+    for(unsigned int i=0; i<2; i++)
+    {
+        KartStatistics *s = all[i];
+        s->m_races++;
+        if(position==1) s->m_race_wins++;
+        s->m_total_time += time;
+        if((int)s->m_positions.size()<position)
+            s->m_positions.resize(position, 0);
+        s->m_positions[position-1]++;
+    }
+}   // addRaceResult
+
+//-----------------------------------------------------------------------------
+/** Adds the final grand prix rank of a kart to the statistics.
+ */
+void GPSimulation::addGPResult(const std::string &kart, int rank)
+{
+    KartStatistics &s = m_kart_statistics[kart];
+    s.m_gps++;
+    if(rank==1) s.m_gp_wins++;
+    if((int)s.m_gp_ranks.size()<rank)
+        s.m_gp_ranks.resize(rank, 0);
+    s.m_gp_ranks[rank-1]++;
+}   // addGPResult
+
+//-----------------------------------------------------------------------------
+/** Prints one table of kart statistics.
+ *  \param out File to print to.
+ *  \param s The statistics to print.
+ *  \param print_gp True if the grand prix results should be printed.
+ */
+void GPSimulation::printKartStatistics(FILE *out, const AllKartStatistics &s,
+                                       bool print_gp) const
+{
+    fprintf(out, "  %-16s %6s %7s %10s  %s\n", "kart", "races", "win %",
+            "mean time", "position distribution [%]");
+    for(AllKartStatistics::const_iterator i=s.begin(); i!=s.end(); i++)
+    {
+        const KartStatistics &k = i->second;
+        if(k.m_races==0) continue;
+        fprintf(out, "  %-16s %6d %7.2f %10.3f ", i->first.c_str(),
+                k.m_races, 100.0f*k.m_race_wins/k.m_races,
+                k.m_total_time/k.m_races);
+        for(unsigned int j=0; j<k.m_positions.size(); j++)
+            fprintf(out, " %5.1f", 100.0f*k.m_positions[j]/k.m_races);
+        fprintf(out, "\n");
+    }
+    if(!print_gp) return;
+
+    fprintf(out, "\n  %-16s %6s %7s  %s\n", "kart", "gps", "win %",
+            "rank distribution [%]");
+    for(AllKartStatistics::const_iterator i=s.begin(); i!=s.end(); i++)
+    {
+        const KartStatistics &k = i->second;
+        if(k.m_gps==0) continue;
+        fprintf(out, "  %-16s %6d %7.2f ", i->first.c_str(), k.m_gps,
+                100.0f*k.m_gp_wins/k.m_gps);
+        for(unsigned int j=0; j<k.m_gp_ranks.size(); j++)
+            fprintf(out, " %5.1f", 100.0f*k.m_gp_ranks[j]/k.m_gps);
+        fprintf(out, "\n");
+    }
+}   // printKartStatistics
+
+//-----------------------------------------------------------------------------
+/** Prints the statistics for all karts, and for each track.
+ *  \param out File to print to.
+ */
+void GPSimulation::printStatistics(FILE *out) const
+{
+    fprintf(out, "\nGrand prix '%s': %d grand prix simulated.\n\n",
+            m_gp_ident.c_str(), m_num_gps);
+    fprintf(out, "All tracks:\n");
+    printKartStatistics(out, m_kart_statistics, /*print_gp*/true);
+    for(std::map<std::string, AllKartStatistics>::const_iterator
+        i=m_track_statistics.begin(); i!=m_track_statistics.end(); i++)
+    {
+        fprintf(out, "\nTrack '%s':\n", i->first.c_str());
+        printKartStatistics(out, i->second, /*print_gp*/false);
+    }
+}   // printStatistics
+
+/* EOF */
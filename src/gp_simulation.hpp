@@ -0,0 +1,112 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_GP_SIMULATION_HPP
+#define HEADER_GP_SIMULATION_HPP
+
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "batch_race.hpp"
+
+class World;
+
+/** Simulates a number of grand prix without graphics and with all karts
+ *  driven by the AI, and prints statistics about the results (win rate,
+ *  mean finish time and position distribution for each kart, both overall
+ *  and for each track). This is used to balance the kart properties.
+ *  The simulations can be distributed over several worker processes
+ *  (--gp-sim-jobs). Each worker initialises STK once and then runs all its
+ *  grand prix one after another, so kart models etc. are only loaded once
+ *  per worker. The workers send the result of each race through a pipe to
+ *  the parent process, which combines and prints the statistics.
+ *  The workers are separate processes (and not threads) since the race
+ *  code depends on many global objects.
+ */
+class GPSimulation : public BatchRace
+{
+private:
+    /** Statistics for one kart (either overall, or for one track). */
+    struct KartStatistics
+    {
+        int               m_races;
+        int               m_race_wins;
+        double            m_total_time;
+        /** m_positions[i] is how often the kart finished on position i+1.*/
+        std::vector<int>  m_positions;
+        int               m_gps;
+        int               m_gp_wins;
+        /** m_gp_ranks[i] is how often the kart had GP rank i+1. */
+        std::vector<int>  m_gp_ranks;
+        KartStatistics() : m_races(0), m_race_wins(0), m_total_time(0.0),
+                           m_gps(0), m_gp_wins(0) {}
+    };   // KartStatistics
+    typedef std::map<std::string, KartStatistics> AllKartStatistics;
+
+    /** Ident of the grand prix to simulate. */
+    std::string        m_gp_ident;
+    /** Number of grand prix to simulate (by this process). */
+    int                m_num_gps;
+    /** Number of worker processes to use. */
+    int                m_num_jobs;
+    /** Index of the first grand prix of this process, used to compute
+     *  the random seed for each GP. */
+    int                m_first_gp;
+    /** Number of grand prix finished by this process. */
+    int                m_gps_done;
+    /** Number of races finished in the current grand prix. */
+    int                m_races_done;
+    /** If this is a worker process, the results are written to this file
+     *  (a pipe to the parent process), otherwise this is NULL. */
+    FILE              *m_result_file;
+    /** The master seed at startup, each GP uses this plus the GP index. */
+    unsigned int       m_base_seed;
+
+    AllKartStatistics  m_kart_statistics;
+    std::map<std::string, AllKartStatistics> m_track_statistics;
+
+    void addRaceResult(const std::string &track, const std::string &kart,
+                       int position, float time);
+    void addGPResult  (const std::string &kart, int rank);
+    void readResults  (FILE *f);
+    void startGP      ();
+    void gpFinished   ();
+    void printStatistics(FILE *out) const;
+    void printKartStatistics(FILE *out, const AllKartStatistics &s,
+                             bool print_gp) const;
+public:
+         GPSimulation();
+    void setGrandPrix(const std::string &ident);
+    virtual bool forkWorkers  ();
+    virtual void start        ();
+    virtual void raceFinished (const World *world);
+    virtual void startNextRace();
+    // ------------------------------------------------------------------------
+    /** Sets the number of grand prix to simulate. */
+    void setNumGPs(int n)              { m_num_gps  = n;         }
+    // ------------------------------------------------------------------------
+    /** Sets the number of worker processes. */
+    void setNumJobs(int n)             { m_num_jobs = n;         }
+};   // GPSimulation
+
+extern GPSimulation *gp_simulation;
+
+#endif
+
+/* EOF */
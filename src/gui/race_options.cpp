@@ -28,6 +28,9 @@
 #  define snprintf _snprintf
 #endif
 
+// All arenas have at least this number of start positions.
+static const int MAX_BATTLE_KARTS = 4;
+
 enum WidgetTokens
 {
     WTOK_TITLE,
@@ -65,7 +68,11 @@ RaceOptions::RaceOptions()
         // least one opponent in addition to the leader
         m_min_karts += (race_manager->getNumPlayers()==1 ? 2 : 1);
     }
+    m_max_karts = stk_config->m_max_karts;
+    if(RaceManager::isBattleMode( race_manager->getMinorMode() ))
+        m_max_karts = std::max(m_min_karts, MAX_BATTLE_KARTS);
     m_num_karts=std::max(user_config->getDefaultNumKarts(), m_min_karts);
+    m_num_karts=std::min(m_num_karts, m_max_karts);
 
 
     const int DESC_WIDTH=48;
@@ -79,7 +86,10 @@ RaceOptions::RaceOptions()
     // if there is no AI, no point asking for its difficulty...
     // There's also no point asking the player for the amount of karts
     // since tt will always be the same as the number of human players
-    if(!RaceManager::isBattleMode( race_manager->getMinorMode() ))
+    // (a battle with as many players as start positions has no AI)
+    const bool has_ai = !RaceManager::isBattleMode( race_manager->getMinorMode() ) ||
+                        m_max_karts > m_min_karts;
+    if(has_ai)
     {
         widget_manager->addTextWgt( WTOK_DIFFICULTY_TITLE, DESC_WIDTH, 7, _("Difficulty") );
         widget_manager->hideWgtRect(WTOK_DIFFICULTY_TITLE);
@@ -156,9 +166,9 @@ RaceOptions::RaceOptions()
     // Select 'start' by default.
     widget_manager->setSelectedWgt( WTOK_START );
     
-    // hack. in battle mode this screen is totally useless. so I'm calling 'select'
+    // hack. in battle mode without AI this screen is totally useless. so I'm calling 'select'
     // to select the start button, so the screen is entirely skipped (FIXME - find cleaner way)
-    if(RaceManager::isBattleMode( race_manager->getMinorMode() )) select();
+    if(!has_ai) select();
         
 }   // RaceOptions
 
@@ -214,7 +224,7 @@ void RaceOptions::select()
 
         case WTOK_KARTS_UP:
             {
-            m_num_karts = m_num_karts==stk_config->m_max_karts 
+            m_num_karts = m_num_karts==m_max_karts 
                             ? m_min_karts : m_num_karts + 1;
 
                 char label[ MAX_MESSAGE_LENGTH ];
@@ -227,7 +237,7 @@ void RaceOptions::select()
         case WTOK_KARTS_DOWN:
             {
                 m_num_karts = m_num_karts==m_min_karts 
-                            ? stk_config->m_max_karts : m_num_karts-1;
+                            ? m_max_karts : m_num_karts-1;
                 char label[ MAX_MESSAGE_LENGTH ];
                 snprintf( label, MAX_MESSAGE_LENGTH, "%d", m_num_karts );
 
@@ -301,11 +311,10 @@ void RaceOptions::setAllValues()
         user_config->setDefaultNumDifficulty(RaceManager::RD_EASY);
     }
 
-    // if there is no AI, there's no point asking the player for the amount of karts.
-    // It will always be the same as the number of human players
+    // The number of karts in battle mode is limited by the arenas.
     if(RaceManager::isBattleMode( race_manager->getMinorMode() ))
     {
-        race_manager->setNumKarts(race_manager->getNumLocalPlayers());
+        race_manager->setNumKarts(m_num_karts);
         // Don't change the default number of karts in user_config
     }
     else
@@ -26,6 +26,7 @@ private:
     int m_difficulty;
     int m_num_karts;
     int m_min_karts;         // minimum number of karts, depending on mode etc.
+    int m_max_karts;         // maximum number of karts, depending on mode
     int m_num_laps;
     const char *getDifficultyString(int) const;
     void setAllValues();
@@ -25,6 +25,8 @@
 #include "karts/kart.hpp"
 #include "modes/world.hpp"
 #include "tracks/track.hpp"
+#include "utils/profiler.hpp"
+#include "utils/random_generator.hpp"
 
 History* history = 0;
 
@@ -34,6 +36,7 @@ History* history = 0;
 History::History()
 {
     m_replay_mode = HISTORY_NONE;
+    m_benchmark   = false;
 }   // History
 
 //-----------------------------------------------------------------------------
@@ -124,6 +127,11 @@ void History::updateReplay(float dt)
     if(m_current>=(int)m_all_deltas.size())
     {
         printf("Replay finished.\n");
+        if(m_benchmark)
+        {
+            printBenchmarkResult();
+            exit(0);
+        }
         exit(2);
     }
     unsigned int num_karts = race_manager->getNumKarts();
@@ -143,6 +151,54 @@ void History::updateReplay(float dt)
     }
 }   // updateReplay
 
+//-----------------------------------------------------------------------------
+/** Computes a checksum (FNV-1a) of the position, rotation and velocity of
+ *  all karts. This is used to verify that a replay results in exactly the
+ *  same final state, e.g. after optimising the physics or the AI.
+ */
+unsigned int History::computeStateChecksum() const
+{
+    unsigned int hash = 2166136261u;
+    unsigned int num_karts = race_manager->getNumKarts();
+    for(unsigned int k=0; k<num_karts; k++)
+    {
+        const Kart *kart = RaceManager::getKart(k);
+        const btQuaternion q = kart->getRotation();
+        float values[10];
+        values[0] = kart->getXYZ().getX();
+        values[1] = kart->getXYZ().getY();
+        values[2] = kart->getXYZ().getZ();
+        values[3] = q.getX();
+        values[4] = q.getY();
+        values[5] = q.getZ();
+        values[6] = q.getW();
+        values[7] = kart->getVelocity().getX();
+        values[8] = kart->getVelocity().getY();
+        values[9] = kart->getVelocity().getZ();
+        const unsigned char *p = (const unsigned char*)values;
+        for(unsigned int i=0; i<sizeof(values); i++)
+        {
+            hash ^= p[i];
+            hash *= 16777619u;
+        }
+    }   // for k<num_karts
+    return hash;
+}   // computeStateChecksum
+
+//-----------------------------------------------------------------------------
+/** Prints the results of a replay benchmark: the number of frames, the
+ *  time spent in the various subsystems, and the checksum of the final
+ *  state of all karts.
+ */
+void History::printBenchmarkResult() const
+{
+    printf("Replay benchmark: %d frames, %d karts, track '%s'.\n",
+           m_size, race_manager->getNumKarts(),
+           RaceManager::getTrack()->getIdent().c_str());
+    profiler->printSummary(stdout);
+    printf("State checksum: %08x\n", computeStateChecksum());
+}   // printBenchmarkResult
+
 //-----------------------------------------------------------------------------
 /** Saves the history stored in the internal data structures into a file called
  *  history.dat.
@@ -157,6 +213,7 @@ void History::Save()
     fprintf(fd, "numkarts: %d\n",   nKarts);
     fprintf(fd, "numplayers: %d\n", race_manager->getNumPlayers());
     fprintf(fd, "difficulty: %d\n", race_manager->getDifficulty());
+    fprintf(fd, "seed: %u\n",       RandomGenerator::getMasterSeed());
     fprintf(fd, "track: %s\n",      RaceManager::getTrack()->getIdent().c_str());
 
     int k;
@@ -166,29 +223,34 @@ void History::Save()
     }
     fprintf(fd, "size:     %d\n", m_size);
 
-    int j = m_wrapped ? m_current : 0;
+    // If the buffer has wrapped around, the oldest entry is the one
+    // after the current one.
+    int start = m_wrapped ? (m_current+1)%m_size : 0;
+    int j     = start;
     for(int i=0; i<m_size; i++)
     {
-        fprintf(fd, "delta: %f\n",m_all_deltas[i]);
+        fprintf(fd, "delta: %f\n",m_all_deltas[j]);
         j=(j+1)%m_size;
     }
 
     for(int k=0; k<nKarts; k++)
     {
-        //Kart* kart= RaceManager::getKart(k);
-        j = m_wrapped ? m_current : 0;
+        j = start;
         for(int i=0; i<m_size; i++)
         {
+            int index = j*nKarts+k;
             // FIXME: kart number is not really necessary
             fprintf(fd, "%d %f %f %d  %f %f %f  %f %f %f %f\n",
                     k,
-                    m_all_controls[j].m_steer,
-                    m_all_controls[j].m_accel,
-                    m_all_controls[j].getButtonsCompressed(),
-                    m_all_xyz[j].getX(), m_all_xyz[j].getY(),
-                    m_all_xyz[j].getZ(),
-                    m_all_rotations[j].getX(), m_all_rotations[j].getY(),
-                    m_all_rotations[j].getZ(), m_all_rotations[j].getW()  );
+                    m_all_controls[index].m_steer,
+                    m_all_controls[index].m_accel,
+                    m_all_controls[index].getButtonsCompressed(),
+                    m_all_xyz[index].getX(), m_all_xyz[index].getY(),
+                    m_all_xyz[index].getZ(),
+                    m_all_rotations[index].getX(),
+                    m_all_rotations[index].getY(),
+                    m_all_rotations[index].getZ(),
+                    m_all_rotations[index].getW()  );
             j=(j+1)%m_size;
         }   // for i
     }   // for k
@@ -243,7 +305,18 @@ void History::Load()
     }
     race_manager->setDifficulty((RaceManager::Difficulty)n);
 
+    // The random seed is optional, since old history files don't have it.
     fgets(s, 1023, fd);
+    unsigned int seed;
+    if(sscanf(s, "seed: %u",&seed)==1)
+    {
+        RandomGenerator::setMasterSeed(seed);
+        fgets(s, 1023, fd);
+    }
+    else
+    {
+        fprintf(stderr,"WARNING: No random seed found in history file.\n");
+    }
     if(sscanf(s, "track: %s",s1)!=1)
     {
         fprintf(stderr,"WARNING: Track not found in history file.\n");
@@ -291,15 +364,16 @@ void History::Load()
             fgets(s, 1023, fd);
             int buttonsCompressed;
             float x,y,z,rx,ry,rz,rw;
+            unsigned int index = i*num_karts+k;
             sscanf(s, "%d %f %f %d  %f %f %f  %f %f %f %f\n",
                     &j, 
-                    &m_all_controls[i].m_steer,
-                    &m_all_controls[i].m_accel,
+                    &m_all_controls[index].m_steer,
+                    &m_all_controls[index].m_accel,
                     &buttonsCompressed,
                     &x, &y, &z, &rx, &ry, &rz, &rw);
-            m_all_xyz[i]       = Vec3(x,y,z);
-            m_all_rotations[i] = btQuaternion(rx,ry,rz,rw);
-            m_all_controls[i].setButtonsCompressed(char(buttonsCompressed));
+            m_all_xyz[index]       = Vec3(x,y,z);
+            m_all_rotations[index] = btQuaternion(rx,ry,rz,rw);
+            m_all_controls[index].setButtonsCompressed(char(buttonsCompressed));
         }   // for i
     }   // for k
     fprintf(fd, "History file end.\n");
@@ -44,6 +44,9 @@ public:
 private:
     // maximum number of history events to store
     HistoryReplayMode         m_replay_mode;
+    /** True if the replay is used as a benchmark, i.e. timing information
+     *  and a checksum of the final state are printed at the end. */
+    bool                      m_benchmark;
     int                       m_current;
     bool                      m_wrapped;
     int                       m_size;
@@ -54,6 +57,8 @@ private:
     void  allocateMemory(int number_of_frames);
     void  updateSaving(float dt);
     void  updateReplay(float dt);
+    unsigned int computeStateChecksum() const;
+    void  printBenchmarkResult() const;
 public:
           History        ();
     void  startReplay    ();
@@ -70,6 +75,13 @@ public:
     /** Enable replaying a history, enabled from the command line. */
     void  doReplayHistory(HistoryReplayMode m) {m_replay_mode = m;           }
     // ------------------------------------------------------------------------
+    /** Enables benchmark mode, i.e. timings and a checksum of the final
+     *  kart states are printed once the replay is finished. */
+    void  setBenchmark   (bool b)       { m_benchmark = b;                   }
+    // ------------------------------------------------------------------------
+    /** Returns true if the replay is run as a benchmark. */
+    bool  isBenchmark    () const       { return m_benchmark;                }
+    // ------------------------------------------------------------------------
     /** Returns true if the physics should not be simulated in replay mode. 
      *  I.e. either no replay mode, or physics replay mode. */
     bool dontDoPhysics   () const { return m_replay_mode == HISTORY_POSITION;}
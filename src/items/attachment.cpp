@@ -122,7 +122,7 @@ void Attachment::hitBanana(const Item *item, int new_attachment)
     // so that the clients can be updated.
     if(network_manager->getMode()==NetworkManager::NW_SERVER)
     {
-        race_state->itemCollected(m_kart->getWorldKartId(),
+        RaceState::get()->itemCollected(m_kart->getWorldKartId(),
                                   item->getItemId(),
                                   new_attachment);
     }
@@ -26,8 +26,19 @@ float Bowling::m_st_max_distance_squared;
 float Bowling::m_st_force_to_target;
 
 // -----------------------------------------------------------------------------
-Bowling::Bowling(Kart *kart) : Flyable(kart, POWERUP_BOWLING, 50.0f /* mass */)
+Bowling::Bowling(Kart *kart) : Flyable(POWERUP_BOWLING, 50.0f /* mass */)
 {
+    m_shape = new btSphereShape(0.5f*m_extend.getY());
+    launch(kart);
+}   // Bowling
+
+// -----------------------------------------------------------------------------
+/** Shoots a new or recycled bowling ball.
+ *  \param kart The kart which shoots the bowling ball.
+ */
+void Bowling::launch(Kart *kart)
+{
+    Flyable::launch(kart);
     float y_offset = 0.5f*kart->getKartLength() + m_extend.getY()/2.0f;
     
     // if the kart is looking backwards, release from the back
@@ -48,7 +59,6 @@ Bowling::Bowling(Kart *kart) : Flyable(kart, POWERUP_BOWLING, 50.0f /* mass */)
     }
 
     createPhysics(y_offset, btVector3(0.0f, m_speed*2.0f, 0.0f),
-                  new btSphereShape(0.5f*m_extend.getY()), 
                   -70.0f /*gravity*/, true /*rotates*/);
 
     // Even if the ball is fired backwards, m_speed must be positive,
@@ -67,7 +77,7 @@ Bowling::Bowling(Kart *kart) : Flyable(kart, POWERUP_BOWLING, 50.0f /* mass */)
     // should not live forever, auto-destruct after 20 seconds
     m_max_lifespan = 20.0f;
     
-}   // Bowling
+}   // launch
 
 // -----------------------------------------------------------------------------
 void Bowling::init(const lisp::Lisp* lisp, ssgEntity *bowling)
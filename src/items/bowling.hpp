@@ -31,6 +31,7 @@ private:
     
 public:
     Bowling(Kart* kart);
+    virtual void launch(Kart *kart);
     static  void init(const lisp::Lisp* lisp, ssgEntity* bowling);
     virtual bool updateAndDel(float dt);
     virtual bool hit(Kart* kart, MovingPhysics* mp=NULL);
@@ -28,8 +28,19 @@ float Cake::m_st_max_distance;
 float Cake::m_st_max_distance_squared;
 float Cake::m_gravity;
 
-Cake::Cake (Kart *kart) : Flyable(kart, POWERUP_CAKE)
+Cake::Cake (Kart *kart) : Flyable(POWERUP_CAKE)
 {
+    m_shape = new btCylinderShape(0.5f*m_extend);
+    launch(kart);
+}   // Cake
+
+// -----------------------------------------------------------------------------
+/** Shoots a new or recycled cake.
+ *  \param kart The kart which shoots the cake.
+ */
+void Cake::launch(Kart *kart)
+{
+    Flyable::launch(kart);
     m_target = NULL;
     
     // A bit of a hack: the mass of this kinematic object is still 1.0 
@@ -78,8 +89,7 @@ Cake::Cake (Kart *kart) : Flyable(kart, POWERUP_CAKE)
         
         m_initial_velocity = btVector3(0.0f, m_speed, z_velocity);
     
-            createPhysics(y_offset, m_initial_velocity, 
-                  new btCylinderShape(0.5f*m_extend), -m_gravity,
+            createPhysics(y_offset, m_initial_velocity, -m_gravity,
                   true /* rotation */, false /* backwards */, &trans);
     }
     else
@@ -91,8 +101,7 @@ Cake::Cake (Kart *kart) : Flyable(kart, POWERUP_CAKE)
 
         m_initial_velocity = btVector3(0.0f, m_speed, z_velocity);
     
-            createPhysics(y_offset, m_initial_velocity, 
-                  new btCylinderShape(0.5f*m_extend), -m_gravity,
+            createPhysics(y_offset, m_initial_velocity, -m_gravity,
                   true /* rotation */, backwards, &trans);
     }
 
@@ -103,7 +112,7 @@ Cake::Cake (Kart *kart) : Flyable(kart, POWERUP_CAKE)
     
     m_body->applyTorque(btVector3(5,-3,7));
     
-}   // Cake
+}   // launch
 
 // -----------------------------------------------------------------------------
 void Cake::init(const lisp::Lisp* lisp, ssgEntity *cake_model)
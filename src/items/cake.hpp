@@ -34,6 +34,7 @@ private:
                                       // projectile (NULL if none)
 public:
     Cake (Kart *kart);
+    virtual void launch   (Kart *kart);
     static  void init     (const lisp::Lisp* lisp, ssgEntity* cake_model);
     virtual bool hit      (Kart *kart, MovingPhysics *mp=NULL);
     virtual void hitTrack ()                      {hit(NULL);                }
@@ -45,20 +45,31 @@ float      Flyable::m_st_force_updown[POWERUP_MAX];
 btVector3  Flyable::m_st_extend[POWERUP_MAX];
 // ----------------------------------------------------------------------------
 
-Flyable::Flyable(Kart *kart, PowerupType type, float mass) : Moveable()
+Flyable::Flyable(PowerupType type, float mass) : Moveable()
 {
     // get the appropriate data from the static fields
-    m_speed             = m_st_speed[type];
+    m_type              = type;
     m_extend            = m_st_extend[type];
     m_max_height        = m_st_max_height[type];
     m_min_height        = m_st_min_height[type];
     m_average_height    = (m_min_height+m_max_height)/2;
     m_force_updown      = m_st_force_updown[type];
+    m_owner             = NULL;
+    m_shape             = NULL;
+    m_mass              = mass;
+}   // Flyable
+
+// ----------------------------------------------------------------------------
+/** Prepares a new or recycled flyable to be shot by a kart. Derived classes
+ *  call this first, and then create the physics with createPhysics().
+ *  \param kart The kart which shoots this flyable.
+ */
+void Flyable::launch(Kart *kart)
+{
+    m_speed             = m_st_speed[m_type];
     m_owner             = kart;
     m_has_hit_something = false;
     m_exploded          = false;
-    m_shape             = NULL;
-    m_mass              = mass;
     m_adjust_z_velocity = true;
     do_terrain_info     = true;
     m_time_since_thrown = 0;
@@ -67,16 +78,27 @@ Flyable::Flyable(Kart *kart, PowerupType type, float mass) : Moveable()
     
     // Add the graphical model
     ssgTransform *m     = getModelTransform();
-    m->addKid(m_st_model[type]);
+    m->addKid(m_st_model[m_type]);
     scene->add(m);
-}   // Flyable
+}   // launch
+
+// ----------------------------------------------------------------------------
+/** Removes this flyable from the scene and the physics, so that the
+ *  projectile manager can launch it again later.
+ */
+void Flyable::recycle()
+{
+    ssgTransform *m = getModelTransform();
+    m->removeAllKids();
+    scene->remove(m);
+    RaceManager::getWorld()->getPhysics()->removeBody(getBody());
+}   // recycle
 // ----------------------------------------------------------------------------
 /** Creates a bullet physics body for the flyable item.
  *  \param y_offset How far ahead of the kart the flyable should be 
  *         positioned. Necessary to avoid exploding a rocket inside of the
  *         firing kart.
  *  \param velocity Initial velocity of the flyable.
- *  \param shape Collision shape of the flyable.
  *  \param gravity Gravity to use for this flyable.
  *  \param rotates True if the item should rotate, otherwise the angular factor
  *         is set to 0 preventing rotations from happening.
@@ -85,7 +107,7 @@ Flyable::Flyable(Kart *kart, PowerupType type, float mass) : Moveable()
  *         otherwise the kart's heading will be used.
  */
 void Flyable::createPhysics(float y_offset, const btVector3 &velocity,
-                            btCollisionShape *shape, const float gravity,
+                            const float gravity,
                             const bool rotates, const bool turn_around, 
                             const btTransform* customDirection)
 {
@@ -109,9 +131,23 @@ void Flyable::createPhysics(float y_offset, const btVector3 &velocity,
     
     trans  *= offset_transform;
 
-    m_shape = shape;
-    createBody(m_mass, trans, m_shape);
-    m_user_pointer.set(this);
+    // The collision shape (m_shape) is created once by the derived class.
+    // A recycled flyable keeps its body, which only needs to be reset.
+    if(!m_body)
+    {
+        createBody(m_mass, trans, m_shape);
+        m_user_pointer.set(this);
+    }
+    else
+    {
+        setTrans(trans);
+        m_body->setCenterOfMassTransform(trans);
+        m_body->setLinearVelocity(btVector3(0.0f, 0.0f, 0.0f));
+        m_body->setAngularVelocity(btVector3(0.0f, 0.0f, 0.0f));
+        m_body->setAngularFactor(1.0f);
+        m_body->clearForces();
+        m_body->forceActivationState(ACTIVE_TAG);
+    }
     RaceManager::getWorld()->getPhysics()->addBody(getBody());
 
     m_body->setGravity(btVector3(0.0f, 0.0f, gravity));
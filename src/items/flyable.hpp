@@ -44,6 +44,8 @@ private:
     bool              m_adjust_z_velocity;
     
 protected:
+    /** Type of this flyable, used to recycle it. */
+    PowerupType       m_type;
     Kart*             m_owner;              // the kart which released this flyable
     btCollisionShape *m_shape;
     float             m_max_height;
@@ -99,13 +101,16 @@ protected:
     /** Init bullet for moving objects like projectiles. */
     void              createPhysics   (float y_offset, 
                                        const btVector3 &velocity,
-                                       btCollisionShape *shape, const float gravity=0.0f,
+                                       const float gravity=0.0f,
                                        const bool rotates=false, const bool turn_around=false, 
                                        const btTransform* customDirection=NULL);
 public:
 
-                 Flyable           (Kart* kart, PowerupType type, float mass=1.0f);
+                 Flyable           (PowerupType type, float mass=1.0f);
     virtual     ~Flyable           ();
+    virtual void launch            (Kart *kart);
+    virtual void recycle           ();
+    PowerupType  getType           () const {return m_type;             }
     /** Enables/disables adjusting ov velocity depending on height above 
      *  terrain. Missiles can 'follow the terrain' with this adjustment,
      *  but gravity will basically be disabled.                          */
@@ -26,21 +26,36 @@
 
 Item::Item(ItemType type, const Vec3& xyz, const Vec3& normal,
            ssgEntity* model)
+{
+    m_root             = new ssgTransform();
+    m_root->ref();
+    m_distance_2       = 0.8f;
+    m_listener         = NULL;
+    init(type, xyz, normal, model);
+}   // Item
+
+//-----------------------------------------------------------------------------
+/** Initialises a new or recycled (see ItemManager::newItem) item which 
+ *  has a model, and adds it to the scene.
+ *  \param type Type of the item.
+ *  \param xyz Position of the item.
+ *  \param normal The normal of the terrain to set roll and pitch.
+ *  \param model The model of the item.
+ */
+void Item::init(ItemType type, const Vec3& xyz, const Vec3& normal,
+                ssgEntity* model)
 {
     assert(type != ITEM_TRIGGER);
     initItem(type, xyz);
     // Sets heading to 0, and sets pitch and roll depending on the normal. */
     Vec3 hpr           = Vec3(0, normal);
     m_coord            = Coord(xyz, hpr);
-    m_root             = new ssgTransform();
-    m_distance_2       = 0.8f;
     m_original_model   = model;
-    m_listener         = NULL;
-    m_root->ref();
+    m_root->removeAllKids();
     m_root->setTransform(const_cast<sgCoord*>(&m_coord.toSgCoord()));
     m_root->addKid(model);
     scene->add(m_root);
-}   // Item
+}   // init
 //-----------------------------------------------------------------------------
 /** \brief Constructor to create a trigger item.
   * Trigger items are invisible and can be used to trigger a behavior when
@@ -96,6 +96,8 @@ public:
                   Item(const Vec3& xyz, float distance, 
                        TriggerItemListener* trigger);
     virtual       ~Item ();
+    void          init(ItemType type, const Vec3& xyz, const Vec3& normal,
+                       ssgEntity* model);
     void          update  (float delta);
     virtual void  isCollected(const Kart *kart, float t=2.0f);
     
@@ -17,6 +17,7 @@
 //  along with this program; if not, write to the Free Software
 //  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
+#include <math.h>
 #include <stdexcept>
 #include <string>
 #include <sstream>
@@ -25,7 +26,9 @@
 #include "loader.hpp"
 #include "material_manager.hpp"
 #include "material.hpp"
+#include "race_manager.hpp"
 #include "user_config.hpp"
+#include "graphics/scene.hpp"
 #include "items/item_manager.hpp"
 #include "karts/kart.hpp"
 #include "modes/linear_world.hpp"
@@ -110,15 +113,16 @@ void ItemManager::removeTextures()
 ItemManager::ItemManager()
 {
     // The actual loading is done in loadDefaultItems
-    if(Track::get())
+    if(RaceManager::getTrack())
     {
         m_items_in_sector = new std::vector<AllItemTypes>;
-        m_items_in_sector->resize(Track::get()->m_driveline.size()+1);
+        m_items_in_sector->resize(RaceManager::getTrack()->m_driveline.size()+1);
     }
     else
     {
         m_items_in_sector = NULL;
     }
+    m_ai_items_dirty = true;
 }   // ItemManager
 
 //-----------------------------------------------------------------------------
@@ -134,6 +138,12 @@ ItemManager::~ItemManager()
             delete *i;
     }
     m_all_items.clear();
+    for(AllItemTypes::iterator i =m_free_items.begin();
+        i!=m_free_items.end();  i++)
+    {
+        delete *i;
+    }
+    m_free_items.clear();
     callback_manager->clear(CB_ITEM);
 }   // ~ItemManager
 
@@ -161,16 +171,17 @@ void ItemManager::insertItem(Item *h)
     {
         const Vec3 &xyz = h->getXYZ();
         int sector = Track::UNKNOWN_SECTOR;
-        Track::get()->findRoadSector(xyz, &sector);
+        RaceManager::getTrack()->findRoadSector(xyz, &sector);
         if(sector==Track::UNKNOWN_SECTOR)
             (*m_items_in_sector)[m_items_in_sector->size()-1].push_back(h);
         else
             (*m_items_in_sector)[sector].push_back(h);
+        m_ai_items_dirty = true;
     }
 }   // insertItem
 
 //-----------------------------------------------------------------------------
-/** Creates a new item.
+/** Creates a new item, if possible by recycling an item that was removed.
  *  \param type Type of the item.
  *  \param xyz Position of the item.
  *  \param normal The normal of the terrain to set roll and pitch.
@@ -180,7 +191,17 @@ void ItemManager::insertItem(Item *h)
 Item* ItemManager::newItem(Item::ItemType type, const Vec3& xyz, const Vec3 &normal,
                            Kart* parent)
 { 
-    Item *h = new Item(type, xyz, normal, m_item_model[type]);
+    Item *h;
+    if(m_free_items.empty())
+    {
+        h = new Item(type, xyz, normal, m_item_model[type]);
+    }
+    else
+    {
+        h = m_free_items.back();
+        m_free_items.pop_back();
+        h->init(type, xyz, normal, m_item_model[type]);
+    }
     
     insertItem(h);
     if(parent != NULL) h->setParent(parent);
@@ -278,7 +299,8 @@ void ItemManager::update(float delta)
 }   // delta
 //-----------------------------------------------------------------------------
 /** Removes an items from the items-in-sector list, from the list of all
- *  items, and then frees the item itself.
+ *  items, and from the scene. Items with a model are then kept for reuse
+ *  by newItem, trigger items are freed.
  *  \param h The item to delete.
  */
 void ItemManager::deleteItem(Item *h)
@@ -288,7 +310,7 @@ void ItemManager::deleteItem(Item *h)
     {
         const Vec3 &xyz = h->getXYZ();
         int sector = Track::UNKNOWN_SECTOR;
-        Track::get()->findRoadSector(xyz, &sector);
+        RaceManager::getTrack()->findRoadSector(xyz, &sector);
         unsigned int indx = sector==Track::UNKNOWN_SECTOR
                           ? m_items_in_sector->size()-1
                           : sector;
@@ -296,10 +318,144 @@ void ItemManager::deleteItem(Item *h)
         AllItemTypes::iterator it = std::find(items.begin(), items.end(), h);
         assert(it!=items.end());
         items.erase(it);
+        m_ai_items_dirty = true;
     }   // if m_items_in_sector
 
     int index = h->getItemId();
     m_all_items[index] = NULL;
-    delete h;
+    if(h->getRoot())
+    {
+        scene->remove(h->getRoot());
+        m_free_items.push_back(h);
+    }
+    else
+        delete h;
 }   // deleteItem
 //------------------------------------------------------------------------------
+/** Builds the item lists of the AI (see m_ai_sector_start) if items were
+ *  added or removed, and updates which items are collected. This is called
+ *  once per frame before the AI karts think, so that the AI only reads
+ *  these lists.
+ */
+void ItemManager::updateAIItems()
+{
+    if(!m_items_in_sector) return;
+    if(m_ai_items_dirty)
+    {
+        // The last list contains the items which are not on the driveline,
+        // those are ignored by the AI.
+        const unsigned int num_sectors = m_items_in_sector->size()-1;
+        m_ai_sector_start.resize(num_sectors+1);
+        m_ai_items.clear();
+        for(unsigned int i=0; i<num_sectors; i++)
+        {
+            m_ai_sector_start[i] = m_ai_items.size();
+            const AllItemTypes &items = (*m_items_in_sector)[i];
+            m_ai_items.insert(m_ai_items.end(), items.begin(), items.end());
+        }
+        m_ai_sector_start[num_sectors] = m_ai_items.size();
+        m_ai_item_x.resize(m_ai_items.size());
+        m_ai_item_y.resize(m_ai_items.size());
+        m_ai_item_type.resize(m_ai_items.size());
+        for(unsigned int i=0; i<m_ai_items.size(); i++)
+        {
+            m_ai_item_x[i] = m_ai_items[i]->getXYZ().getX();
+            m_ai_item_y[i] = m_ai_items[i]->getXYZ().getY();
+        }
+        m_ai_items_dirty = false;
+    }
+    for(unsigned int i=0; i<m_ai_items.size(); i++)
+    {
+        const Item *item = m_ai_items[i];
+        m_ai_item_type[i] = item->wasCollected() ? Item::ITEM_NONE
+                                                 : item->getType();
+    }
+}   // updateAIItems
+
+//-----------------------------------------------------------------------------
+/** Evaluates the AI items start to end-1 for a query. The loop has no
+ *  branches and only reads consecutive arrays, so the compiler can
+ *  vectorise it.
+ *  \param query The query.
+ *  \param best_score Score of the best item to collect found so far.
+ *  \param nearest Distance of the nearest item to avoid found so far.
+ */
+void ItemManager::evaluateAIItemRange(AIItemQuery *query, int start, int end,
+                                      float *best_score, float *nearest) const
+{
+    // An empty range can happen with no items at all, in which case
+    // m_ai_item_x[0] etc. must not be accessed.
+    if(start>=end) return;
+    const float  px           = query->m_xyz.getX();
+    const float  py           = query->m_xyz.getY();
+    const float  ax           = query->m_aim.getX();
+    const float  ay           = query->m_aim.getY();
+    const float  max_distance = query->m_max_distance;
+    const float  max_lateral  = query->m_max_lateral;
+    const float  inv_distance = 1.0f/max_distance;
+    const float  inv_lateral  = 1.0f/max_lateral;
+    const float *weight       = query->m_weight;
+    const float *x            = &m_ai_item_x[0];
+    const float *y            = &m_ai_item_y[0];
+    const int   *type         = &m_ai_item_type[0];
+
+    float score   = *best_score;
+    float nearest_distance = *nearest;
+    int   collect = -1;
+    int   avoid   = -1;
+    for(int i=start; i<end; i++)
+    {
+        // Position of the item along and across the line to the aim point.
+        const float dx    = x[i]-px;
+        const float dy    = y[i]-py;
+        const float along = dx*ax + dy*ay;
+        const float lat   = fabsf(dx*ay - dy*ax);
+        const float w     = weight[type[i]];
+        const bool  ahead = along>0 && along<max_distance;
+        // Items closer to the kart and closer to the line score higher.
+        const float s     = w*(1.0f-along*inv_distance)
+                             *(1.0f-lat*inv_lateral);
+        const bool  better  = ahead && w>0 && lat<max_lateral && s>score;
+        const bool  blocked = ahead && w<0 && lat<query->m_avoid_lateral
+                           && along<nearest_distance;
+        score            = better  ? s     : score;
+        collect          = better  ? i     : collect;
+        nearest_distance = blocked ? along : nearest_distance;
+        avoid            = blocked ? i     : avoid;
+    }   // for i
+    *best_score = score;
+    *nearest    = nearest_distance;
+    if(collect>=0) query->m_collect = m_ai_items[collect];
+    if(avoid  >=0) query->m_avoid   = m_ai_items[avoid];
+}   // evaluateAIItemRange
+
+//-----------------------------------------------------------------------------
+/** Finds the best item to collect and the nearest item to avoid for an AI
+ *  kart in the next sectors. updateAIItems() must have been called in this
+ *  frame. Since this only reads data, it can be called by several AI
+ *  threads at the same time.
+ *  \param query The query, the results are stored in m_collect/m_avoid.
+ *  \param sector The sector of the kart.
+ *  \param num_sectors Number of sectors to search (including sector).
+ */
+void ItemManager::evaluateAIItems(AIItemQuery *query, int sector,
+                                  int num_sectors) const
+{
+    query->m_collect = NULL;
+    query->m_avoid   = NULL;
+    const int n = (int)m_ai_sector_start.size()-1;
+    if(n<=0 || sector<0 || sector>=n || query->m_max_distance<=0) return;
+    if(num_sectors>n) num_sectors = n;
+
+    float best_score = 0.0f;
+    float nearest    = query->m_max_distance;
+    const int last   = sector+num_sectors;
+    evaluateAIItemRange(query, m_ai_sector_start[sector],
+                        m_ai_sector_start[std::min(last, n)],
+                        &best_score, &nearest);
+    // The sectors wrap around at the end of the driveline.
+    if(last>n)
+        evaluateAIItemRange(query, m_ai_sector_start[0],
+                            m_ai_sector_start[last-n],
+                            &best_score, &nearest);
+}   // evaluateAIItems
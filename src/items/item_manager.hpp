@@ -33,12 +33,37 @@ class ssgEntity;
 
 class ItemManager
 {
+public:
+    /** An item query of the AI: finds the best item to collect and the
+     *  nearest item to avoid on the line from the kart to its aim point. */
+    struct AIItemQuery
+    {
+        /** Position of the kart. */
+        Vec3        m_xyz;
+        /** Normalised direction (in the x/y plane) the kart drives to. */
+        Vec3        m_aim;
+        /** Only items ahead and closer than this are considered. */
+        float       m_max_distance;
+        /** Items to collect must be at most this far from the line. */
+        float       m_max_lateral;
+        /** Items to avoid closer than this to the line are hit. */
+        float       m_avoid_lateral;
+        /** Weight of each item type: positive for items to collect,
+         *  negative for items to avoid. */
+        float       m_weight[Item::ITEM_NONE+1];
+        /** Results: the items to collect and to avoid, or NULL. */
+        const Item *m_collect;
+        const Item *m_avoid;
+    };   // AIItemQuery
 
 private:
     // The vector of all items of the current track
     typedef std::vector<Item*> AllItemTypes;
     AllItemTypes m_all_items;
 
+    /** Items (with a model) which were removed, recycled by newItem. */
+    AllItemTypes m_free_items;
+
     // This stores all item models
     static std::vector<ssgEntity *> m_item_model;
 
@@ -47,10 +72,24 @@ private:
 
     void insertItem(Item *h);
     void deleteItem(Item *h);
+    void evaluateAIItemRange(AIItemQuery *query, int start, int end,
+                             float *best_score, float *nearest) const;
 
     // Stores which items are on which sectors
     std::vector< AllItemTypes > *m_items_in_sector;
 
+    /** The items on the driveline in structure of arrays form for the AI,
+     *  built from m_items_in_sector by updateAIItems(). The items of sector
+     *  i are the entries m_ai_sector_start[i] to m_ai_sector_start[i+1]-1.
+     *  Collected items have the type ITEM_NONE. */
+    std::vector<int>   m_ai_sector_start;
+    std::vector<float> m_ai_item_x;
+    std::vector<float> m_ai_item_y;
+    std::vector<int>   m_ai_item_type;
+    AllItemTypes       m_ai_items;
+    /** True if items were added or removed since the AI lists were built. */
+    bool               m_ai_items_dirty;
+
     ItemManager();
    ~ItemManager();
 
@@ -74,6 +113,9 @@ public:
     void         reset           ();
     void         collectedItem   (Item *h, Kart *kart,
                                  int add_info=-1);
+    void         updateAIItems   ();
+    void         evaluateAIItems (AIItemQuery *query, int sector,
+                                  int num_sectors) const;
     unsigned int getNumberOfItems()      const {return m_all_items.size();}
     const Item*  getItem(unsigned int n) const {return m_all_items[n];};
     Item*        getItem(unsigned int n)       {return m_all_items[n];};
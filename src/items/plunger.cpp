@@ -30,8 +30,21 @@
 #include "utils/constants.hpp"
 
 // -----------------------------------------------------------------------------
-Plunger::Plunger(Kart *kart) : Flyable(kart, POWERUP_PLUNGER)
+Plunger::Plunger(Kart *kart) : Flyable(POWERUP_PLUNGER)
 {
+    m_shape       = new btCylinderShape(0.5f*m_extend);
+    m_rubber_band = new RubberBand(this);
+    m_rubber_band->ref();
+    launch(kart);
+}   // Plunger
+
+// -----------------------------------------------------------------------------
+/** Shoots a new or recycled plunger.
+ *  \param kart The kart which shoots the plunger.
+ */
+void Plunger::launch(Kart *kart)
+{
+    Flyable::launch(kart);
     const float gravity = 0.0f;
 
     float y_offset = 0.5f*kart->getKartLength()+0.5f*m_extend.getY();
@@ -70,12 +83,12 @@ Plunger::Plunger(Kart *kart) : Flyable(kart, POWERUP_PLUNGER)
         m_initial_velocity = btVector3(0.0f, plunger_speed, up_velocity);
 
         createPhysics(y_offset, m_initial_velocity,
-                      new btCylinderShape(0.5f*m_extend), gravity, false /* rotates */, false, &trans );
+                      gravity, false /* rotates */, false, &trans );
     }
     else
     {
         createPhysics(y_offset, btVector3(pitch, plunger_speed, 0.0f),
-                      new btCylinderShape(0.5f*m_extend), gravity, false /* rotates */, m_reverse_mode, &trans );
+                      gravity, false /* rotates */, m_reverse_mode, &trans );
     }
     
     // Adjust height according to terrain
@@ -83,15 +96,12 @@ Plunger::Plunger(Kart *kart) : Flyable(kart, POWERUP_PLUNGER)
 
     // Pulling back makes no sense in battle mode, since this mode is not a race.
     // So, in battle mode, always hide view.
-    if( m_reverse_mode || race_manager->isBattleMode(race_manager->getMinorMode()) )
-        m_rubber_band = NULL;
-    else
-    {
-        m_rubber_band = new RubberBand(this, *kart);
-        m_rubber_band->ref();
-    }
+    m_has_rubber_band = !m_reverse_mode &&
+                   !race_manager->isBattleMode(race_manager->getMinorMode());
+    if(m_has_rubber_band)
+        m_rubber_band->reset(kart);
     m_keep_alive = -1;
-}   // Plunger
+}   // launch
 
 // -----------------------------------------------------------------------------
 Plunger::~Plunger()
@@ -100,6 +110,16 @@ Plunger::~Plunger()
     ssgDeRefDelete(m_rubber_band);
 }   // ~Plunger
 
+// -----------------------------------------------------------------------------
+/** Removes the plunger and its rubber band from the scene, so that it can be
+ *  launched again.
+ */
+void Plunger::recycle()
+{
+    Flyable::recycle();
+    m_rubber_band->removeFromScene();
+}   // recycle
+
 // -----------------------------------------------------------------------------
 void Plunger::init(const lisp::Lisp* lisp, ssgEntity *plunger_model)
 {
@@ -122,13 +142,13 @@ bool Plunger::updateAndDel(float dt)
             scene->remove(m);
             return true;
         }
-        if(m_rubber_band != NULL) m_rubber_band->update(dt);
+        if(m_has_rubber_band) m_rubber_band->update(dt);
         return false;
     }
 
     // Else: update the flyable and the rubber band.
     bool ret = Flyable::updateAndDel(dt);
-    if(m_rubber_band != NULL) m_rubber_band->update(dt);
+    if(m_has_rubber_band) m_rubber_band->update(dt);
     return ret;
 }   // updateAndDel
 
@@ -29,8 +29,12 @@ class MovingPhysics;
 class Plunger : public Flyable
 {
 private:
-    /** The rubber band attached to a plunger. */
+    /** The rubber band attached to a plunger. It is kept when the
+     *  plunger is recycled. */
     RubberBand  *m_rubber_band;
+    /** True if the rubber band is used, i.e. the plunger was not fired
+     *  backwards, and this is not a battle mode. */
+    bool         m_has_rubber_band;
     /** Timer to keep the plunger alive while the rubber band is working. */
     float        m_keep_alive;
     btVector3    m_initial_velocity;
@@ -39,6 +43,8 @@ private:
 public:
                  Plunger(Kart *kart);
                 ~Plunger();
+    virtual void launch   (Kart *kart);
+    virtual void recycle  ();
     static  void init     (const lisp::Lisp* lisp, ssgEntity* missile);
     /** Sets the keep-alive value. Setting it to 0 will remove the plunger
      *  at the next update - which is used if the rubber band snaps. 
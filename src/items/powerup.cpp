@@ -259,7 +259,7 @@ void Powerup::hitBonusBox(int n, const Item *item, int add_info)
                     set(POWERUP_PARACHUTE, 1);
                     if(network_manager->getMode()==NetworkManager::NW_SERVER)
                     {
-                        race_state->itemCollected(m_owner->getWorldKartId(), 
+                        RaceState::get()->itemCollected(m_owner->getWorldKartId(), 
                                                   item->getItemId(), 
                                                   m_type);
                     }
@@ -271,7 +271,7 @@ void Powerup::hitBonusBox(int n, const Item *item, int add_info)
 
             if(network_manager->getMode()==NetworkManager::NW_SERVER)
             {
-                race_state->itemCollected(m_owner->getWorldKartId(), 
+                RaceState::get()->itemCollected(m_owner->getWorldKartId(), 
                                           item->getItemId(), 
                                           (char)m_type);
             }
@@ -315,7 +315,7 @@ void Powerup::hitBonusBox(int n, const Item *item, int add_info)
     // so that the clients can be updated.
     if(network_manager->getMode()==NetworkManager::NW_SERVER)
     {
-        race_state->itemCollected(m_owner->getWorldKartId(), 
+        RaceState::get()->itemCollected(m_owner->getWorldKartId(), 
                                   item->getItemId(), 
                                   newC);
     }
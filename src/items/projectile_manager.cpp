@@ -76,6 +76,21 @@ void ProjectileManager::cleanup()
         ssgDeRefDelete(*i);
     }
     m_active_explosions.clear();
+    for(int type=0; type<POWERUP_MAX; type++)
+    {
+        for(Projectiles::iterator i = m_free_projectiles[type].begin();
+            i != m_free_projectiles[type].end(); ++i)
+        {
+            delete *i;
+        }
+        m_free_projectiles[type].clear();
+    }
+    for(Explosions::iterator i  = m_free_explosions.begin();
+        i != m_free_explosions.end(); ++i)
+    {
+        ssgDeRefDelete(*i);
+    }
+    m_free_explosions.clear();
 }   // cleanup
 
 // -----------------------------------------------------------------------------
@@ -104,7 +119,8 @@ void ProjectileManager::update(float dt)
             }
             Flyable *f=*p;
             Projectiles::iterator pNext=m_active_projectiles.erase(p);  // returns the next element
-            delete f;
+            f->recycle();
+            m_free_projectiles[f->getType()].push_back(f);
             p=pNext;
         }   // while p!=m_active_projectiles.end()
     }
@@ -125,7 +141,7 @@ void ProjectileManager::update(float dt)
             if(!(*e)->hasEnded()) {e++; continue;}
             Explosion *exp=*e;
             Explosions::iterator eNext=m_active_explosions.erase(e);
-            ssgDeRefDelete(exp);  // reduce refcount and free object
+            m_free_explosions.push_back(exp);  // keep it for reuse
             e=eNext;
         }   // while e!=m_active_explosions.end()
     }   // if m_explosion_ended
@@ -139,7 +155,7 @@ void ProjectileManager::updateServer(float dt)
     // First update all projectiles on the track
     if(network_manager->getMode()!=NetworkManager::NW_NONE)
     {
-        race_state->setNumFlyables(m_active_projectiles.size());
+        RaceState::get()->setNumFlyables(m_active_projectiles.size());
     }
     Projectiles::iterator i = m_active_projectiles.begin();
     while(i!=m_active_projectiles.end())
@@ -148,7 +164,7 @@ void ProjectileManager::updateServer(float dt)
         // Store the state information on the server
         if(network_manager->getMode()!=NetworkManager::NW_NONE)
         {
-            race_state->setFlyableInfo(i-m_active_projectiles.begin(),
+            RaceState::get()->setFlyableInfo(i-m_active_projectiles.begin(),
                                        FlyableInfo((*i)->getXYZ(), 
                                                    (*i)->getRotation(),
                                                    (*i)->hasHit()));
@@ -164,7 +180,7 @@ void ProjectileManager::updateServer(float dt)
 void ProjectileManager::updateClient(float dt)
 {
     m_something_was_hit = false;
-    unsigned int num_projectiles = race_state->getNumFlyables();
+    unsigned int num_projectiles = RaceState::get()->getNumFlyables();
     if(num_projectiles != m_active_projectiles.size())
         fprintf(stderr, "Warning: num_projectiles %d active %d\n",num_projectiles,
                 (int)m_active_projectiles.size());
@@ -173,7 +189,7 @@ void ProjectileManager::updateClient(float dt)
     for(Projectiles::iterator i  = m_active_projectiles.begin();
         i != m_active_projectiles.end();   ++i, ++indx)
     {
-        const FlyableInfo &f = race_state->getFlyable(indx);
+        const FlyableInfo &f = RaceState::get()->getFlyable(indx);
         (*i)->updateFromServer(f, dt);
         if(f.m_exploded) 
         {
@@ -184,26 +200,67 @@ void ProjectileManager::updateClient(float dt)
 
 }   // updateClient
 // -----------------------------------------------------------------------------
+/** Creates a new projectile, if possible by recycling one of the same type
+ *  that was removed earlier.
+ *  \param kart The kart which shoots the projectile.
+ *  \param type Type of the projectile.
+ */
 Flyable *ProjectileManager::newProjectile(Kart *kart, PowerupType type)
 {
     Flyable *f;
     switch(type) 
     {
-        case POWERUP_BOWLING: f = new Bowling(kart); break;
-        case POWERUP_PLUNGER: f = new Plunger(kart); break;
-        case POWERUP_CAKE:    f = new Cake(kart);  break;
+        case POWERUP_BOWLING:
+        case POWERUP_PLUNGER:
+        case POWERUP_CAKE:    break;
         default:              return NULL;
     }
+    if(!m_free_projectiles[type].empty())
+    {
+        f = m_free_projectiles[type].back();
+        m_free_projectiles[type].pop_back();
+        f->launch(kart);
+    }
+    else
+    {
+        switch(type) 
+        {
+            case POWERUP_BOWLING: f = new Bowling(kart); break;
+            case POWERUP_PLUNGER: f = new Plunger(kart); break;
+            default:              f = new Cake(kart);    break;
+        }
+    }
     m_active_projectiles.push_back(f);
     return f;
 }   // newProjectile
 
 // -----------------------------------------------------------------------------
 /** See if there is an old, unused explosion object available. If so,
- *  reuse this object, otherwise create a new one. */
+ *  reuse this object, otherwise create a new one. An explosion using the
+ *  same sound is preferred, since otherwise the sound must be replaced. */
 Explosion* ProjectileManager::newExplosion(const Vec3& coord, const int explosion_sound)
 {
-    Explosion *e = new Explosion(coord, explosion_sound);
+    Explosion *e;
+    if(m_free_explosions.empty())
+    {
+        e = new Explosion(coord, explosion_sound);
+    }
+    else
+    {
+        Explosions::iterator i = m_free_explosions.end()-1;
+        for(Explosions::iterator j=m_free_explosions.begin(); 
+            j!=m_free_explosions.end(); j++)
+        {
+            if((*j)->getSoundType()==explosion_sound) 
+            {
+                i = j;
+                break;
+            }
+        }
+        e = *i;
+        m_free_explosions.erase(i);
+        e->init(coord, explosion_sound);
+    }
     m_active_explosions.push_back(e);
     return e;
 }   // newExplosion
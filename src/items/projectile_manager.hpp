@@ -44,6 +44,13 @@ private:
     // being shown
     Explosions       m_active_explosions;
 
+    /** Flyables which have been removed from the track, for each type.
+     *  They are recycled by newProjectile. */
+    Projectiles      m_free_projectiles[POWERUP_MAX];
+
+    /** Explosions which have ended, recycled by newExplosion. */
+    Explosions       m_free_explosions;
+
     ssgSelector*     m_explosion_model;
     bool             m_something_was_hit;
     bool             m_explosion_ended;
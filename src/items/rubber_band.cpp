@@ -28,20 +28,19 @@
 #include "modes/world.hpp"
 #include "physics/physics.hpp"
 
-/** RubberBand constructor. It creates a simple quad and attaches it to the
- *  root(!) of the graph. It's easier this way to get the right coordinates
- *  than attaching it to the plunger or kart, and trying to find the other
- *  coordinate.
+/** RubberBand constructor. It creates a simple quad, which is attached to
+ *  the root(!) of the graph by reset(). It's easier this way to get the right
+ *  coordinates than attaching it to the plunger or kart, and trying to find
+ *  the other coordinate.
  *  \param plunger Pointer to the plunger (non const, since the rubber band 
  *                 can trigger an explosion)
- *  \param kart    Reference to the kart.
  */
-RubberBand::RubberBand(Plunger *plunger, const Kart &kart)
+RubberBand::RubberBand(Plunger *plunger)
           : ssgVtxTable(GL_QUADS, new ssgVertexArray,
                         new ssgNormalArray,
                         new ssgTexCoordArray,
                         new ssgColourArray ), 
-            m_plunger(plunger), m_owner(kart)
+            m_plunger(plunger), m_owner(NULL)
 {
 #ifdef DEBUG
     setName("rubber_band");
@@ -50,8 +49,6 @@ RubberBand::RubberBand(Plunger *plunger, const Kart &kart)
     // The call to update defines the actual coordinates, only the entries are added for now.
     vertices->add(0, 0, 0); vertices->add(0, 0, 0);
     vertices->add(0, 0, 0); vertices->add(0, 0, 0);
-    m_attached_state = RB_TO_PLUNGER;
-    updatePosition();
 
     sgVec3 norm;
     sgSetVec3(norm, 1/sqrt(2.0f), 0, 1/sqrt(2.0f));
@@ -66,9 +63,21 @@ RubberBand::RubberBand(Plunger *plunger, const Kart &kart)
     m_state->disable(GL_CULL_FACE);
     setState(m_state);
     //setState(material_manager->getMaterial("chrome.rgb")->getState());
+}   // RubberBand
 
+// ----------------------------------------------------------------------------
+/** Attaches the rubber band to the (new or recycled) plunger and the kart 
+ *  which shot it, and adds it to the scene.
+ *  \param kart The kart which shot the plunger.
+ */
+void RubberBand::reset(const Kart *kart)
+{
+    m_owner          = kart;
+    m_hit_kart       = NULL;
+    m_attached_state = RB_TO_PLUNGER;
+    updatePosition();
     scene->add(this);
-}   // RubberBand
+}   // reset
 
 // ----------------------------------------------------------------------------
 /** Removes the rubber band from the scene. Is called when the plunger 
@@ -86,7 +95,7 @@ void RubberBand::removeFromScene()
  */
 void RubberBand::updatePosition()
 {
-    const Vec3 &k = m_owner.getXYZ();
+    const Vec3 &k = m_owner->getXYZ();
 
     // Get the position to which the band is attached
     // ----------------------------------------------
@@ -124,7 +133,7 @@ void RubberBand::updatePosition()
  */
 void RubberBand::update(float dt)
 {
-    if(m_owner.isEliminated())
+    if(m_owner->isEliminated())
     {
         // Rubber band snaps
         m_plunger->hit(NULL);
@@ -134,12 +143,12 @@ void RubberBand::update(float dt)
     }
 
     updatePosition();
-    const Vec3 &k = m_owner.getXYZ();
+    const Vec3 &k = m_owner->getXYZ();
     
     // Check for rubber band snapping
     // ------------------------------
     float l = (m_end_position-k).length2();
-    float max_len = m_owner.getKartProperties()->getRubberBandMaxLength();
+    float max_len = m_owner->getKartProperties()->getRubberBandMaxLength();
     if(l>max_len*max_len)
     {
         // Rubber band snaps
@@ -152,7 +161,7 @@ void RubberBand::update(float dt)
     // ----------------------------
     if(m_attached_state!=RB_TO_PLUNGER)
     {
-        float force = m_owner.getKartProperties()->getRubberBandForce();
+        float force = m_owner->getKartProperties()->getRubberBandForce();
         Vec3 diff   = m_end_position-k;
         
         // detach rubber band if kart gets very close to hit point
@@ -166,7 +175,7 @@ void RubberBand::update(float dt)
         }
         
         diff.normalize();   // diff can't be zero here
-        m_owner.getBody()->applyCentralForce(diff*force);
+        m_owner->getBody()->applyCentralForce(diff*force);
         if(m_attached_state==RB_TO_KART)
             m_hit_kart->getBody()->applyCentralForce(diff*(-force));
     }
@@ -185,19 +194,19 @@ void RubberBand::checkForHit(const Vec3 &k, const Vec3 &p)
     short int old_kart_group=0;
 
     // If the owner is being rescued, the broadphase handle does not exist!
-    if(m_owner.getBody()->getBroadphaseHandle())
-        old_kart_group = m_owner.getBody()->getBroadphaseHandle()->m_collisionFilterGroup;
+    if(m_owner->getBody()->getBroadphaseHandle())
+        old_kart_group = m_owner->getBody()->getBroadphaseHandle()->m_collisionFilterGroup;
     m_plunger->getBody()->getBroadphaseHandle()->m_collisionFilterGroup = 0;
-    if(m_owner.getBody()->getBroadphaseHandle())
-        m_owner.getBody()->getBroadphaseHandle()->m_collisionFilterGroup = 0;
+    if(m_owner->getBody()->getBroadphaseHandle())
+        m_owner->getBody()->getBroadphaseHandle()->m_collisionFilterGroup = 0;
 
     // Do the raycast
     RaceManager::getWorld()->getPhysics()->getPhysicsWorld()->rayTest(k, p, 
                                                                       ray_callback);
     // Reset collision groups
     m_plunger->getBody()->getBroadphaseHandle()->m_collisionFilterGroup = old_plunger_group;
-    if(m_owner.getBody()->getBroadphaseHandle())
-        m_owner.getBody()->getBroadphaseHandle()->m_collisionFilterGroup = old_kart_group;
+    if(m_owner->getBody()->getBroadphaseHandle())
+        m_owner->getBody()->getBroadphaseHandle()->m_collisionFilterGroup = old_kart_group;
     if(ray_callback.HasHit())
     {
         Vec3 pos(ray_callback.m_hitPointWorld);
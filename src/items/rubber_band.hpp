@@ -44,7 +44,7 @@ private:
     /** The plunger the rubber band is attached to. */
     Plunger        *m_plunger;
     /** The kart who shot this plunger. */
-    const Kart     &m_owner;
+    const Kart     *m_owner;
     /** The kart a plunger might have hit. */
     Kart           *m_hit_kart;
     /** State for rubber band. */
@@ -58,7 +58,8 @@ private:
     void updatePosition();
 
 public:
-         RubberBand(Plunger *plunger, const Kart &kart);
+         RubberBand(Plunger *plunger);
+    void reset(const Kart *kart);
     void update(float dt);
     void removeFromScene();
     void hit(Kart *kart_hit, const Vec3 *track_xyz=NULL);
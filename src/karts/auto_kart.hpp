@@ -24,14 +24,36 @@
 #include "karts/kart.hpp"
 #include "karts/kart_properties.hpp"
 
+/** Base class of all AI karts. The AI of all karts is computed in a
+ *  separate phase before the karts are updated: first needsThink is called
+ *  for each AI kart, then think is called (possibly in parallel on several
+ *  threads) for all karts that need it. While the AI is computed, no other
+ *  object is modified, so think must only read the state of other objects.
+ *  Changes of the world (e.g. a rescue) must be done later in update().
+ *  If the AI takes too much time, the world can postpone the karts which
+ *  are due (TR_DUE) but not urgent (TR_URGENT): those karts keep their
+ *  controls (and only do cheap updates in update()), and request to think
+ *  again in the next frame.
+ */
 class AutoKart : public Kart
 {
     public:
+        /** Result of needsThink. */
+        enum ThinkRequest {TR_NONE, TR_DUE, TR_URGENT};
+
         AutoKart(const std::string& kart_name, int position,
                  const btTransform& init_pos) :
            Kart(kart_name, position, init_pos) {}
 
         bool  isPlayerKart() const {return false;}
+        /** Returns if the AI must compute new controls in this frame.
+         *  Called for all AI karts, one after the other. */
+        virtual ThinkRequest needsThink(float dt) {return TR_NONE;}
+        /** Computes the controls of this kart. */
+        virtual void  think() {}
+        /** Returns the time since think was called the last time, used to
+         *  decide which karts are postponed. */
+        virtual float getTimeSinceThink() const {return 0.0f;}
 };
 
 #endif
@@ -32,6 +32,7 @@
 #include "file_manager.hpp"
 #include "user_config.hpp"
 #include "material_manager.hpp"
+#include "telemetry.hpp"
 #include "audio/sound_manager.hpp"
 #include "audio/sfx_manager.hpp"
 #include "audio/sfx_base.hpp"
@@ -100,6 +101,7 @@ Kart::Kart (const std::string& kart_name, int position,
     // also called at the very start, it must be guaranteed that rescue is
     // not set.
     m_rescue                  = false;
+    m_simulation_level        = SL_FULL;
     m_wheel_rotation          = 0;
 
     m_engine_sound  = sfx_manager->newSFX(m_kart_properties->getEngineSfxType());
@@ -314,12 +316,13 @@ void Kart::updatedWeight()
 /** Resets the kart. */
 void Kart::reset()
 {
-    // If the kart was eliminated or rescued, the body was removed from the
-    // physics world. Add it again.
-    if(m_eliminated || m_rescue)
+    // If the kart was eliminated, rescued or moved kinematically, the body
+    // was removed from the physics world. Add it again.
+    if(m_eliminated || m_rescue || m_simulation_level==SL_KINEMATIC)
     {
         RaceManager::getWorld()->getPhysics()->addKart(this);
     }
+    m_simulation_level     = SL_FULL;
 
     m_view_blocked_by_plunger = 0.0;
     m_attachment.clear();
@@ -336,6 +339,10 @@ void Kart::reset()
     m_bounce_back_time     = 0.0f;
     m_skidding             = 1.0f;
     m_time_last_crash      = 0.0f;
+    m_num_rescues          = 0;
+    m_num_shortcuts        = 0;
+    m_num_kart_crashes     = 0;
+    m_num_track_crashes    = 0;
     m_max_speed_reduction  = 0.0f;
     m_power_reduction      = 50.0f;
 
@@ -378,6 +385,7 @@ void Kart::raceFinished(float time)
 void Kart::collectedItem(const Item *item, int add_info)
 {
     const Item::ItemType type = item->getType();
+    telemetry->addEvent(Telemetry::EV_ITEM_COLLECTED, m_world_kart_id, type);
 
     switch (type)
     {
@@ -407,7 +415,7 @@ void Kart::collectedItem(const Item *item, int add_info)
     if(network_manager->getMode()==NetworkManager::NW_SERVER &&
       (type==Item::ITEM_SMALL_NITRO || type==Item::ITEM_BIG_NITRO))
     {
-        race_state->itemCollected(getWorldKartId(), item->getItemId());
+        RaceState::get()->itemCollected(getWorldKartId(), item->getItemId());
     }
 
     if(m_collected_energy > MAX_ITEMS_COLLECTED)
@@ -460,16 +468,19 @@ bool Kart::isNearGround() const
 //-----------------------------------------------------------------------------
 void Kart::handleExplosion(const Vec3& pos, bool direct_hit)
 {
+    // The impulse can only be applied if the kart is in the physics world.
+    if(m_simulation_level==SL_KINEMATIC) setSimulationLevel(SL_REDUCED);
     if(direct_hit) 
     {
-        btVector3 diff((float)(rand()%16/16), (float)(rand()%16/16), 2.0f);
+        btVector3 diff((float)(m_random.get(16)/16), 
+                       (float)(m_random.get(16)/16), 2.0f);
         diff.normalize();
         diff*=stk_config->m_explosion_impulse/5.0f;
         m_uprightConstraint->setDisableTime(10.0f);
         getVehicle()->getRigidBody()->applyCentralImpulse(diff);
-        getVehicle()->getRigidBody()->applyTorqueImpulse(btVector3(float(rand()%32*5),
-                                                                   float(rand()%32*5),
-                                                                   float(rand()%32*5)));
+        getVehicle()->getRigidBody()->applyTorqueImpulse(btVector3(float(m_random.get(32)*5),
+                                                                   float(m_random.get(32)*5),
+                                                                   float(m_random.get(32)*5)));
     }
     else  // only affected by a distant explosion
     {
@@ -507,7 +518,7 @@ void Kart::update(float dt)
     // anymore (e.g. controls.fire).
     if(network_manager->getMode()==NetworkManager::NW_SERVER)
     {
-        race_state->storeKartControls(*this);
+        RaceState::get()->storeKartControls(*this);
     }
 
     // On a client fiering is done upon receiving the command from the server.
@@ -544,7 +555,7 @@ void Kart::update(float dt)
             m_attachment.set(ATTACH_TINYTUX, rescue_time);
             m_rescue_pitch = getPitch();
             m_rescue_roll  = getRoll();  
-            race_state->itemCollected(getWorldKartId(), -1, -1);
+            RaceState::get()->itemCollected(getWorldKartId(), -1, -1);
         }
         RaceManager::getWorld()->getPhysics()->removeKart(this);
         btQuaternion q_roll (btVector3(0.f, 1.f, 0.f),
@@ -557,12 +568,14 @@ void Kart::update(float dt)
     m_attachment.update(dt);
 
     //smoke drawing control point
-    if (user_config->m_graphical_effects)
+    if (user_config->m_graphical_effects && m_simulation_level==SL_FULL)
     {
         m_smoke_system->update(dt);
         m_nitro->update(dt);
     }  // user_config->m_graphical_effects
-    updatePhysics(dt);
+    // A kinematic kart is moved (and its speed set) by the AI.
+    if(m_simulation_level!=SL_KINEMATIC)
+        updatePhysics(dt);
 
     // kart_info.m_last_track_coords = kart_info.m_curr_track_coords;
 
@@ -644,7 +657,7 @@ void Kart::update(float dt)
 
     // Check if any item was hit.
     ItemManager::get()->hitItem(this);
-    if(m_kart_properties->hasSkidmarks())
+    if(m_kart_properties->hasSkidmarks() && m_simulation_level==SL_FULL)
         m_skidmarks->update(dt);
 
     // Remove the shadow if the kart is not on the ground (if a kart
@@ -752,6 +765,10 @@ void Kart::crashed(Kart *k)
     if(RaceManager::getWorld()->getTime()-m_time_last_crash < 0.5f) return;
 
     m_time_last_crash = RaceManager::getWorld()->getTime();
+    if(k)
+        m_num_kart_crashes++;
+    else
+        m_num_track_crashes++;
     // After a collision disable the engine for a short time so that karts 
     // can 'bounce back' a bit (without this the engine force will prevent
     // karts from bouncing back, they will instead stuck towards the obstable).
@@ -963,6 +980,13 @@ void Kart::updatePhysics (float dt)
 //-----------------------------------------------------------------------------
 void Kart::forceRescue()
 {
+    // The rescue adds the kart back to the physics world at the end.
+    if(m_simulation_level==SL_KINEMATIC) setSimulationLevel(SL_REDUCED);
+    if(!m_rescue)
+    {
+        m_num_rescues++;
+        telemetry->addEvent(Telemetry::EV_RESCUE, m_world_kart_id);
+    }
     m_rescue=true;
 }   // forceRescue
 //-----------------------------------------------------------------------------
@@ -981,6 +1005,47 @@ void Kart::endRescue()
     RaceManager::getWorld()->getPhysics()->addKart(this);
 }   // endRescue
 
+//-----------------------------------------------------------------------------
+/** Changes the simulation level of detail of this kart. A kinematic kart is
+ *  removed from the physics world, and added back with a velocity matching
+ *  its speed and heading when it leaves the kinematic level. Only karts which
+ *  move themselves while kinematic (i.e. AI karts) must be set to 
+ *  SL_KINEMATIC.
+ *  \param level The new simulation level.
+ */
+void Kart::setSimulationLevel(SimulationLevel level)
+{
+    if(level==m_simulation_level) return;
+
+    // Terminate a skid mark in progress, otherwise it would be connected
+    // to the position at which the kart is simulated fully again.
+    if(m_simulation_level==SL_FULL && m_kart_properties->hasSkidmarks())
+    {
+        m_controls.m_drift = false;
+        m_skidmarks->update(0.0f);
+    }
+
+    // Rescued or eliminated karts are not in the physics world anyway.
+    if(!m_rescue && !m_eliminated)
+    {
+        if(level==SL_KINEMATIC)
+        {
+            RaceManager::getWorld()->getPhysics()->removeKart(this);
+        }
+        else if(m_simulation_level==SL_KINEMATIC)
+        {
+            // The kinematic movement only changed the motion state, so
+            // the body has to be moved to the current position.
+            m_body->setCenterOfMassTransform(getTrans());
+            m_body->setLinearVelocity(getTrans().getBasis().getColumn(1)
+                                      *m_speed);
+            m_body->setAngularVelocity(btVector3(0.0f, 0.0f, 0.0f));
+            RaceManager::getWorld()->getPhysics()->addKart(this);
+        }
+    }
+    m_simulation_level = level;
+}   // setSimulationLevel
+
 //-----------------------------------------------------------------------------
 
 void Kart::loadData()
@@ -32,6 +32,7 @@
 #include "karts/kart_control.hpp"
 #include "karts/kart_model.hpp"
 #include "tracks/terrain_info.hpp"
+#include "utils/random_generator.hpp"
 #include "material.hpp"
 
 class SkidMarks;
@@ -45,10 +46,25 @@ class btVehicleTuning;
 
 class Kart : public TerrainInfo, public Moveable
 {
+public:
+    /** The level of detail with which a kart is simulated, see
+     *  World::updateSimulationLevels(). */
+    enum SimulationLevel
+    {
+        SL_FULL,      /**< Full physics, AI and graphical effects.         */
+        SL_REDUCED,   /**< Full physics, but the AI is updated less often,
+                       *   and there are no skid marks or particles.       */
+        SL_KINEMATIC  /**< The kart is removed from the physics world, and
+                       *   the AI moves it along the driveline.            */
+    };
+
 private:
     btTransform  m_reset_transform;    // reset position
     unsigned int m_world_kart_id;      // index of kart in world
     float        m_skidding;           ///< Accumulated skidding factor.
+    /** Random numbers for explosions etc., each kart uses its own
+     *  generator so that results are reproducible. */
+    RandomGenerator m_random;
 
 protected:
     Attachment   m_attachment;
@@ -113,6 +129,8 @@ private:
     float         m_speed;
     bool          m_rescue;
     bool          m_eliminated;
+    /** The current simulation level of detail of this kart. */
+    SimulationLevel m_simulation_level;
 
     SFXBase      *m_engine_sound;
     SFXBase      *m_beep_sound;
@@ -122,6 +140,11 @@ private:
     SFXBase      *m_wee_sound;
     SFXBase      *m_goo_sound;
     float         m_time_last_crash;
+    /** Statistics of this race, used by the AI benchmark. */
+    int           m_num_rescues;
+    int           m_num_shortcuts;
+    int           m_num_kart_crashes;
+    int           m_num_track_crashes;
 
 protected:
     float                 m_rescue_pitch, m_rescue_roll;
@@ -182,6 +205,14 @@ public:
     int            getInitialPosition  () const {return  m_initial_position;}
     float          getFinishTime       () const {return  m_finish_time;     }
     bool           hasFinishedRace     () const {return  m_finished_race;   }
+    /** Number of rescues of this kart in this race. */
+    int            getNumRescues       () const {return  m_num_rescues;     }
+    /** Number of shortcuts this kart was punished for in this race. */
+    int            getNumShortcuts     () const {return  m_num_shortcuts;   }
+    /** Number of crashes with other karts in this race. */
+    int            getNumKartCrashes   () const {return  m_num_kart_crashes;}
+    /** Number of crashes with the track in this race. */
+    int            getNumTrackCrashes  () const {return  m_num_track_crashes;}
     void           endRescue           ();
     void           getClosestKart      (float *cdist, int *closest);
     void           updatePhysics       (float dt);
@@ -258,13 +289,16 @@ public:
     void           updatedWeight    ();
     void           forceRescue      ();
     void           handleExplosion  (const Vec3& pos, bool direct_hit);
+    SimulationLevel getSimulationLevel() const {return m_simulation_level;                 }
+    virtual void   setSimulationLevel(SimulationLevel level);
     const std::string& getName      () const {return m_kart_properties->getName();         }
     const std::string& getIdent     () const {return m_kart_properties->getIdent();        }
     virtual bool   isPlayerKart     () const {return false;                                }
     /** Called by world in case of the kart taking a shortcut. The player kart
-     *  will display a message in this case, default behaviour is to do nothing.
+     *  will display a message in this case, default behaviour is to only
+     *  count the shortcuts.
      */
-    virtual void   doingShortcut    () {};
+    virtual void   doingShortcut    () {m_num_shortcuts++;                                 }
     // addMessages gets called by world to add messages to the gui
     virtual void   addMessages      () {};
     virtual void   collectedItem    (const Item *item, int random_attachment);
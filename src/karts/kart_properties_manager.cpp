@@ -21,13 +21,13 @@
 
 #include <stdexcept>
 #include <algorithm>
-#include <ctime>
 
 #include "file_manager.hpp"
 #include "stk_config.hpp"
 #include "user_config.hpp"
 #include "challenges/unlock_manager.hpp"
 #include "karts/kart_properties.hpp"
+#include "utils/random_generator.hpp"
 #include "utils/string_utils.hpp"
 
 KartPropertiesManager *kart_properties_manager=0;
@@ -286,8 +286,13 @@ std::vector<std::string> KartPropertiesManager::getRandomKartList(int count,
         else
             i++;
     }
-    std::srand((unsigned int)std::time(0));
-    std::random_shuffle(karts.begin(), karts.end());
+    // The generator is seeded with the master seed, so that the same
+    // master seed always selects the same karts (e.g. in a replay or in
+    // a headless simulation).
+    RandomGenerator random;
+    random.seed(RandomGenerator::getMasterSeed());
+    for(int i=(int)karts.size()-1; i>0; i--)
+        std::swap(karts[i], karts[random.get(i+1)]);
 
     // Loop over all karts to fill till either all slots are filled, or
     // there are no more karts in the current group
@@ -310,7 +315,8 @@ std::vector<std::string> KartPropertiesManager::getRandomKartList(int count,
             !unlock_manager->isLocked(m_karts_properties[i]->getIdent()) )
             karts.push_back(i);
     }
-    std::random_shuffle(karts.begin(), karts.end());
+    for(int i=(int)karts.size()-1; i>0; i--)
+        std::swap(karts[i], karts[random.get(i+1)]);
     // Then fill up the remaining empty spaces
     while(count>0 && karts.size()>0)
     {
@@ -362,6 +362,7 @@ void PlayerKart::collectedItem(const Item *item, int add_info)
  */
 void PlayerKart::doingShortcut()
 {
+    Kart::doingShortcut();
     RaceGUI* m=(RaceGUI*)menu_manager->getRaceMenu();
     // Can happen if the option menu is called
     if(m)
@@ -53,9 +53,14 @@
 #include "sdldrv.hpp"
 #include "callback_manager.hpp"
 #include "history.hpp"
+#include "telemetry.hpp"
 #include "stk_config.hpp"
 #include "highscore_manager.hpp"
 #include "grand_prix_manager.hpp"
+#include "batch_race.hpp"
+#include "gp_simulation.hpp"
+#include "ai_benchmark.hpp"
+#include "ai_tuner.hpp"
 #include "audio/sound_manager.hpp"
 #include "audio/sfx_manager.hpp"
 #include "challenges/unlock_manager.hpp"
@@ -69,8 +74,12 @@
 #include "karts/kart_properties_manager.hpp"
 #include "karts/kart.hpp"
 #include "network/network_manager.hpp"
+#include "physics/physics.hpp"
+#include "robots/ai_properties.hpp"
 #include "tracks/track.hpp"
 #include "tracks/track_manager.hpp"
+#include "utils/profiler.hpp"
+#include "utils/random_generator.hpp"
 #include "utils/translation.hpp"
 
 // Only needed for bullet debug!
@@ -113,6 +122,40 @@ void cmdLineHelp (char* invocation)
     // "  --history=n          Replay history file 'history.dat' using mode:\n"
     // "                       n=1: use recorded positions\n"
     // "                       n=2: use recorded key strokes\n"
+    // "  --gp-sim=gp          Simulate the grand prix gp with AI karts only\n"
+    // "                       and print statistics for balancing\n"
+    // "  --gp-sim-runs=n      Number of grand prix to simulate (default 10)\n"
+    // "  --gp-sim-jobs=n      Number of worker processes to use\n"
+    // "  --ai-bench=types     Race the robot types (AI classes, e.g. default)\n"
+    // "                       on all tracks and print AI quality and timings\n"
+    // "  --ai-bench-difficulties=list Difficulties to race each robot type\n"
+    // "                       with (default easy,medium,hard)\n"
+    // "  --ai-bench-seeds=n   Number of seeds per track, type and difficulty\n"
+    // "                       (default 3)\n"
+    // "  --ai-bench-laps=n    Number of laps of each race (default 3)\n"
+    // "  --ai-bench-jobs=n    Number of worker processes to use\n"
+    // "  --ai-config=file     Read the AI parameters from file (a path, or\n"
+    // "                       a file in data)\n"
+    // "  --ai-tune=difficulty Optimise the AI parameters of a difficulty\n"
+    // "                       (easy, medium, hard) with races on all tracks\n"
+    // "  --ai-tune-iterations=n Number of iterations of the search (default 20)\n"
+    // "  --ai-tune-jobs=n     Number of worker processes to use\n"
+    // "  --ai-tune-output=file Write the best parameters to file (default\n"
+    // "                       ai.data in the config directory)\n"
+    // "  --telemetry=file     Write telemetry data of all karts to file\n"
+    // "  --telemetry-rate=n   Number of telemetry samples per second\n"
+    // "  --seed=n             Use n as master seed for all random numbers\n"
+    // "  --replay-bench       Replay 'history.dat' as fast as possible without\n"
+    // "                       graphics, then print timings and a state checksum\n"
+    // "  --broadphase=name    Use the physics broadphase 'axis-sweep' (default)\n"
+    // "                       or 'aabb-tree'\n"
+    // "  --broadphase-bench=n Compare the speed of all broadphases with n moving\n"
+    // "                       objects on the selected track\n"
+    // "  --physics-threads=n  Solve the physics islands with n threads\n"
+    // "  --ai-threads=n       Compute the AI karts with n threads\n"
+    // "  --no-terrain-cache   Cast a ray for each height of terrain query\n"
+    // "  --no-simulation-lod  Fully simulate AI karts far away from players\n"
+    // "  --no-bvh-cache       Rebuild the track collision meshes on each load\n"
     "  --server[=port]         This is the server (running on the specified port)\n"
     "  --client=ip             This is a client, connect to the specified ip address\n"
     "  --port=n                Port number to use\n"
@@ -408,6 +451,129 @@ int handleCmdLine(int argc, char **argv)
         {
             history->doReplayHistory(History::HISTORY_POSITION);
         }
+        else if( !strncmp(argv[i], "--gp-sim=", 9) && argv[i][9])
+        {
+            gp_simulation->setGrandPrix(argv[i]+9);
+        }
+        else if( sscanf(argv[i], "--gp-sim-runs=%d",  &n)==1 && n>0)
+        {
+            gp_simulation->setNumGPs(n);
+        }
+        else if( sscanf(argv[i], "--gp-sim-jobs=%d",  &n)==1 && n>0)
+        {
+            gp_simulation->setNumJobs(n);
+        }
+        else if( !strncmp(argv[i], "--ai-bench=", 11) && argv[i][11])
+        {
+            ai_benchmark->setTypes(argv[i]+11);
+        }
+        else if( !strncmp(argv[i], "--ai-bench-difficulties=", 24) &&
+                 argv[i][24])
+        {
+            ai_benchmark->setDifficulties(argv[i]+24);
+        }
+        else if( sscanf(argv[i], "--ai-bench-seeds=%d", &n)==1 && n>0)
+        {
+            ai_benchmark->setNumSeeds(n);
+        }
+        else if( sscanf(argv[i], "--ai-bench-laps=%d",  &n)==1 && n>0)
+        {
+            ai_benchmark->setNumLaps(n);
+        }
+        else if( sscanf(argv[i], "--ai-bench-jobs=%d",  &n)==1 && n>0)
+        {
+            ai_benchmark->setNumJobs(n);
+        }
+        else if( !strncmp(argv[i], "--ai-config=", 12) && argv[i][12])
+        {
+            // Accept a plain path (e.g. the output of the AI tuner),
+            // otherwise search the file in the data directory.
+            std::string filename = argv[i]+12;
+            if(!file_manager->fileExists(filename))
+                filename = file_manager->getConfigFile(filename);
+            ai_properties->load(filename);
+            fprintf(stdout, "AI parameters will be read from %s.\n",
+                    filename.c_str());
+        }
+        else if( !strncmp(argv[i], "--ai-tune=", 10) && argv[i][10])
+        {
+            ai_tuner->setDifficulty(argv[i]+10);
+        }
+        else if( sscanf(argv[i], "--ai-tune-iterations=%d", &n)==1 && n>0)
+        {
+            ai_tuner->setNumIterations(n);
+        }
+        else if( sscanf(argv[i], "--ai-tune-jobs=%d", &n)==1 && n>0)
+        {
+            ai_tuner->setNumJobs(n);
+        }
+        else if( !strncmp(argv[i], "--ai-tune-output=", 17) && argv[i][17])
+        {
+            ai_tuner->setOutput(argv[i]+17);
+        }
+        else if( !strncmp(argv[i], "--telemetry=", 12) && argv[i][12])
+        {
+            telemetry->setFilename(argv[i]+12);
+        }
+        else if( sscanf(argv[i], "--telemetry-rate=%d",  &n)==1 && n>0)
+        {
+            telemetry->setRate((float)n);
+        }
+        else if( sscanf(argv[i], "--seed=%d",  &n)==1)
+        {
+            RandomGenerator::setMasterSeed((unsigned int)n);
+        }
+        else if( !strcmp(argv[i], "--replay-bench") )
+        {
+            history->doReplayHistory(History::HISTORY_PHYSICS);
+            history->setBenchmark(true);
+            user_config->m_no_graphics = true;
+        }
+        else if( !strncmp(argv[i], "--broadphase=", 13) )
+        {
+            int type;
+            for(type=0; type<Physics::BP_COUNT; type++)
+            {
+                if(!strcmp(argv[i]+13,
+                           Physics::getBroadphaseName((Physics::BroadphaseType)type)))
+                    break;
+            }
+            if(type==Physics::BP_COUNT)
+            {
+                fprintf(stderr, "Unknown broadphase '%s'.\n", argv[i]+13);
+                return 0;
+            }
+            user_config->m_broadphase = type;
+        }
+        else if( sscanf(argv[i], "--broadphase-bench=%d",  &n)==1 && n>0)
+        {
+            // The axis sweep supports at most 16384 objects.
+            user_config->m_broadphase_bench = std::min(n, 16000);
+            // Start a profile race, the benchmark is run once the track
+            // is loaded.
+            user_config->m_profile          = -1;
+            user_config->m_no_graphics      = true;
+        }
+        else if( sscanf(argv[i], "--physics-threads=%d", &n)==1 && n>0)
+        {
+            user_config->m_physics_threads = n;
+        }
+        else if( sscanf(argv[i], "--ai-threads=%d", &n)==1 && n>0)
+        {
+            user_config->m_ai_threads = n;
+        }
+        else if( !strcmp(argv[i], "--no-terrain-cache") )
+        {
+            user_config->m_terrain_cache = false;
+        }
+        else if( !strcmp(argv[i], "--no-simulation-lod") )
+        {
+            user_config->m_simulation_lod = false;
+        }
+        else if( !strcmp(argv[i], "--no-bvh-cache") )
+        {
+            user_config->m_bvh_cache = false;
+        }
         else
         {
             fprintf ( stderr, "Invalid parameter: %s.\n\n", argv[i] );
@@ -415,7 +581,8 @@ int handleCmdLine(int argc, char **argv)
             return 0;
         }
     }   // for i <argc
-    if(user_config->m_profile)
+    if(user_config->m_profile || user_config->m_batch_mode ||
+       history->isBenchmark())
     {
         user_config->setSFX(UserConfig::UC_DISABLE);  // Disable sound effects 
         user_config->setMusic(UserConfig::UC_DISABLE);// and music when profiling
@@ -439,6 +606,8 @@ void InitTuxkart()
     // The order here can be important, e.g. KartPropertiesManager needs
     // defaultKartProperties.
     history                 = new History              ();
+    profiler                = new Profiler             ();
+    telemetry               = new Telemetry            ();
     material_manager        = new MaterialManager      ();
     track_manager           = new TrackManager         ();
     stk_config              = new STKConfig            ();
@@ -450,8 +619,23 @@ void InitTuxkart()
     highscore_manager       = new HighscoreManager     ();
     grand_prix_manager      = new GrandPrixManager     ();
     network_manager         = new NetworkManager       ();
+    gp_simulation           = new GPSimulation         ();
+    ai_benchmark            = new AIBenchmark          ();
+    ai_tuner                = new AITuner              ();
+    ai_properties           = new AIProperties         ();
 
     stk_config->load(file_manager->getConfigFile("stk_config.data"));
+    ai_properties->load(file_manager->getConfigFile("ai.data"));
+    // Parameters written by the AI tuner to the config directory replace
+    // the default ones. Since this changes the normal game play, it is
+    // always reported.
+    const std::string user_ai = file_manager->getUserConfigFile("ai.data");
+    if(file_manager->fileExists(user_ai))
+    {
+        ai_properties->load(user_ai);
+        fprintf(stdout, "AI parameters from '%s' replace the default ones.\n",
+                user_ai.c_str());
+    }
     track_manager->loadTrackList();
     // unlock_manager->check needs GP and track manager.
     unlock_manager->check();
@@ -479,6 +663,9 @@ void CleanTuxKart()
     //see InitTuxkart()
     if(menu_manager)            delete menu_manager;
     if(race_manager)            delete race_manager;
+    if(ai_tuner)                delete ai_tuner;
+    if(ai_benchmark)            delete ai_benchmark;
+    if(gp_simulation)           delete gp_simulation;
     if(network_manager)         delete network_manager;
     if(grand_prix_manager)      delete grand_prix_manager;
     if(highscore_manager)       delete highscore_manager;
@@ -488,9 +675,12 @@ void CleanTuxKart()
     if(powerup_manager)         delete powerup_manager;   
     if(projectile_manager)      delete projectile_manager;
     if(kart_properties_manager) delete kart_properties_manager;
+    if(ai_properties)           delete ai_properties;
     if(stk_config)              delete stk_config;
     if(track_manager)           delete track_manager;
     if(material_manager)        delete material_manager;
+    if(telemetry)               delete telemetry;
+    if(profiler)                delete profiler;
     if(history)                 delete history;
     if(sfx_manager)             delete sfx_manager;
     if(sound_manager)           delete sound_manager;
@@ -515,6 +705,10 @@ int main(int argc, char *argv[] )
 
         //handleCmdLine() needs InitTuxkart() so it can't be called first
         if(!handleCmdLine(argc, argv)) exit(0);
+
+        // Start the worker processes of a batch race before the graphics
+        // are initialised (each worker needs its own context)
+        if(BatchRace::getActive()) BatchRace::getActive()->forkWorkers();
         
         if (user_config->m_log_errors) //Enable logging of stdout and stderr to logfile
         {
@@ -568,6 +762,12 @@ int main(int argc, char *argv[] )
             history->Load();
             network_manager->setupPlayerKartInfo();
             race_manager->startNew();
+            if(history->isBenchmark())
+            {
+                // Only measure the replay, not the loading time
+                profiler->setEnabled(true);
+                profiler->reset();
+            }
             main_loop->run();
             // well, actually run() will never return, since
             // it exits after replaying history (see history::GetNextDT()).
@@ -590,7 +790,11 @@ int main(int argc, char *argv[] )
         }
         // Not replaying
         // =============
-        if(!user_config->m_profile)
+        if(BatchRace::getActive())
+        {
+            BatchRace::getActive()->start();
+        }
+        else if(!user_config->m_profile)
         {
             if(user_config->m_no_start_screen)
             {
@@ -610,6 +814,9 @@ int main(int argc, char *argv[] )
             race_manager->setDifficulty(RaceManager::RD_HARD);
             network_manager->setupPlayerKartInfo();
             race_manager->startNew();
+            // Only measure the race, not the loading time
+            profiler->setEnabled(true);
+            profiler->reset();
         }
         main_loop->run();
 
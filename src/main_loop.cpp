@@ -26,11 +26,13 @@
 #include "race_manager.hpp"
 #include "modes/world.hpp"
 #include "user_config.hpp"
+#include "batch_race.hpp"
 #include "history.hpp"
 #include "audio/sound_manager.hpp"
 #include "graphics/scene.hpp"
 #include "gui/menu_manager.hpp"
 #include "network/network_manager.hpp"
+#include "utils/profiler.hpp"
 
 MainLoop* main_loop = 0;
 
@@ -85,8 +87,10 @@ void MainLoop::run()
             if(dt > max_elapsed_time) dt=max_elapsed_time;
                                                
             // Throttle fps if more than maximum, which can reduce 
-            // the noise the fan on a graphics card makes
-            if(dt*user_config->m_max_fps < 1000.0f)
+            // the noise the fan on a graphics card makes. No throttling
+            // if nothing is drawn (e.g. benchmarks).
+            if(!user_config->m_no_graphics &&
+               dt*user_config->m_max_fps < 1000.0f)
             {
                 //SDL_Delay has a granularity of 10ms on most platforms, so
                 //most likely when frames go faster than 125 frames, at times
@@ -121,10 +125,13 @@ void MainLoop::run()
             if(!race_manager->getWorld()->isFinishPhase())
                 network_manager->sendUpdates();
             music_on = false; 
-            if(user_config->m_profile) dt=1.0f/60.0f;
+            if(user_config->m_profile || user_config->m_batch_mode)
+                dt=1.0f/60.0f;
             // In the first call dt might be large (includes loading time),
             // which can cause the camera to significantly tilt
-            scene->draw(RaceManager::getWorld()->getPhase()==SETUP_PHASE ? 0.0f : dt);
+            if(!user_config->m_no_graphics)
+                scene->draw(RaceManager::getWorld()->getPhase()==SETUP_PHASE 
+                            ? 0.0f : dt);
 
             // Again, only receive updates if the race isn't over - once the
             // race results are displayed (i.e. game is in finish phase) 
@@ -135,7 +142,10 @@ void MainLoop::run()
 
             if ( RaceManager::getWorld()->getPhase() != LIMBO_PHASE)
             {
+                profiler->nextFrame();
+                profiler->start(Profiler::PS_HISTORY);
                 history->update(dt);
+                profiler->stop(Profiler::PS_HISTORY);
                 RaceManager::getWorld()->update(dt);
 
                 if(user_config->m_profile>0)
@@ -148,13 +158,20 @@ void MainLoop::run()
                         printf("Number of frames: %d time %f, Average FPS: %f\n",
                                m_frame_count, SDL_GetTicks() * 0.001,
                                (float)m_frame_count/(SDL_GetTicks() * 0.001));
+                        if(profiler->isEnabled())
+                            profiler->printSummary(stdout);
                         if(!history->replayHistory()) history->Save();
                         std::exit(-2);
                     }   // if profile finished
                 }   // if m_profile
+
+                // The world can only be deleted once its update is done
+                BatchRace *batch = BatchRace::getActive();
+                if(batch && batch->isRaceFinished())
+                    batch->startNextRace();
             }   // phase != limbo phase
         }   // if race is active
-        else
+        else if(!user_config->m_no_graphics)
         {
             glMatrixMode(GL_PROJECTION);
             glLoadIdentity();
@@ -201,8 +218,11 @@ void MainLoop::run()
         menu_manager->update();
         sound_manager->update(dt);
 
-        glFlush();
-        SDL_GL_SwapBuffers();
+        if(!user_config->m_no_graphics)
+        {
+            glFlush();
+            SDL_GL_SwapBuffers();
+        }
     }  // while !m_exit
 }   // run
 
@@ -17,9 +17,11 @@
 
 #include "modes/standard_race.hpp"
 
+#include "batch_race.hpp"
 #include "user_config.hpp"
 #include "challenges/unlock_manager.hpp"
 #include "gui/menu_manager.hpp"
+#include "tracks/track.hpp"
 
 //-----------------------------------------------------------------------------
 StandardRace::StandardRace() : LinearWorld()
@@ -71,10 +73,22 @@ void StandardRace::update(float delta)
     LinearWorld::update(delta);
     if(!TimedRace::isRacePhase()) return;
     
-    // All karts are finished
-    if(race_manager->getFinishedKarts() >= race_manager->getNumKarts() )
+    // All karts are finished, or a batch race reached its time limit
+    BatchRace *batch = BatchRace::getActive();
+    if(race_manager->getFinishedKarts() >= race_manager->getNumKarts() ||
+       (batch && getTime() > batch->getTimeLimit(this))                  )
     {
         TimedRace::enterRaceOverState();
+        if(batch)
+        {
+            if(race_manager->getFinishedKarts() < race_manager->getNumKarts())
+                printf("Race on '%s' stopped after %.0f seconds, %d karts "
+                       "did not finish.\n", getTrack()->getIdent().c_str(),
+                       getTime(), race_manager->getNumKarts()
+                                 -race_manager->getFinishedKarts());
+            batch->raceFinished(this);
+            return;
+        }
         if(user_config->m_profile<0) printProfileResultAndExit();
         unlock_manager->raceFinished();
     }   // if all karts are finished
@@ -21,6 +21,7 @@
 
 #include "gui/race_gui.hpp"
 #include "audio/sound_manager.hpp"
+#include "tracks/arena_graph.hpp"
 #include "tracks/track.hpp"
 
 //-----------------------------------------------------------------------------
@@ -31,10 +32,13 @@ ThreeStrikesBattle::ThreeStrikesBattle() : World()
     
     World::init();
     
-    // check for possible problems if AI karts were incorrectly added
-    if(race_manager->getNumKarts() > race_manager->getNumPlayers())
+    // check for possible problems if AI karts were incorrectly added:
+    // the battle AI needs the navigation graph of the arena.
+    const ArenaGraph *graph = m_track->getArenaGraph();
+    if(race_manager->getNumKarts() > race_manager->getNumPlayers() &&
+       (!graph || graph->getNumNodes()==0))
     {
-        fprintf(stderr, "No AI exists for this game mode\n");
+        fprintf(stderr, "No AI exists for this arena\n");
         exit(1);
     }
  
@@ -250,16 +254,26 @@ void ThreeStrikesBattle::moveKartAfterRescue(Kart* kart, btRigidBody* body)
     const int kart_x = (int)(kart->getXYZ()[0]);
     const int kart_y = (int)(kart->getXYZ()[1]);
     
-    for(int n=0; n<start_spots_amount; n++)
+    // The navigation graph stores the nearest start position of each
+    // node, so no search is necessary.
+    const ArenaGraph *graph = m_track->getArenaGraph();
+    if(graph && graph->getNumNodes()>0)
     {
-        // no need for the overhead to compute exact distance with sqrt(), so using the
-        // 'manhattan' heuristic which will do fine enough.
-        const int dist_n = abs((int)(kart_x - RaceManager::getTrack()->m_start_positions[n][0])) +
-                           abs((int)(kart_y - RaceManager::getTrack()->m_start_positions[n][1]));
-        if(dist_n < smallest_distance_found || closest_id_found == -1)
+        closest_id_found = graph->getNearestStart(graph->getNode(kart->getXYZ()));
+    }
+    else
+    {
+        for(int n=0; n<start_spots_amount; n++)
         {
-            closest_id_found = n;
-            smallest_distance_found = dist_n;
+            // no need for the overhead to compute exact distance with sqrt(), so using the
+            // 'manhattan' heuristic which will do fine enough.
+            const int dist_n = abs((int)(kart_x - RaceManager::getTrack()->m_start_positions[n][0])) +
+                               abs((int)(kart_y - RaceManager::getTrack()->m_start_positions[n][1]));
+            if(dist_n < smallest_distance_found || closest_id_found == -1)
+            {
+                closest_id_found = n;
+                smallest_distance_found = dist_n;
+            }
         }
     }
     
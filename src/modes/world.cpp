@@ -26,9 +26,11 @@
 #include "file_manager.hpp"
 #include "race_manager.hpp"
 #include "user_config.hpp"
+#include "stk_config.hpp"
 #include "callback_manager.hpp"
 #include "history.hpp"
 #include "highscore_manager.hpp"
+#include "telemetry.hpp"
 #include "audio/sound_manager.hpp"
 #include "audio/sfx_manager.hpp"
 #include "audio/sfx_base.hpp"
@@ -42,12 +44,16 @@
 #include "karts/player_kart.hpp"
 #include "karts/kart_properties_manager.hpp"
 #include "modes/world.hpp"
+#include "modes/linear_world.hpp"
 #include "network/network_manager.hpp"
 #include "network/race_state.hpp"
+#include "robots/battle_robot.hpp"
 #include "robots/default_robot.hpp"
 #include "tracks/track.hpp"
 #include "tracks/track_manager.hpp"
 #include "utils/constants.hpp"
+#include "utils/profiler.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/translation.hpp"
 
 #if defined(WIN32) && !defined(__CYGWIN__)
@@ -57,12 +63,21 @@
 //-----------------------------------------------------------------------------
 World::World() : TimedRace()
 {
-    m_physics = NULL;
+    m_physics        = NULL;
+    m_ai_thread_pool = NULL;
+    m_ai_think_time  = 0.0f;
+    m_ai_total_time  = 0.0;
+    m_ai_kart_updates= 0;
 }
 void World::init()
 {
     RaceManager::setWorld(this);
-    race_state            = new RaceState();
+    // Restart all random number sequences from the master seed (setWorld
+    // has deleted the previous world, so only this world's generators
+    // are left). All karts etc. created below get the next seeds from
+    // the same sequence, so the race is reproducible.
+    RandomGenerator::generateAllSeeds();
+    RaceState::create();
     m_track               = NULL;
     m_faster_music_active = false;
     m_fastest_lap         = 9999999.9f;
@@ -87,6 +102,7 @@ void World::init()
 
     // Create the physics
     m_physics = new Physics();
+    m_ai_thread_pool = new ThreadPool(user_config->m_ai_threads);
 
     assert(race_manager->getNumKarts() > 0);
 
@@ -95,6 +111,15 @@ void World::init()
     ItemManager::create();
     m_track->loadTrackModel();
 
+    if(user_config->m_broadphase_bench>0)
+    {
+        Vec3 world_min, world_max;
+        m_track->getAABB(&world_min, &world_max);
+        Physics::benchmarkBroadphases(world_min, world_max,
+                                      user_config->m_broadphase_bench);
+        exit(0);
+    }
+
     m_player_karts.resize(race_manager->getNumPlayers());
     m_network_karts.resize(race_manager->getNumPlayers());
     m_local_player_karts.resize(race_manager->getNumLocalPlayers());
@@ -107,18 +132,18 @@ void World::init()
         const std::string& kart_name = race_manager->getKartName(i);
         int local_player_id          = race_manager->getKartLocalPlayerId(i);
         int global_player_id         = race_manager->getKartGlobalPlayerId(i);
-        if(user_config->m_profile)
+        if(user_config->m_profile || user_config->m_batch_mode)
         {
             // Create a camera for the last kart (since this way more of the 
             // karts can be seen.
-            newkart = new DefaultRobot(kart_name, i+1, init_pos, m_track);
+            newkart = loadRobot(kart_name, i+1, init_pos);
             m_local_player_karts[0] = static_cast<PlayerKart*>(newkart);
         }
         else
         {
             newkart = createKart(kart_name, i, local_player_id, 
                                  global_player_id, init_pos);
-        }   // if !user_config->m_profile
+        }   // if !user_config->m_profile && !m_batch_mode
 
         newkart->getModelTransform()->clrTraversalMaskBits(SSGTRAV_ISECT|SSGTRAV_HOT);
         scene->add(newkart->getModelTransform());
@@ -138,6 +163,7 @@ void World::init()
     m_track->startMusic();
 
     if(!history->replayHistory()) history->initRecording();
+    telemetry->startRace(this);
     network_manager->worldLoaded();
 }   // World
 
@@ -185,14 +211,27 @@ Kart *World::createKart(const std::string &kart_ident, int index,
 }   // createKart
 
 //-----------------------------------------------------------------------------
+/** Creates an AI kart. On race tracks the class of the AI is selected by
+ *  the robot type of the race manager (a random type if RT_RANDOM is used).
+ *  New AI classes are added to RaceManager::RobotType and here.
+ *  \param kart_name Ident of the kart.
+ *  \param position Start position of the kart.
+ *  \param init_pos The start coordinates.
+ */
 Kart* World::loadRobot(const std::string& kart_name, int position,
                        const btTransform& init_pos)
 {
     Kart* currentRobot;
-    const int NUM_ROBOTS = 1;
-    switch(m_random.get(NUM_ROBOTS))
+    // Arenas have no driveline, the battle AI uses their navigation graph.
+    if(m_track->isArena())
+        return new BattleRobot(kart_name, position, init_pos, m_track);
+
+    RaceManager::RobotType type = race_manager->getRobotType();
+    if(type==RaceManager::RT_RANDOM)
+        type = (RaceManager::RobotType)m_random.get(RaceManager::RT_COUNT);
+    switch(type)
     {
-        case 0:
+        case RaceManager::RT_DEFAULT:
             currentRobot = new DefaultRobot(kart_name, position, init_pos, m_track);
             break;
         default:
@@ -206,8 +245,9 @@ Kart* World::loadRobot(const std::string& kart_name, int position,
 //-----------------------------------------------------------------------------
 World::~World()
 {
+    telemetry->endRace();
     // Items are deleted in track cleanup.
-    delete race_state;
+    RaceState::destroy();
     // In case that a race is aborted (e.g. track not found) m_track is 0.
     if(m_track)
         m_track->cleanup();
@@ -223,6 +263,7 @@ World::~World()
     // In case that the track is not found, m_physics is still undefined.
     if(m_physics)
         delete m_physics;
+    delete m_ai_thread_pool;
 
     sound_manager->stopMusic();
 
@@ -335,27 +376,190 @@ void World::update(float dt)
     if(history->replayHistory()) dt=history->getNextDelta();
     TimedRace::update(dt);
     // Clear race state so that new information can be stored
-    race_state->clear();
+    RaceState::get()->clear();
+
+    updateSimulationLevels();
 
     if(network_manager->getMode()!=NetworkManager::NW_CLIENT &&
       !history->dontDoPhysics())
     {
+        profiler->start(Profiler::PS_PHYSICS);
         m_physics->update(dt);
+        profiler->stop(Profiler::PS_PHYSICS);
+        profiler->collectBulletProfile();
     }
 
+    profiler->start(Profiler::PS_AI);
+    unsigned long ai_start = m_ai_clock.getTimeMicroseconds();
+    updateAI(dt);
+    m_ai_total_time += m_ai_clock.getTimeMicroseconds()-ai_start;
+    profiler->stop(Profiler::PS_AI);
+
+    profiler->start(Profiler::PS_KARTS);
     const int kart_amount = m_kart.size();
     for (int i = 0 ; i < kart_amount; ++i)
     {
         // Update all karts that are not eliminated
         if(!m_kart[i]->isEliminated()) m_kart[i]->update(dt) ;
     }
+    profiler->stop(Profiler::PS_KARTS);
 
+    profiler->start(Profiler::PS_PROJECTILES);
     projectile_manager->update(dt);
+    profiler->stop(Profiler::PS_PROJECTILES);
+
+    profiler->start(Profiler::PS_ITEMS);
     ItemManager::get()->update(dt);
+    profiler->stop(Profiler::PS_ITEMS);
 
     /* Routine stuff we do even when paused */
+    profiler->start(Profiler::PS_CALLBACKS);
     callback_manager->update(dt);
+    profiler->stop(Profiler::PS_CALLBACKS);
+
+    telemetry->update(this, dt);
 }
+// ----------------------------------------------------------------------------
+/** Used to sort the AI karts which are due to think: the kart that waited
+ *  the longest comes first.
+ */
+static bool waitedLonger(const AutoKart *a, const AutoKart *b)
+{
+    return a->getTimeSinceThink() > b->getTimeSinceThink();
+}   // waitedLonger
+
+// ----------------------------------------------------------------------------
+/** Computes the controls of all AI karts that need new controls in this
+ *  frame. Since the AI only reads the state of the world, all karts are
+ *  computed in parallel (if more than one AI thread is used). The controls
+ *  are used when the karts are updated afterwards.
+ *  Karts in an urgent situation always think. Of the other karts only as
+ *  many think as fit into the AI time budget (based on the average time
+ *  a kart needed to think so far), the others are postponed to the next
+ *  frame. Since the budget depends on the measured time, it is not used
+ *  when profiling, in batch races (e.g. the GP simulation) or when
+ *  replaying a history file, so that these results are reproducible.
+ *  \param dt Time step.
+ */
+void World::updateAI(float dt)
+{
+    // Take a snapshot of all karts, which is used by all AI karts.
+    m_ai_world_view.update(m_kart, dynamic_cast<const LinearWorld*>(this));
+
+    m_thinking_karts.clear();
+    m_due_karts.clear();
+    for(unsigned int i=0; i<m_kart.size(); i++)
+    {
+        if(m_kart[i]->isEliminated() || m_kart[i]->isPlayerKart()) continue;
+        AutoKart *kart = dynamic_cast<AutoKart*>(m_kart[i]);
+        if(!kart) continue;
+        m_ai_kart_updates++;
+        switch(kart->needsThink(dt))
+        {
+        case AutoKart::TR_URGENT: m_thinking_karts.push_back(kart); break;
+        case AutoKart::TR_DUE:    m_due_karts.push_back(kart);      break;
+        default:                  break;
+        }
+    }
+
+    unsigned int max_due = (unsigned int)m_due_karts.size();
+    if(stk_config->m_ai_time_budget>0 && m_ai_think_time>0 &&
+       !user_config->m_profile && !user_config->m_batch_mode &&
+       !history->replayHistory())
+    {
+        float n = stk_config->m_ai_time_budget/m_ai_think_time
+                * m_ai_thread_pool->getNumThreads() - m_thinking_karts.size();
+        // Always let at least one kart think, otherwise a kart could
+        // be postponed forever.
+        max_due = n<1.0f ? 1 : (unsigned int)std::min(n, (float)max_due);
+    }
+    if(max_due<m_due_karts.size())
+    {
+        std::stable_sort(m_due_karts.begin(), m_due_karts.end(),
+                         waitedLonger);
+        m_due_karts.resize(max_due);
+    }
+    m_thinking_karts.insert(m_thinking_karts.end(), m_due_karts.begin(),
+                            m_due_karts.end());
+    if(m_thinking_karts.size()==0) return;
+
+    unsigned long start = m_ai_clock.getTimeMicroseconds();
+    m_crash_predictor.update(m_ai_world_view, m_track);
+    ItemManager::get()->updateAIItems();
+    m_ai_thread_pool->run(&World::thinkJob, this,
+                          (int)m_thinking_karts.size());
+    // Update the running average of the (thread) time for one kart.
+    float t = (m_ai_clock.getTimeMicroseconds()-start)*0.000001f
+            * m_ai_thread_pool->getNumThreads() / m_thinking_karts.size();
+    m_ai_think_time = m_ai_think_time>0 ? 0.9f*m_ai_think_time + 0.1f*t
+                                        : t;
+}   // updateAI
+
+// ----------------------------------------------------------------------------
+/** Computes the AI of one kart, called from the AI threads.
+ */
+void World::thinkJob(void *data, int job, int thread)
+{
+    World *world = (World*)data;
+    world->m_thinking_karts[job]->think();
+}   // thinkJob
+
+// ----------------------------------------------------------------------------
+/** Sets the simulation level of detail of all AI karts depending on the
+ *  distance to the nearest player kart (local or remote): far away karts
+ *  update their AI less often, and karts even further away are moved along
+ *  the driveline without physics. This is disabled when profiling and in
+ *  batch races (all karts are AI karts, and the results must be
+ *  comparable), when replaying a history file, and on network clients (the server does all AI and physics).
+ */
+void World::updateSimulationLevels()
+{
+    if(!user_config->m_simulation_lod || user_config->m_profile ||
+       user_config->m_batch_mode ||
+       m_player_karts.size()==0 || history->replayHistory() ||
+       network_manager->getMode()==NetworkManager::NW_CLIENT)
+        return;
+
+    const float h = stk_config->m_lod_hysteresis;
+    const float reduced   = stk_config->m_lod_reduced_distance;
+    const float kinematic = stk_config->m_lod_kinematic_distance;
+    const unsigned int kart_amount = m_kart.size();
+    for(unsigned int i=0; i<kart_amount; i++)
+    {
+        Kart *kart = m_kart[i];
+        if(kart->isEliminated()) continue;
+        float min_dist2  = -1.0f;
+        bool  is_player  = false;
+        for(unsigned int j=0; j<m_player_karts.size(); j++)
+        {
+            const Kart *player = m_player_karts[j];
+            if(player==kart) 
+            {
+                is_player = true;
+                break;
+            }
+            if(player->isEliminated()) continue;
+            float dist2 = (player->getXYZ()-kart->getXYZ()).length2();
+            if(min_dist2<0 || dist2<min_dist2) min_dist2 = dist2;
+        }
+        if(is_player || min_dist2<0) continue;
+        const float d = sqrt(min_dist2);
+
+        // Use a hysteresis, so that a kart close to one of the distances
+        // doesn't switch levels all the time.
+        Kart::SimulationLevel level = kart->getSimulationLevel();
+        if(d < reduced-h)
+            level = Kart::SL_FULL;
+        else if(d > reduced+h && level==Kart::SL_FULL)
+            level = Kart::SL_REDUCED;
+        if(d > kinematic+h)
+            level = Kart::SL_KINEMATIC;
+        else if(d < kinematic-h && level==Kart::SL_KINEMATIC)
+            level = Kart::SL_REDUCED;
+        kart->setSimulationLevel(level);
+    }   // for i<kart_amount
+}   // updateSimulationLevels
+
 // ----------------------------------------------------------------------------
 
 HighscoreEntry* World::getHighscores() const
@@ -454,6 +658,7 @@ void World::printProfileResultAndExit()
             m_kart[i]->getFinishTime());
     } 
     printf("min %f  max %f  av %f\n",min_t, max_t, av_t/m_kart.size());
+    if(profiler->isEnabled()) profiler->printSummary(stdout);
     std::exit(-2);
 }   // printProfileResultAndExit
 
@@ -523,6 +728,9 @@ void World::restartRace()
     }
     
     resetAllKarts();
+    m_crash_predictor.reset();
+    m_ai_total_time   = 0.0;
+    m_ai_kart_updates = 0;
     
     // Start music from beginning
     sound_manager->stopMusic();
@@ -23,6 +23,7 @@
 #include <vector>
 #define _WINSOCKAPI_
 #include <plib/ssg.h>
+#include "LinearMath/btQuickprof.h"
 
 #include "highscores.hpp"
 #include "karts/kart.hpp"
@@ -30,12 +31,16 @@
 #include "physics/physics.hpp"
 #include "modes/clock.hpp"
 #include "network/network_kart.hpp"
+#include "robots/ai_world_view.hpp"
+#include "robots/crash_predictor.hpp"
 #include "utils/random_generator.hpp"
 
+class AutoKart;
 class SFXBase;
 struct KartIconDisplayInfo;
 class RaceGUI;
 class btRigidBody;
+class ThreadPool;
 class Track;
 
 /** This class is responsible for running the actual race. A world is created
@@ -91,6 +96,24 @@ protected:
 
     Karts       m_kart;
     Physics*    m_physics;
+    /** The threads used to compute the AI. */
+    ThreadPool* m_ai_thread_pool;
+    /** The AI karts that compute new controls in the current frame. */
+    std::vector<AutoKart*> m_thinking_karts;
+    /** The AI karts that are due to think, but not urgent. */
+    std::vector<AutoKart*> m_due_karts;
+    /** Average time one AI kart needs to think, used for the AI budget. */
+    float       m_ai_think_time;
+    btClock     m_ai_clock;
+    /** Total time spent in the AI in this race (in microseconds), and
+     *  the number of AI kart updates in this time. */
+    double      m_ai_total_time;
+    int         m_ai_kart_updates;
+    /** The state of all karts as seen by the AI, updated before the AI
+     *  karts think. */
+    AIWorldView m_ai_world_view;
+    /** Predicts crashes of the AI karts, updated before the AI thinks. */
+    CrashPredictor m_crash_predictor;
     float       m_fastest_lap;
     Kart*       m_fastest_kart;
     Phase       m_previous_phase;      // used during the race popup menu
@@ -110,6 +133,9 @@ protected:
     Kart* loadRobot         (const std::string& kart_name, int position,
                              const btTransform& init_pos);
     void  printProfileResultAndExit();
+    void  updateSimulationLevels();
+    void  updateAI          (float dt);
+    static void thinkJob    (void *data, int job, int thread);
     virtual float estimateFinishTimeForKart(Kart *kart) {return getTime();}
 
     virtual Kart *createKart(const std::string &kart_ident, int index, 
@@ -147,6 +173,14 @@ public:
                                                             m_eliminated_players;            }
     
     Physics *getPhysics() const               { return m_physics;                   }
+    const AIWorldView &getAIWorldView() const { return m_ai_world_view;             }
+    CrashPredictor *getCrashPredictor()       { return &m_crash_predictor;          }
+    const CrashPredictor *getCrashPredictor() const
+                                              { return &m_crash_predictor;          }
+    /** Returns the time spent in the AI in this race in microseconds. */
+    double getAITotalTime() const             { return m_ai_total_time;             }
+    /** Returns the number of AI kart updates in this race. */
+    int    getAIKartUpdates() const           { return m_ai_kart_updates;           }
     Track *getTrack() const                   { return m_track;                     }
     Kart* getFastestKart() const              { return m_fastest_kart;              }
     float getFastestLapTime() const           { return m_fastest_lap;               }
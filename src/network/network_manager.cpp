@@ -585,8 +585,8 @@ void NetworkManager::sendUpdates()
 {
     if(m_mode==NW_SERVER)
     {
-        race_state->serialise();
-        broadcastToClients(*race_state);
+        RaceState::get()->serialise();
+        broadcastToClients(*RaceState::get());
     }
     else if(m_mode==NW_CLIENT)
     {
@@ -642,7 +642,7 @@ void NetworkManager::receiveUpdates()
                 race_manager->getWorld()->enterRaceOverState();
                 return;
             }
-            race_state->receive(event.packet);
+            RaceState::get()->receive(event.packet);
         }
     }   // for i<num_messages
     if(!correct)
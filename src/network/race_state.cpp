@@ -23,7 +23,7 @@
 #include "items/item_manager.hpp"
 #include "items/projectile_manager.hpp"
 
-RaceState *race_state=NULL;
+RaceState *RaceState::m_race_state = NULL;
 
 // ----------------------------------------------------------------------------
 void RaceState::serialise()
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "race_manager.hpp"
+#include "telemetry.hpp"
 #include "karts/kart.hpp"
 #include "karts/kart_control.hpp"
 #include "items/flyable.hpp"
@@ -39,6 +40,8 @@
 class RaceState : public Message
 {
 private:
+    /** The race state of the current race. */
+    static RaceState *m_race_state;
 
     /** Updates about collected items. */
     std::vector<ItemInfo> m_item_info;
@@ -57,6 +60,19 @@ private:
             m_kart_controls.resize(race_manager->getNumKarts());
         }   // RaceState()
         // --------------------------------------------------------------------
+        /** Returns the race state of the current race. */
+        static RaceState *get()          { return m_race_state;            }
+        // --------------------------------------------------------------------
+        /** Creates the race state for a new race. */
+        static void       create()       { m_race_state = new RaceState(); }
+        // --------------------------------------------------------------------
+        /** Deletes the race state at the end of a race. */
+        static void destroy()
+        {
+            delete m_race_state;
+            m_race_state = NULL;
+        }   // destroy
+        // --------------------------------------------------------------------
         void itemCollected(int kartid, int item_id, char add_info=-1)
         {
             m_item_info.push_back(ItemInfo(kartid, item_id, add_info));
@@ -77,6 +93,7 @@ private:
         {
             m_collision_info.push_back(kartId1);
             m_collision_info.push_back(kartId2);
+            telemetry->addEvent(Telemetry::EV_COLLISION, kartId1, kartId2);
         }   // addCollision
         // --------------------------------------------------------------------
         void setNumFlyables(int n) { m_flyable_info.resize(n); }
@@ -103,7 +120,5 @@ private:
                     &getFlyable(unsigned int i) const {return m_flyable_info[i];}
     };   // RaceState
 
-extern RaceState *race_state;
-
 #endif
 
@@ -33,6 +33,8 @@ btKart::btKart(const btVehicleTuning& tuning,btRigidBody* chassis,
     m_zipper_active = false;
     m_zipper_velocity = btScalar(0);
     m_num_wheels_on_ground = 0;
+    m_ray_results = NULL;
+    m_ray_objects = NULL;
 }
 
 // ----------------------------------------------------------------------------
@@ -41,13 +43,52 @@ btKart::~btKart()
 }
 
 // ----------------------------------------------------------------------------
-btScalar btKart::rayCast(btWheelInfo& wheel)
+/** Returns the length of the suspension ray of a wheel.
+ */
+btScalar btKart::getRayLength(const btWheelInfo& wheel)
+{
+    return wheel.getSuspensionRestLength()+wheel.m_wheelsRadius+
+           wheel.m_maxSuspensionTravelCm*0.01f;
+}
+
+// ----------------------------------------------------------------------------
+/** Computes the suspension rays of all wheels, so that the rays of all karts
+ *  can be cast in one batch.
+ *  \param from, to Start and end points of the rays (one per wheel).
+ */
+void btKart::getWheelRays(btVector3 *from, btVector3 *to)
+{
+    for(int i=0; i<m_wheelInfo.size(); i++)
+    {
+        btWheelInfo &wheel = m_wheelInfo[i];
+        updateWheelTransformsWS(wheel, false);
+        from[i] = wheel.m_raycastInfo.m_hardPointWS;
+        to[i]   = from[i] + wheel.m_raycastInfo.m_wheelDirectionWS
+                          * getRayLength(wheel);
+    }
+}
+
+// ----------------------------------------------------------------------------
+/** Sets the results of the batched wheel raycasts, which are then used in
+ *  the next updateVehicle call instead of casting the rays individually.
+ *  \param results, objects Results for each wheel, or NULL to cast the rays
+ *         individually.
+ */
+void btKart::setWheelRayResults(const btVehicleRaycaster::btVehicleRaycasterResult *results,
+                                void *const *objects)
 {
+    m_ray_results = results;
+    m_ray_objects = objects;
+}
+
+// ----------------------------------------------------------------------------
+btScalar btKart::rayCast(int wheel_index)
+{
+    btWheelInfo &wheel = m_wheelInfo[wheel_index];
     updateWheelTransformsWS( wheel,false);
     
     btScalar depth          = -1;
-    btScalar raylen         = wheel.getSuspensionRestLength()+wheel.m_wheelsRadius+
-                                 wheel.m_maxSuspensionTravelCm*0.01f;
+    btScalar raylen         = getRayLength(wheel);
     
     btVector3 rayvector     = wheel.m_raycastInfo.m_wheelDirectionWS * (raylen);
     const btVector3& source = wheel.m_raycastInfo.m_hardPointWS;
@@ -57,10 +98,17 @@ btScalar btKart::rayCast(btWheelInfo& wheel)
     btScalar param = btScalar(0.);
     
     btVehicleRaycaster::btVehicleRaycasterResult    rayResults;
-    
-    assert(m_vehicleRaycaster);
-    
-    void* object            = m_vehicleRaycaster->castRay(source,target,rayResults);
+    void* object;
+    if(m_ray_results)
+    {
+        rayResults = m_ray_results[wheel_index];
+        object     = m_ray_objects[wheel_index];
+    }
+    else
+    {
+        assert(m_vehicleRaycaster);
+        object = m_vehicleRaycaster->castRay(source,target,rayResults);
+    }
     
     wheel.m_raycastInfo.m_groundObject = 0;
     
@@ -413,7 +461,7 @@ void btKart::updateVehicle(btScalar step)
     for(i=0;i<m_wheelInfo.size();i++)
     {
         btScalar depth; 
-        depth = rayCast( m_wheelInfo[i]);
+        depth = rayCast(i);
 
         if (m_wheelInfo[i].m_raycastInfo.m_isInContact)
             m_num_wheels_on_ground++;
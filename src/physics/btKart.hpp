@@ -27,15 +27,24 @@ class btKart : public btRaycastVehicle
     btScalar     m_skidding_factor;
     bool         m_zipper_active;
     btScalar     m_zipper_velocity;
+    /** Results of the batched wheel raycasts (see
+     *  STKDynamicsWorld::updateVehicles), or NULL if each wheel casts
+     *  its own ray. */
+    const btVehicleRaycaster::btVehicleRaycasterResult *m_ray_results;
+    void *const *m_ray_objects;
+    static btScalar getRayLength(const btWheelInfo& wheel);
 public:
                  btKart(const btVehicleTuning& tuning,btRigidBody* chassis,    
                         btVehicleRaycaster* raycaster, float track_connect_accel );
     virtual     ~btKart() ;
-    btScalar     rayCast(btWheelInfo& wheel);
+    btScalar     rayCast(int wheel_index);
     btScalar     rayCast(btWheelInfo& wheel, const btVector3& ray);
     bool         projectVehicleToSurface(const btVector3& ray, bool translate_vehicle);
     void         setSkidding(btScalar sf)     { m_skidding_factor = sf; }
     virtual void updateVehicle(btScalar step);
+    void         getWheelRays(btVector3 *from, btVector3 *to);
+    void         setWheelRayResults(const btVehicleRaycaster::btVehicleRaycasterResult *results,
+                                    void *const *objects);
     void         resetSuspension();
     int          getNumWheelsOnGround() const { return m_num_wheels_on_ground; }
     void         setRaycastWheelInfo(int wheelIndex , bool isInContact, 
@@ -19,12 +19,20 @@
 
 #include "physics/physics.hpp"
 
+#include <algorithm>
+#include <vector>
+
+#include "LinearMath/btQuickprof.h"
+
 #include "user_config.hpp"
 #include "network/race_state.hpp"
 #include "physics/btKart.hpp"
 #include "physics/btUprightConstraint.hpp"
+#include "physics/stk_dynamics_world.hpp"
 #include "tracks/track.hpp"
+#include "utils/random_generator.hpp"
 #include "utils/ssg_help.hpp"
+#include "utils/thread_pool.hpp"
 
 // ----------------------------------------------------------------------------
 /** Initialise physics.
@@ -34,6 +42,8 @@ Physics::Physics() : btSequentialImpulseConstraintSolver()
 {
     m_collision_conf = new btDefaultCollisionConfiguration();
     m_dispatcher     = new btCollisionDispatcher(m_collision_conf);
+    m_thread_pool    = NULL;
+    m_solver_seed    = 0;
 }   // Physics
 
 //-----------------------------------------------------------------------------
@@ -43,13 +53,21 @@ Physics::Physics() : btSequentialImpulseConstraintSolver()
  */
 void Physics::init(const Vec3 &world_min, const Vec3 &world_max)
 {
-    m_axis_sweep     = new btAxisSweep3(world_min, world_max);
-    m_dynamics_world = new btDiscreteDynamicsWorld(m_dispatcher, 
-                                                   m_axis_sweep, 
-                                                   this,
-                                                   m_collision_conf);
+    m_broadphase     = createBroadphase((BroadphaseType)user_config->m_broadphase,
+                                        world_min, world_max);
+    m_dynamics_world = new STKDynamicsWorld(m_dispatcher, 
+                                            m_broadphase, 
+                                            this,
+                                            m_collision_conf);
     m_dynamics_world->setGravity(btVector3(0.0f, 0.0f, 
                                            -RaceManager::getTrack()->getGravity()));
+
+    // The islands are solved by a separate solver per thread, since the
+    // solvers store temporary data while solving.
+    m_thread_pool = new ThreadPool(user_config->m_physics_threads);
+    m_thread_data.resize(m_thread_pool->getNumThreads());
+    for(unsigned int i=0; i<m_thread_data.size(); i++)
+        m_thread_data[i].m_solver = new btSequentialImpulseConstraintSolver();
 #ifdef HAVE_GLUT
     if(user_config->m_bullet_debug)
       {
@@ -67,11 +85,150 @@ Physics::~Physics()
     if(user_config->m_bullet_debug) delete m_debug_drawer;
 #endif
     delete m_dynamics_world;
-    delete m_axis_sweep;
+    delete m_thread_pool;
+    for(unsigned int i=0; i<m_thread_data.size(); i++)
+        delete m_thread_data[i].m_solver;
+    delete m_broadphase;
     delete m_dispatcher;
     delete m_collision_conf;
 }   // ~Physics
 
+//-----------------------------------------------------------------------------
+/** Creates a bullet broadphase.
+ *  \param type The type of the broadphase.
+ *  \param world_min, world_max The size of the world (only used by the axis
+ *         sweep, objects outside of this area are not handled correctly).
+ */
+btBroadphaseInterface *Physics::createBroadphase(BroadphaseType type,
+                                                 const Vec3 &world_min,
+                                                 const Vec3 &world_max)
+{
+    switch(type)
+    {
+    case BP_AABB_TREE: return new btAabbTreeBroadphase();
+    case BP_AXIS_SWEEP:
+    default:           return new btAxisSweep3(world_min, world_max);
+    }
+}   // createBroadphase
+
+//-----------------------------------------------------------------------------
+/** Returns the name of a broadphase type, as used for the --broadphase
+ *  command line option.
+ */
+const char *Physics::getBroadphaseName(BroadphaseType type)
+{
+    switch(type)
+    {
+    case BP_AABB_TREE:  return "aabb-tree";
+    case BP_AXIS_SWEEP: return "axis-sweep";
+    default:            return "unknown";
+    }
+}   // getBroadphaseName
+
+//-----------------------------------------------------------------------------
+/** Compares the speed of all broadphase algorithms and prints the results.
+ *  The track is represented by one static object covering the whole world
+ *  (like the track mesh), and num_objects small objects (like karts, items
+ *  and projectiles) are moving through the world at kart speeds. Each
+ *  broadphase gets exactly the same input.
+ *  \param world_min, world_max The size of the world (track).
+ *  \param num_objects Number of moving objects.
+ */
+void Physics::benchmarkBroadphases(const Vec3 &world_min,
+                                   const Vec3 &world_max, int num_objects)
+{
+    const int   num_steps = 600;
+    const float dt        = 1.0f/60.0f;
+    const Vec3  extend(1.0f, 1.0f, 1.0f);
+
+    printf("Broadphase benchmark: %d objects, %d steps.\n",
+           num_objects, num_steps);
+    printf("%-12s %10s %14s %10s %10s\n", "broadphase", "create[ms]",
+           "update[us/step]", "destroy[ms]", "avg pairs");
+    for(int type=0; type<BP_COUNT; type++)
+    {
+        // Use the same start positions and velocities for each broadphase
+        RandomGenerator random;
+        random.seed(1);
+        // btVector3 is used, since Vec3 has no non-const operator[].
+        std::vector<btVector3> xyz(num_objects), velocity(num_objects);
+        const Vec3 size = world_max - world_min;
+        for(int i=0; i<num_objects; i++)
+        {
+            xyz[i] = world_min + Vec3(random.getFloat()*size.getX(),
+                                      random.getFloat()*size.getY(),
+                                      random.getFloat()*size.getZ());
+            velocity[i] = Vec3((random.getFloat()-0.5f)*60.0f,
+                               (random.getFloat()-0.5f)*60.0f,
+                               (random.getFloat()-0.5f)* 4.0f);
+        }
+
+        btBroadphaseInterface *broadphase =
+            createBroadphase((BroadphaseType)type, world_min-extend,
+                             world_max+extend);
+        std::vector<btBroadphaseProxy*> proxies(num_objects);
+        btClock clock;
+
+        // The static track, which overlaps all other objects.
+        btBroadphaseProxy *track =
+            broadphase->createProxy(world_min, world_max, 0, NULL,
+                                    btBroadphaseProxy::StaticFilter,
+                                    btBroadphaseProxy::AllFilter
+                                   ^btBroadphaseProxy::StaticFilter,
+                                    NULL, NULL);
+        for(int i=0; i<num_objects; i++)
+        {
+            proxies[i] = broadphase->createProxy(xyz[i]-extend, xyz[i]+extend,
+                                                 0, NULL,
+                                                 btBroadphaseProxy::DefaultFilter,
+                                                 btBroadphaseProxy::AllFilter,
+                                                 NULL, NULL);
+        }
+        broadphase->calculateOverlappingPairs(NULL);
+        unsigned long create_time = clock.getTimeMicroseconds();
+
+        unsigned long update_time = 0;
+        double        num_pairs   = 0;
+        for(int step=0; step<num_steps; step++)
+        {
+            // Moving the objects is not timed.
+            for(int i=0; i<num_objects; i++)
+            {
+                xyz[i] += velocity[i]*dt;
+                for(int j=0; j<3; j++)
+                {
+                    if(xyz[i][j]<world_min[j] || xyz[i][j]>world_max[j])
+                    {
+                        velocity[i][j] = -velocity[i][j];
+                        xyz[i][j]      = btMax(world_min[j],
+                                               btMin(world_max[j], xyz[i][j]));
+                    }
+                }
+            }
+            clock.reset();
+            for(int i=0; i<num_objects; i++)
+                broadphase->setAabb(proxies[i], xyz[i]-extend, xyz[i]+extend,
+                                    NULL);
+            broadphase->calculateOverlappingPairs(NULL);
+            update_time += clock.getTimeMicroseconds();
+            num_pairs   += broadphase->getOverlappingPairCache()
+                                     ->getNumOverlappingPairs();
+        }   // for step<num_steps
+
+        clock.reset();
+        for(int i=0; i<num_objects; i++)
+            broadphase->destroyProxy(proxies[i], NULL);
+        broadphase->destroyProxy(track, NULL);
+        unsigned long destroy_time = clock.getTimeMicroseconds();
+        delete broadphase;
+
+        printf("%-12s %10.2f %14.2f %10.2f %10.1f\n",
+               getBroadphaseName((BroadphaseType)type), create_time*0.001f,
+               (float)update_time/num_steps, destroy_time*0.001f,
+               num_pairs/num_steps);
+    }   // for type<BP_COUNT
+}   // benchmarkBroadphases
+
 // -----------------------------------------------------------------------------
 /** Adds a kart to the physics engine.
  *  This adds the rigid body, the vehicle, and the upright constraint.
@@ -106,51 +263,58 @@ void Physics::update(float dt)
     // Bullet can report the same collision more than once (up to 4
     // contact points per collision. Additionally, more than one internal
     // substep might be taken, resulting in potentially even more
-    // duplicates. To handle this, all collisions (i.e. pair of objects)
-    // are stored in a vector, but only one entry per collision pair
-    // of objects.
-    m_all_collisions.clear();
+    // duplicates. To handle this, each collision pair is only added
+    // once per update to the event queues.
+    m_collision_pairs.clear();
+    m_kart_track_collisions.clear();
+    m_kart_kart_collisions.clear();
+    m_flyable_collisions.clear();
 
     // Maximum of three substeps. This will work for framerate down to
     // 20 FPS (bullet default frequency is 60 HZ).
     m_dynamics_world->stepSimulation(dt, 3);
 
-    // Now handle the actual collision. Note: rockets can not be removed
+    for(unsigned int i=0; i<m_kart_track_collisions.size(); i++)
+    {
+        Kart *kart = m_kart_track_collisions[i];
+        RaceState::get()->addCollision(kart->getWorldKartId());
+        kart->crashed(NULL);   // Kart hit track
+    }
+
+    for(unsigned int i=0; i<m_kart_kart_collisions.size(); i++)
+    {
+        Kart *a = m_kart_kart_collisions[i].a->getPointerKart();
+        Kart *b = m_kart_kart_collisions[i].b->getPointerKart();
+        RaceState::get()->addCollision(a->getWorldKartId(),
+                                       b->getWorldKartId());
+        KartKartCollision(a, b);
+    }
+
+    // Now handle the projectile hits. Note: rockets can not be removed
     // inside of this loop, since the same rocket might hit more than one
     // other object. So, only a flag is set in the rockets, the actual
     // clean up is then done later in the projectile manager.
-    std::vector<CollisionPair>::iterator p;
-    for(p=m_all_collisions.begin(); p!=m_all_collisions.end(); ++p)
+    for(unsigned int i=0; i<m_flyable_collisions.size(); i++)
     {
-        if(p->a->is(UserPointer::UP_KART)) {          // kart-kart collision
-            Kart *a=p->a->getPointerKart();
-            Kart *b=p->b->getPointerKart();
-            race_state->addCollision(a->getWorldKartId(),
-                                     b->getWorldKartId());
-            KartKartCollision(p->a->getPointerKart(), p->b->getPointerKart());
-        }  // if kart-kart collision
-        else  // now the first object must be a projectile
+        const CollisionPair &p = m_flyable_collisions[i];
+        if(p.b->is(UserPointer::UP_TRACK))              // projectile hit track
         {
-            if(p->b->is(UserPointer::UP_TRACK))       // must be projectile hit track
-            {
-                p->a->getPointerFlyable()->hitTrack();
-            }
-            else if(p->b->is(UserPointer::UP_MOVING_PHYSICS))
-            {
-                p->a->getPointerFlyable()->hit(NULL, p->b->getPointerMovingPhysics());
-
-            }
-            else if(p->b->is(UserPointer::UP_KART))   // projectile hit kart
-            {
-                p->a->getPointerFlyable()->hit(p->b->getPointerKart());
-            }
-            else                                     // projectile hits projectile
-            {
-                p->a->getPointerFlyable()->hit(NULL);
-                p->b->getPointerFlyable()->hit(NULL);
-            }
+            p.a->getPointerFlyable()->hitTrack();
+        }
+        else if(p.b->is(UserPointer::UP_MOVING_PHYSICS))
+        {
+            p.a->getPointerFlyable()->hit(NULL, p.b->getPointerMovingPhysics());
+        }
+        else if(p.b->is(UserPointer::UP_KART))          // projectile hit kart
+        {
+            p.a->getPointerFlyable()->hit(p.b->getPointerKart());
         }
-    }  // for all p in m_all_collisions
+        else                                            // projectile hits projectile
+        {
+            p.a->getPointerFlyable()->hit(NULL);
+            p.b->getPointerFlyable()->hit(NULL);
+        }
+    }  // for i<m_flyable_collisions.size()
 }   // update
 
 //-----------------------------------------------------------------------------
@@ -204,14 +368,21 @@ void Physics::KartKartCollision(Kart *kartA, Kart *kartB)
 }   // KartKartCollision
 
 //-----------------------------------------------------------------------------
-/** This function is called at each internal bullet timestep. It is used
- *  here to do the collision handling: using the contact manifolds after a
- *  physics time step might miss some collisions (when more than one internal
- *  time step was done, and the collision is added and removed). So this
- *  function stores all collisions in a list, which is then handled after the
- *  actual physics timestep. This list only stores a collision, if it's not
- *  already in the list, so a collisions which is reported more than once is
- *  nevertheless only handled once.
+/** Called by bullet at each internal timestep before the islands are solved.
+ *  Parameters: see bullet documentation for details.
+ */
+void Physics::prepareSolve(int numBodies, int numManifolds)
+{
+    m_islands.clear();
+    m_island_bodies.clear();
+    m_island_manifolds.clear();
+    m_solver_seed++;
+}   // prepareSolve
+
+//-----------------------------------------------------------------------------
+/** Called by bullet for each simulation island (i.e. group of objects that
+ *  can only influence each other). The islands are independent, so they are
+ *  only stored here, and then solved in parallel in allSolved().
  *  Parameters: see bullet documentation for details.
  */
 btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
@@ -219,88 +390,208 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
                              btTypedConstraint** constraints,int numConstraints,
                              const btContactSolverInfo& info, 
                              btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc,
-                             btDispatcher* dispatcher) {
-    btScalar returnValue=
-        btSequentialImpulseConstraintSolver::solveGroup(bodies, numBodies, manifold, 
-                                                        numManifolds, constraints, 
-                                                        numConstraints, info, 
-                                                        debugDrawer, stackAlloc,
-                                                        dispatcher);
-    int currentNumManifolds = m_dispatcher->getNumManifolds();
-    // We can't explode a rocket in a loop, since a rocket might collide with 
-    // more than one object, and/or more than once with each object (if there 
-    // is more than one collision point). So keep a list of rockets that will
-    // be exploded after the collisions
-    std::vector<Moveable*> rocketsToExplode;
-    for(int i=0; i<currentNumManifolds; i++)
-    {               
-        btPersistentManifold* contactManifold = m_dynamics_world->getDispatcher()->getManifoldByIndexInternal(i);
-
-        btCollisionObject* objA = static_cast<btCollisionObject*>(contactManifold->getBody0());
-        btCollisionObject* objB = static_cast<btCollisionObject*>(contactManifold->getBody1());
-        
-        int numContacts = contactManifold->getNumContacts();
-        if(!numContacts) continue;   // no real collision
-
-        UserPointer *upA        = (UserPointer*)(objA->getUserPointer());
-        UserPointer *upB        = (UserPointer*)(objB->getUserPointer());
+                             btDispatcher* dispatcher)
+{
+    IslandJob job;
+    job.m_first_body      = (int)m_island_bodies.size();
+    job.m_num_bodies      = numBodies;
+    job.m_first_manifold  = (int)m_island_manifolds.size();
+    job.m_num_manifolds   = numManifolds;
+    job.m_constraints     = constraints;
+    job.m_num_constraints = numConstraints;
+    m_island_bodies.insert(m_island_bodies.end(), bodies, bodies+numBodies);
+    m_island_manifolds.insert(m_island_manifolds.end(), manifold,
+                              manifold+numManifolds);
+    m_islands.push_back(job);
+    m_solver_info       = &info;
+    m_solver_dispatcher = dispatcher;
+    return 0.0f;
+}   // solveGroup
+
+//-----------------------------------------------------------------------------
+/** Solves one island, and records all collisions in it. This is executed by
+ *  the thread pool, so it must only access data of this island and of the
+ *  executing thread. The random seed of the solver (which changes the order
+ *  in which constraints are solved) is set from the island index, so the
+ *  result does not depend on which thread solves which island.
+ *  \param data Pointer to the physics object.
+ *  \param island Index of the island to solve.
+ *  \param thread Index of the thread.
+ */
+void Physics::solveIsland(void *data, int island, int thread)
+{
+    Physics         *physics = (Physics*)data;
+    const IslandJob &job     = physics->m_islands[island];
+    ThreadData      &td      = physics->m_thread_data[thread];
+    btCollisionObject    **bodies    = job.m_num_bodies>0
+                                     ? &physics->m_island_bodies[job.m_first_body]
+                                     : NULL;
+    btPersistentManifold **manifolds = job.m_num_manifolds>0
+                                     ? &physics->m_island_manifolds[job.m_first_manifold]
+                                     : NULL;
+    td.m_solver->setRandSeed(physics->m_solver_seed*1021+island);
+    // The debug drawer is not thread safe, and the stack allocator is
+    // not used by the solver.
+    td.m_solver->solveGroup(bodies, job.m_num_bodies,
+                            manifolds, job.m_num_manifolds,
+                            job.m_constraints, job.m_num_constraints,
+                            *physics->m_solver_info,
+                            /*debugDrawer*/NULL, /*stackAlloc*/NULL,
+                            physics->m_solver_dispatcher);
 
+    for(int i=0; i<job.m_num_manifolds; i++)
+    {
+        btPersistentManifold *contact_manifold = manifolds[i];
+        if(!contact_manifold->getNumContacts()) continue;   // no real collision
+        btCollisionObject *objA =
+            static_cast<btCollisionObject*>(contact_manifold->getBody0());
+        btCollisionObject *objB =
+            static_cast<btCollisionObject*>(contact_manifold->getBody1());
+        CollisionRecord record;
+        record.m_island = island;
+        record.m_a      = (UserPointer*)(objA->getUserPointer());
+        record.m_b      = (UserPointer*)(objB->getUserPointer());
         // FIXME: Must be a moving physics object
-        // FIXME: A rocket should explode here!
-
-        if(!upA || !upB) continue;
-        // 1) object A is a track
-        // =======================
-        if(upA->is(UserPointer::UP_TRACK)) 
-        { 
-            if(upB->is(UserPointer::UP_FLYABLE))   // 1.1 projectile hits track
-                m_all_collisions.push_back(upB, upA);
-            else if(upB->is(UserPointer::UP_KART))
-            {
-                Kart *kart=upB->getPointerKart();
-                race_state->addCollision(kart->getWorldKartId());
-                kart->crashed(NULL);
-            }
-        }
-        // 2) object A is a kart
-        // =====================
-        else if(upA->is(UserPointer::UP_KART))
+        if(!record.m_a || !record.m_b) continue;
+        td.m_collisions.push_back(record);
+    }
+}   // solveIsland
+
+//-----------------------------------------------------------------------------
+/** Called by bullet after all islands of an internal timestep are reported.
+ *  This solves all islands (using the thread pool), and then handles the
+ *  collisions found in the order of the islands, so the result is the
+ *  same independent of the number of threads.
+ *  Using the contact manifolds after a physics time step might miss some
+ *  collisions (when more than one internal time step was done, and the
+ *  collision is added and removed), which is why this is done at each
+ *  internal timestep.
+ *  Parameters: see bullet documentation for details.
+ */
+void Physics::allSolved(const btContactSolverInfo& info,
+                        btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc)
+{
+    for(unsigned int i=0; i<m_thread_data.size(); i++)
+        m_thread_data[i].m_collisions.clear();
+    {
+        // Only the islands solved by this thread show up in bullet's
+        // profile below this node, see btQuickprof.cpp.
+        BT_PROFILE("solveIslands");
+        m_thread_pool->run(&Physics::solveIsland, this, (int)m_islands.size());
+    }
+
+    // Each island is solved by exactly one thread, so after a stable sort
+    // the collisions of an island are in the order of its manifolds.
+    m_collision_records.clear();
+    for(unsigned int i=0; i<m_thread_data.size(); i++)
+    {
+        const std::vector<CollisionRecord> &c = m_thread_data[i].m_collisions;
+        m_collision_records.insert(m_collision_records.end(),
+                                   c.begin(), c.end());
+    }
+    std::stable_sort(m_collision_records.begin(), m_collision_records.end());
+    for(unsigned int i=0; i<m_collision_records.size(); i++)
+        handleCollision(m_collision_records[i].m_a, m_collision_records[i].m_b);
+}   // allSolved
+
+//-----------------------------------------------------------------------------
+/** Sorts a collision into the event queue for its type. Each pair of
+ *  objects is only added once per physics update, even if it is reported
+ *  in more than one manifold or substep.
+ *  \param upA, upB User pointers of the two colliding objects.
+ */
+void Physics::handleCollision(const UserPointer *upA, const UserPointer *upB)
+{
+    // FIXME: A rocket should explode here!
+
+    // Normalise the order: a flyable is always first, a kart is
+    // always before the track.
+    if(upB->is(UserPointer::UP_FLYABLE) && !upA->is(UserPointer::UP_FLYABLE))
+        std::swap(upA, upB);
+    else if(upA->is(UserPointer::UP_TRACK))
+        std::swap(upA, upB);
+
+    // 1) a projectile hits something
+    // ==============================
+    if(upA->is(UserPointer::UP_FLYABLE))
+    {
+        if(upB->is(UserPointer::UP_TRACK         ) ||   // 1.1) projectile hits track
+           upB->is(UserPointer::UP_FLYABLE       ) ||   // 1.2) projectile hits projectile
+           upB->is(UserPointer::UP_MOVING_PHYSICS) ||   // 1.3) projectile hits moving physics
+           upB->is(UserPointer::UP_KART          )   )  // 1.4) projectile hits kart
         {
-            if(upB->is(UserPointer::UP_TRACK))
-            {
-                Kart *kart = upA->getPointerKart();
-                race_state->addCollision(kart->getWorldKartId());
-                kart->crashed(NULL);   // Kart hit track
-            }
-            else if(upB->is(UserPointer::UP_FLYABLE))
-                m_all_collisions.push_back(upB, upA);   // 2.1 projectile hits kart
-            else if(upB->is(UserPointer::UP_KART))
-                m_all_collisions.push_back(upA, upB);   // 2.2 kart hits kart
+            CollisionPair p(upA, upB);
+            if(m_collision_pairs.insert(p))
+                m_flyable_collisions.push_back(p);
         }
-        // 3) object A is a projectile
-        // =========================
-        else if(upA->is(UserPointer::UP_FLYABLE))
+    }
+    // 2) a kart hits something
+    // ========================
+    else if(upA->is(UserPointer::UP_KART))
+    {
+        if(upB->is(UserPointer::UP_TRACK))              // 2.1) kart hits track
         {
-            if(upB->is(UserPointer::UP_TRACK         ) ||   // 3.1) projectile hits track
-               upB->is(UserPointer::UP_FLYABLE       ) ||   // 3.2) projectile hits projectile
-               upB->is(UserPointer::UP_MOVING_PHYSICS) ||   // 3.3) projectile hits projectile
-               upB->is(UserPointer::UP_KART          )   )  // 3.4) projectile hits kart
-            {
-                m_all_collisions.push_back(upA, upB);
-            }
-        } 
-        else if(upA->is(UserPointer::UP_MOVING_PHYSICS))
+            if(m_collision_pairs.insert(CollisionPair(upA, upB)))
+                m_kart_track_collisions.push_back(upA->getPointerKart());
+        }
+        else if(upB->is(UserPointer::UP_KART))          // 2.2) kart hits kart
         {
-            if(upB->is(UserPointer::UP_FLYABLE)) 
-            {
-                m_all_collisions.push_back(upB, upA);
-            }
+            CollisionPair p(upA, upB);
+            if(m_collision_pairs.insert(p))
+                m_kart_kart_collisions.push_back(p);
         }
-        else assert("Unknown user pointer");            // 4) Should never happen
-    }   // for i<numManifolds
+    }
+    else if(!upA->is(UserPointer::UP_MOVING_PHYSICS) &&
+            !upA->is(UserPointer::UP_TRACK))
+        assert("Unknown user pointer");                 // 3) Should never happen
+}   // handleCollision
 
-    return returnValue;
-}   // solveGroup
+//-----------------------------------------------------------------------------
+/** Adds a collision pair to the set.
+ *  \return True if the pair was not in the set before.
+ */
+bool Physics::CollisionPairSet::insert(const CollisionPair &p)
+{
+    // Keep the table at most half full.
+    if(2*(m_used.size()+1) > m_table.size())
+        resize(2*m_table.size());
+    unsigned int mask = m_table.size()-1;
+    unsigned int i    = p.getHash() & mask;
+    while(m_table[i].a)
+    {
+        if(m_table[i]==p) return false;
+        i = (i+1) & mask;
+    }
+    m_table[i] = p;
+    m_used.push_back(i);
+    return true;
+}   // CollisionPairSet::insert
+
+//-----------------------------------------------------------------------------
+/** Removes all pairs (but keeps the memory).
+ */
+void Physics::CollisionPairSet::clear()
+{
+    for(unsigned int i=0; i<m_used.size(); i++)
+        m_table[m_used[i]] = CollisionPair();
+    m_used.clear();
+}   // CollisionPairSet::clear
+
+//-----------------------------------------------------------------------------
+/** Changes the size of the hash table and re-inserts all pairs.
+ *  \param n New size, must be a power of 2.
+ */
+void Physics::CollisionPairSet::resize(unsigned int n)
+{
+    std::vector<CollisionPair> old;
+    for(unsigned int i=0; i<m_used.size(); i++)
+        old.push_back(m_table[m_used[i]]);
+    m_table.clear();
+    m_table.resize(n);
+    m_used.clear();
+    for(unsigned int i=0; i<old.size(); i++)
+        insert(old[i]);
+}   // CollisionPairSet::resize
 
 // -----------------------------------------------------------------------------
 /** A debug draw function to show the track and all karts.                    */
@@ -33,21 +33,23 @@
 
 class Vec3;
 class Kart;
+class ThreadPool;
 
 class Physics : public btSequentialImpulseConstraintSolver
 {
+public:
+    /** The broadphase algorithms that can be used. The axis sweep needs
+     *  the size of the world in advance and is fast for few objects, the
+     *  aabb tree scales better with many (moving) objects. */
+    enum BroadphaseType {BP_AXIS_SWEEP, BP_AABB_TREE, BP_COUNT};
+
 private:
 
     // Bullet can report the same collision more than once (up to 4
-    // contact points per collision. Additionally, more than one internal
-    // substep might be taken, resulting in potentially even more
-    // duplicates. To handle this, all collisions (i.e. pair of objects)
-    // are stored in a vector, but only one entry per collision pair
-    // of objects.
-    // While this is a natural application of std::set, the set has some
-    // overhead (since it will likely use a tree to sort the entries).
-    // Considering that the number of collisions is usually rather small
-    // a simple list and linear search is faster is is being used here.
+    // contact points per collision, and one manifold per pair of objects
+    // in each substep). To handle this, all collisions (i.e. pair of
+    // objects) of one physics update are stored in a hash set, and only
+    // the first report of a pair is added to the event queues.
 
     class CollisionPair {
     public:
@@ -56,6 +58,7 @@ private:
         // The entries in Collision Pairs are sorted: if a projectile
         // is included, it's always 'a'. If only two karts are reported
         // the first kart pointer is the smaller one
+        CollisionPair() : a(NULL), b(NULL) {};
         CollisionPair(const UserPointer *a1, const UserPointer *b1) {
             if(a1->is(UserPointer::UP_KART) &&
                b1->is(UserPointer::UP_KART) && a1>b1) {
@@ -64,25 +67,62 @@ private:
                 a=a1; b=b1;
             }
         };  //    CollisionPair
-        bool operator==(const CollisionPair p) {return (p.a==a && p.b==b);}
+        bool operator==(const CollisionPair p) const {return (p.a==a && p.b==b);}
+        unsigned int getHash() const
+        {
+            // The lowest bits of the pointers are always 0
+            return (unsigned int)((size_t)a>>3)*2654435761u
+                 ^ (unsigned int)((size_t)b>>3)*40503u;
+        }   // getHash
     };  // CollisionPair
 
-    // This class is the list of collision objects, where each collision
-    // pair is stored as most once.
-    class CollisionList : public std::vector<CollisionPair> {
+    // An open addressing hash set of collision pairs, which keeps its
+    // memory when it is cleared (since it is cleared in each frame).
+    class CollisionPairSet {
     private:
-        void push_back(CollisionPair p) {
-            // only add a pair if it's not already in there
-            for(iterator i=begin(); i!=end(); i++) {
-                if((*i)==p) return;
-            }
-            std::vector<CollisionPair>::push_back(p);
-        };  // push_back
+        std::vector<CollisionPair> m_table;
+        // Indices of all used entries in m_table, used for clearing.
+        std::vector<int>           m_used;
+        void resize(unsigned int n);
     public:
-        void push_back(const UserPointer* a, const UserPointer*b) {
-            push_back(CollisionPair(a, b));
+        CollisionPairSet() { resize(64); }
+        bool insert(const CollisionPair &p);
+        void clear();
+    };  // CollisionPairSet
+
+    /** All data needed to solve one simulation island. Bullet reuses its
+     *  arrays for each island, so bodies and manifolds are copied (into
+     *  m_island_bodies and m_island_manifolds); the constraints stay valid
+     *  until all islands are solved. */
+    struct IslandJob
+    {
+        int                 m_first_body;
+        int                 m_num_bodies;
+        int                 m_first_manifold;
+        int                 m_num_manifolds;
+        btTypedConstraint **m_constraints;
+        int                 m_num_constraints;
+    };   // IslandJob
+
+    /** A collision found while solving an island. The island index is used
+     *  to handle the collisions in the same order independent of the
+     *  number of threads. */
+    struct CollisionRecord
+    {
+        int                m_island;
+        const UserPointer *m_a, *m_b;
+        bool operator<(const CollisionRecord &r) const
+        {
+            return m_island < r.m_island;
         }
-    };  // CollisionList
+    };   // CollisionRecord
+
+    /** Solver, and the collisions found by it, for each thread. */
+    struct ThreadData
+    {
+        btSequentialImpulseConstraintSolver *m_solver;
+        std::vector<CollisionRecord>         m_collisions;
+    };   // ThreadData
 
     btDynamicsWorld                 *m_dynamics_world;
 #ifdef HAVE_GLUT
@@ -90,9 +130,32 @@ private:
     GL_ShapeDrawer                   m_shape_drawer;
 #endif
     btCollisionDispatcher           *m_dispatcher;
-    btBroadphaseInterface           *m_axis_sweep;
+    btBroadphaseInterface           *m_broadphase;
     btDefaultCollisionConfiguration *m_collision_conf;
-    CollisionList                    m_all_collisions;
+    /** All collision pairs reported in this physics update. */
+    CollisionPairSet                 m_collision_pairs;
+    /** Karts that crashed into the track. */
+    std::vector<Kart*>               m_kart_track_collisions;
+    /** Kart-kart collisions, 'a' is the kart with the smaller pointer. */
+    std::vector<CollisionPair>       m_kart_kart_collisions;
+    /** Flyables hitting anything, 'a' is always the flyable. */
+    std::vector<CollisionPair>       m_flyable_collisions;
+
+    ThreadPool                      *m_thread_pool;
+    std::vector<ThreadData>          m_thread_data;
+    std::vector<IslandJob>           m_islands;
+    std::vector<btCollisionObject*>  m_island_bodies;
+    std::vector<btPersistentManifold*> m_island_manifolds;
+    std::vector<CollisionRecord>     m_collision_records;
+    /** Solver info of the current substep, it is the same for all islands. */
+    const btContactSolverInfo       *m_solver_info;
+    btDispatcher                    *m_solver_dispatcher;
+    /** Changed for each substep, to get a different constraint order in
+     *  each substep (independent of the number of threads). */
+    unsigned long                    m_solver_seed;
+
+    static void solveIsland (void *data, int island, int thread);
+    void        handleCollision(const UserPointer *upA, const UserPointer *upB);
 
 public:
           Physics          ();
@@ -109,12 +172,22 @@ public:
           getPhysicsWorld  () const {return m_dynamics_world;}
     void  debugDraw        (float m[16], btCollisionShape *s, const btVector3 color);
     bool  projectKartDownwards (const Kart *k);
+    virtual void prepareSolve  (int numBodies, int numManifolds);
+    virtual void allSolved     (const btContactSolverInfo& info,
+                                btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc);
     virtual btScalar solveGroup(btCollisionObject** bodies, int numBodies,
                                 btPersistentManifold** manifold,int numManifolds,
                                 btTypedConstraint** constraints,int numConstraints,
                                 const btContactSolverInfo& info, 
                                 btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc,
                                 btDispatcher* dispatcher);
+    static btBroadphaseInterface*
+          createBroadphase (BroadphaseType type, const Vec3 &min_world,
+                            const Vec3 &max_world);
+    static const char*
+          getBroadphaseName(BroadphaseType type);
+    static void benchmarkBroadphases(const Vec3 &min_world,
+                                     const Vec3 &max_world, int num_objects);
 };
 
 #endif // HEADER_PHYSICS_HPP
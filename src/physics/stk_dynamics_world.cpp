@@ -0,0 +1,74 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "physics/stk_dynamics_world.hpp"
+
+#include "LinearMath/btQuickprof.h"
+#include "physics/btKart.hpp"
+
+// ----------------------------------------------------------------------------
+/** Updates all vehicles. The suspension rays of all wheels are cast in one
+ *  batch first, then each vehicle is updated using these results. This is
+ *  equivalent to casting the rays in btKart::updateVehicle, since updating
+ *  a vehicle only changes velocities, not the positions of any object.
+ *  \param timeStep Time step size.
+ */
+void STKDynamicsWorld::updateVehicles(btScalar timeStep)
+{
+    unsigned int num_rays = 0;
+    for(int i=0; i<m_vehicles.size(); i++)
+        num_rays += m_vehicles[i]->getNumWheels();
+    if(num_rays==0)
+    {
+        btDiscreteDynamicsWorld::updateVehicles(timeStep);
+        return;
+    }
+
+    {
+        BT_PROFILE("castWheelRays");
+        m_ray_from.resize(num_rays);
+        m_ray_to.resize(num_rays);
+        m_ray_results.resize(num_rays);
+        m_ray_objects.resize(num_rays);
+
+        int n = 0;
+        for(int i=0; i<m_vehicles.size(); i++)
+        {
+            btKart *kart = static_cast<btKart*>(m_vehicles[i]);
+            kart->getWheelRays(&m_ray_from[n], &m_ray_to[n]);
+            n += kart->getNumWheels();
+        }
+
+        m_wheel_raycaster.castRays(num_rays, &m_ray_from[0], &m_ray_to[0],
+                                   &m_ray_results[0], &m_ray_objects[0]);
+    }
+
+    int n = 0;
+    for(int i=0; i<m_vehicles.size(); i++)
+    {
+        btKart *kart = static_cast<btKart*>(m_vehicles[i]);
+        kart->setWheelRayResults(&m_ray_results[n], &m_ray_objects[n]);
+        n += kart->getNumWheels();
+    }
+
+    btDiscreteDynamicsWorld::updateVehicles(timeStep);
+
+    for(int i=0; i<m_vehicles.size(); i++)
+        static_cast<btKart*>(m_vehicles[i])->setWheelRayResults(NULL, NULL);
+}   // updateVehicles
+
+/* EOF */
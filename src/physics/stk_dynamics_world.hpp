@@ -0,0 +1,56 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_STK_DYNAMICS_WORLD_HPP
+#define HEADER_STK_DYNAMICS_WORLD_HPP
+
+#include <vector>
+
+#include "btBulletDynamicsCommon.h"
+
+#include "physics/wheel_raycaster.hpp"
+
+/** A bullet dynamics world which casts the suspension rays of all karts
+ *  in one batch (see WheelRaycaster), instead of one ray per wheel. All
+ *  vehicles added to this world must be btKarts.
+ */
+class STKDynamicsWorld : public btDiscreteDynamicsWorld
+{
+private:
+    WheelRaycaster                 m_wheel_raycaster;
+    std::vector<btVector3>         m_ray_from;
+    std::vector<btVector3>         m_ray_to;
+    std::vector<btVehicleRaycaster::btVehicleRaycasterResult>
+                                   m_ray_results;
+    std::vector<void*>             m_ray_objects;
+
+protected:
+    virtual void updateVehicles(btScalar timeStep);
+
+public:
+    STKDynamicsWorld(btDispatcher *dispatcher,
+                     btBroadphaseInterface *pair_cache,
+                     btConstraintSolver *constraint_solver,
+                     btCollisionConfiguration *collision_configuration)
+        : btDiscreteDynamicsWorld(dispatcher, pair_cache, constraint_solver,
+                                  collision_configuration),
+          m_wheel_raycaster(this) {}
+};   // STKDynamicsWorld
+
+#endif
+
+/* EOF */
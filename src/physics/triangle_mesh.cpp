@@ -18,8 +18,84 @@
 //  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "triangle_mesh.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#ifndef WIN32
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+#include "material.hpp"
+#include "material_manager.hpp"
 #include "modes/world.hpp"
 
+/** Increase this if the layout of the cache file changes. */
+static const unsigned int CACHE_VERSION = 1;
+
+/** Header of a cache file. The header is followed by (all offsets are
+ *  relative to the beginning of the file):
+ *  - the vertices (3 btVector3 per triangle) at m_vertex_offset,
+ *  - the vertex indices (3 ints per triangle) at m_index_offset,
+ *  - the material index of each triangle (one int per triangle) at
+ *    m_material_offset,
+ *  - the 0 terminated texture names of the materials at m_names_offset,
+ *  - the serialised btOptimizedBvh at m_bvh_offset.
+ *  The file is only used on the same kind of machine it was written on,
+ *  so all data is stored in the native byte order and sizes.
+ */
+struct CacheHeader
+{
+    char         m_magic[4];
+    unsigned int m_version;
+    unsigned int m_bullet_version;
+    unsigned int m_key;
+    unsigned int m_vector_size;
+    unsigned int m_bvh_object_size;
+    unsigned int m_num_triangles;
+    unsigned int m_num_materials;
+    unsigned int m_vertex_offset;
+    unsigned int m_index_offset;
+    unsigned int m_material_offset;
+    unsigned int m_names_offset;
+    unsigned int m_names_size;
+    unsigned int m_bvh_offset;
+    unsigned int m_bvh_size;
+    unsigned int m_file_size;
+};   // CacheHeader
+
+// -----------------------------------------------------------------------------
+/** Rounds an offset up to the alignment needed by btVector3 and the BVH. */
+static unsigned int alignOffset(unsigned int offset)
+{
+    return (offset+15) & ~15u;
+}   // alignOffset
+
+// -----------------------------------------------------------------------------
+/** Returns true if the range of size bytes starting at offset is inside a
+ *  file of the given size. The test avoids the overflow of offset+size.
+ */
+static bool isInFile(size_t offset, size_t size, size_t file_size)
+{
+    return offset<=file_size && size<=file_size-offset;
+}   // isInFile
+
+// -----------------------------------------------------------------------------
+TriangleMesh::TriangleMesh() : m_mesh()
+{
+    m_body            = NULL;
+    m_motion_state    = NULL;
+    m_collision_shape = NULL;
+    m_mesh_interface  = &m_mesh;
+    m_cached_mesh     = NULL;
+    m_cache_data      = NULL;
+    m_cache_size      = 0;
+}   // TriangleMesh
+
 // -----------------------------------------------------------------------------
 TriangleMesh::~TriangleMesh()
 {
@@ -28,8 +104,12 @@ TriangleMesh::~TriangleMesh()
         RaceManager::getWorld()->getPhysics()->removeBody(m_body);
         delete m_body;
         delete m_motion_state;
-        delete m_collision_shape;
     }
+    // The shape doesn't own a BVH loaded from the cache file, so it can
+    // be deleted before the file is unmapped.
+    delete m_collision_shape;
+    delete m_cached_mesh;
+    unmapCacheFile();
 }   // ~TriangleMesh
 
 // -----------------------------------------------------------------------------
@@ -40,6 +120,29 @@ void TriangleMesh::addTriangle(const btVector3 &t1, const btVector3 &t2,
     m_mesh.addTriangle(t1, t2, t3);
 }   // addTriangle
 
+// -----------------------------------------------------------------------------
+/** Returns the vertices of the triangle with the given index.
+ */
+void TriangleMesh::getTriangle(int n, btVector3 *t1, btVector3 *t2,
+                               btVector3 *t3) const
+{
+    const unsigned char *vertices, *indices;
+    int                  num_vertices, vertex_stride;
+    int                  num_triangles, index_stride;
+    PHY_ScalarType       vertex_type, index_type;
+    m_mesh_interface->getLockedReadOnlyVertexIndexBase(&vertices, num_vertices,
+                                                       vertex_type,
+                                                       vertex_stride, &indices,
+                                                       index_stride,
+                                                       num_triangles,
+                                                       index_type);
+    const int *index = (const int*)(indices+n*index_stride);
+    *t1 = *(const btVector3*)(vertices+index[0]*vertex_stride);
+    *t2 = *(const btVector3*)(vertices+index[1]*vertex_stride);
+    *t3 = *(const btVector3*)(vertices+index[2]*vertex_stride);
+    m_mesh_interface->unLockReadOnlyVertexBase(0);
+}   // getTriangle
+
 // -----------------------------------------------------------------------------
 void TriangleMesh::createBody(btCollisionObject::CollisionFlags flags)
 {
@@ -52,6 +155,15 @@ void TriangleMesh::createBody(btCollisionObject::CollisionFlags flags)
     }
     // Now convert the triangle mesh into a static rigid body
     m_collision_shape = new btBvhTriangleMeshShape(&m_mesh, true);
+    createRigidBody(flags);
+}   // createBody
+
+// -----------------------------------------------------------------------------
+/** Creates the static rigid body for m_collision_shape and adds it to the
+ *  physics world.
+ */
+void TriangleMesh::createRigidBody(btCollisionObject::CollisionFlags flags)
+{
     btTransform startTransform;
     startTransform.setIdentity();
     m_motion_state = new btDefaultMotionState(startTransform);
@@ -64,6 +176,296 @@ void TriangleMesh::createBody(btCollisionObject::CollisionFlags flags)
     m_body->setCollisionFlags(m_body->getCollisionFlags()  | 
                               flags                        |
                               btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
-}   // createBody
+}   // createRigidBody
+
+// -----------------------------------------------------------------------------
+/** Saves the triangles, their materials and the BVH of the collision shape
+ *  to a cache file. Must be called after createBody.
+ *  \param filename Name of the cache file.
+ *  \param key A value identifying the data the mesh was created from. The
+ *         cache file is only used if loadCache is called with the same key.
+ */
+void TriangleMesh::saveCache(const std::string &filename, 
+                             unsigned int key) const
+{
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, "STKB", 4);
+    header.m_version         = CACHE_VERSION;
+    header.m_bullet_version  = btGetVersion();
+    header.m_key             = key;
+    header.m_vector_size     = sizeof(btVector3);
+    header.m_bvh_object_size = sizeof(btOptimizedBvh);
+    header.m_num_triangles   = getNumTriangles();
+
+    // Replace the material pointers with indices into a table of the
+    // texture names, which are used to find the materials again.
+    std::map<const Material*, int> material_index;
+    std::vector<int>               materials(header.m_num_triangles);
+    std::string                    names;
+    for(unsigned int i=0; i<header.m_num_triangles; i++)
+    {
+        const Material *m = m_triangleIndex2Material[i];
+        std::map<const Material*, int>::iterator p = material_index.find(m);
+        if(p==material_index.end())
+        {
+            int index        = (int)material_index.size();
+            material_index[m] = index;
+            materials[i]     = index;
+            names           += m->getTexFname();
+            names           += '\0';
+        }
+        else
+            materials[i] = p->second;
+    }
+    header.m_num_materials = (unsigned int)material_index.size();
+
+    const unsigned char *vertices=NULL, *indices=NULL;
+    btOptimizedBvh      *bvh=NULL;
+    if(m_collision_shape)
+    {
+        int            num_vertices, vertex_stride;
+        int            num_triangles, index_stride;
+        PHY_ScalarType vertex_type, index_type;
+        m_mesh_interface->getLockedReadOnlyVertexIndexBase(&vertices, 
+                                                           num_vertices,
+                                                           vertex_type,
+                                                           vertex_stride,
+                                                           &indices,
+                                                           index_stride,
+                                                           num_triangles,
+                                                           index_type);
+        m_mesh_interface->unLockReadOnlyVertexBase(0);
+        // The layout of btTriangleMesh is stored as is.
+        if(num_vertices!=3*num_triangles                  ||
+           vertex_stride!=(int)sizeof(btVector3)          ||
+           index_stride!=3*(int)sizeof(int)               ||
+           index_type!=PHY_INTEGER                        ||
+           num_triangles!=(int)header.m_num_triangles       ) 
+            return;
+        bvh = ((btBvhTriangleMeshShape*)m_collision_shape)->getOptimizedBvh();
+        header.m_bvh_size = bvh->calculateSerializeBufferSize();
+    }
+
+    const unsigned int n     = header.m_num_triangles;
+    header.m_vertex_offset   = alignOffset(sizeof(CacheHeader));
+    header.m_index_offset    = header.m_vertex_offset + 3*n*sizeof(btVector3);
+    header.m_material_offset = header.m_index_offset  + 3*n*sizeof(int);
+    header.m_names_offset    = header.m_material_offset + n*sizeof(int);
+    header.m_names_size      = (unsigned int)names.size();
+    header.m_bvh_offset      = alignOffset(header.m_names_offset
+                                           +header.m_names_size);
+    header.m_file_size       = header.m_bvh_offset + header.m_bvh_size;
+
+    // The data is written to a temporary file, which is then renamed. So
+    // the cache file is never incomplete, even if the game is interrupted
+    // or several processes (e.g. the workers of a GP simulation) write the
+    // same file at the same time.
+    char suffix[32];
+#ifdef WIN32
+    sprintf(suffix, ".tmp");
+#else
+    sprintf(suffix, ".%d.tmp", (int)getpid());
+#endif
+    const std::string tmp_filename = filename+suffix;
+    FILE *fd = fopen(tmp_filename.c_str(), "wb");
+    if(!fd)
+    {
+        fprintf(stderr, "Warning: Can't write cache file '%s'.\n",
+                filename.c_str());
+        return;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, fd)==1;
+    if(n>0)
+    {
+        fseek(fd, header.m_vertex_offset, SEEK_SET);
+        ok = ok && fwrite(vertices, sizeof(btVector3), 3*n, fd)==3*n;
+        ok = ok && fwrite(indices,  sizeof(int),       3*n, fd)==3*n;
+        ok = ok && fwrite(&materials[0], sizeof(int),    n, fd)==n;
+        ok = ok && fwrite(names.data(), 1, names.size(), fd)==names.size();
+    }
+    if(bvh)
+    {
+        void *buffer = btAlignedAlloc(header.m_bvh_size, 16);
+        ok = ok && bvh->serialize(buffer, header.m_bvh_size, 
+                                  /*swap endian*/false);
+        fseek(fd, header.m_bvh_offset, SEEK_SET);
+        ok = ok && fwrite(buffer, 1, header.m_bvh_size, fd)==header.m_bvh_size;
+        btAlignedFree(buffer);
+    }
+    ok = fclose(fd)==0 && ok;
+#ifdef WIN32
+    // rename does not replace an existing file on windows.
+    if(ok) remove(filename.c_str());
+#endif
+    if(!ok || rename(tmp_filename.c_str(), filename.c_str())!=0)
+    {
+        fprintf(stderr, "Warning: Can't write cache file '%s'.\n",
+                filename.c_str());
+        remove(tmp_filename.c_str());
+    }
+}   // saveCache
+
+// -----------------------------------------------------------------------------
+/** Loads the mesh from a cache file written by saveCache, and creates the
+ *  rigid body (like createBody). No triangles must have been added to this
+ *  mesh.
+ *  \param filename Name of the cache file.
+ *  \param key The key the cache file must have been saved with.
+ *  \param flags Additional collision flags of the body.
+ *  \return True if the cache file was loaded, false if it doesn't exist
+ *          or is outdated, in which case the mesh is unchanged.
+ */
+bool TriangleMesh::loadCache(const std::string &filename, unsigned int key,
+                             btCollisionObject::CollisionFlags flags)
+{
+    assert(m_triangleIndex2Material.size()==0);
+    if(!mapCacheFile(filename)) return false;
+
+    const CacheHeader *header = (const CacheHeader*)m_cache_data;
+    const unsigned int n      = m_cache_size>=sizeof(CacheHeader) 
+                              ? header->m_num_triangles : 0;
+    if(m_cache_size<sizeof(CacheHeader)                        ||
+       memcmp(header->m_magic, "STKB", 4)!=0                   ||
+       header->m_version         != CACHE_VERSION              ||
+       header->m_bullet_version  != (unsigned int)btGetVersion() ||
+       header->m_key             != key                        ||
+       header->m_vector_size     != sizeof(btVector3)          ||
+       header->m_bvh_object_size != sizeof(btOptimizedBvh)     ||
+       header->m_file_size       != m_cache_size               ||
+       !isInFile(header->m_vertex_offset, 3*(size_t)n*sizeof(btVector3),
+                 m_cache_size)                                  ||
+       !isInFile(header->m_index_offset, 3*(size_t)n*sizeof(int),
+                 m_cache_size)                                  ||
+       !isInFile(header->m_material_offset, (size_t)n*sizeof(int),
+                 m_cache_size)                                  ||
+       !isInFile(header->m_names_offset, header->m_names_size,
+                 m_cache_size)                                  ||
+       !isInFile(header->m_bvh_offset, header->m_bvh_size, m_cache_size) ||
+       // The vertices and the BVH are used in place and must be aligned.
+       header->m_vertex_offset!=alignOffset(header->m_vertex_offset) ||
+       header->m_bvh_offset   !=alignOffset(header->m_bvh_offset)    ||
+       // The last texture name must be 0 terminated.
+       (header->m_names_size>0 && 
+        m_cache_data[header->m_names_offset+header->m_names_size-1]!=0) ||
+       (n>0 && header->m_bvh_size==0)                            )
+    {
+        unmapCacheFile();
+        return false;
+    }
+
+    // Find the materials by their texture names
+    std::vector<const Material*> materials;
+    const char *name = m_cache_data + header->m_names_offset;
+    const char *end  = name + header->m_names_size;
+    while(name<end && materials.size()<header->m_num_materials)
+    {
+        materials.push_back(material_manager->getMaterial(name));
+        name += strlen(name)+1;
+    }
+    const int *material_index = (const int*)(m_cache_data
+                                             +header->m_material_offset);
+    for(unsigned int i=0; i<n; i++)
+    {
+        if(material_index[i]<0 || material_index[i]>=(int)materials.size())
+        {
+            m_triangleIndex2Material.clear();
+            unmapCacheFile();
+            return false;
+        }
+        m_triangleIndex2Material.push_back(materials[material_index[i]]);
+    }
+
+    if(n==0)
+    {
+        // Nothing to collide with, see createBody.
+        unmapCacheFile();
+        return true;
+    }
+
+    // The BVH is initialised in place, i.e. the shape uses the mapped data.
+    btOptimizedBvh *bvh = 
+        btOptimizedBvh::deSerializeInPlace(m_cache_data+header->m_bvh_offset,
+                                           header->m_bvh_size,
+                                           /*swap endian*/false);
+    if(!bvh)
+    {
+        m_triangleIndex2Material.clear();
+        unmapCacheFile();
+        return false;
+    }
+    m_cached_mesh = 
+        new btTriangleIndexVertexArray(n, 
+                                 (int*)(m_cache_data+header->m_index_offset),
+                                 3*sizeof(int), 3*n,
+                                 (btScalar*)(m_cache_data
+                                             +header->m_vertex_offset),
+                                 sizeof(btVector3));
+    m_mesh_interface = m_cached_mesh;
+    btBvhTriangleMeshShape *shape = 
+        new btBvhTriangleMeshShape(m_cached_mesh, true, /*buildBvh*/false);
+    shape->setOptimizedBvh(bvh);
+    m_collision_shape = shape;
+    createRigidBody(flags);
+    return true;
+}   // loadCache
 
 // -----------------------------------------------------------------------------
+/** Makes the content of a cache file available in m_cache_data. The file
+ *  is memory mapped if possible, otherwise it is read into memory.
+ *  \return False if the file can't be read.
+ */
+bool TriangleMesh::mapCacheFile(const std::string &filename)
+{
+#ifdef WIN32
+    FILE *fd = fopen(filename.c_str(), "rb");
+    if(!fd) return false;
+    fseek(fd, 0, SEEK_END);
+    long size = ftell(fd);
+    fseek(fd, 0, SEEK_SET);
+    if(size<=0)
+    {
+        fclose(fd);
+        return false;
+    }
+    m_cache_data = (char*)btAlignedAlloc(size, 16);
+    m_cache_size = size;
+    bool ok      = fread(m_cache_data, 1, size, fd)==(size_t)size;
+    fclose(fd);
+    if(!ok) unmapCacheFile();
+    return ok;
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd<0) return false;
+    struct stat st;
+    if(fstat(fd, &st)!=0 || st.st_size<=0)
+    {
+        close(fd);
+        return false;
+    }
+    // The BVH is initialised in place, so the pages must be writable.
+    // MAP_PRIVATE makes sure that the file itself is not modified.
+    void *data = mmap(NULL, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE,
+                      fd, 0);
+    close(fd);
+    if(data==MAP_FAILED) return false;
+    m_cache_data = (char*)data;
+    m_cache_size = st.st_size;
+    return true;
+#endif
+}   // mapCacheFile
+
+// -----------------------------------------------------------------------------
+void TriangleMesh::unmapCacheFile()
+{
+    if(!m_cache_data) return;
+#ifdef WIN32
+    btAlignedFree(m_cache_data);
+#else
+    munmap(m_cache_data, m_cache_size);
+#endif
+    m_cache_data = NULL;
+    m_cache_size = 0;
+}   // unmapCacheFile
+
+/* EOF */
@@ -20,6 +20,7 @@
 #ifndef HEADER_TRIANGLE_MESH_H
 #define HEADER_TRIANGLE_MESH_H
 
+#include <string>
 #include <vector>
 #include "user_pointer.hpp"
 #include "btBulletDynamicsCommon.h"
@@ -28,6 +29,11 @@ class Material;
 
 /** A special class to store a triangle mesh with a separate material
  *  per triangle.
+ *  The mesh, the material of each triangle and the BVH of the collision
+ *  shape can be saved to a cache file (see saveCache), and later loaded
+ *  from this file instead of adding all triangles again and rebuilding
+ *  the BVH (see loadCache). If possible the cache file is memory mapped,
+ *  and the collision shape directly uses the mapped data.
  */
 class TriangleMesh
 {
@@ -38,13 +44,32 @@ private:
     btTriangleMesh               m_mesh;
     btDefaultMotionState        *m_motion_state;
     btCollisionShape            *m_collision_shape;
+    /** The mesh of the collision shape, either m_mesh or m_cached_mesh. */
+    btStridingMeshInterface     *m_mesh_interface;
+    /** A mesh using the data of the cache file, NULL if the triangles
+     *  were added with addTriangle. */
+    btTriangleIndexVertexArray  *m_cached_mesh;
+    /** Content of the cache file, NULL if the mesh was not loaded from
+     *  a cache file. */
+    char                        *m_cache_data;
+    size_t                       m_cache_size;
+
+    void createRigidBody(btCollisionObject::CollisionFlags flags);
+    bool mapCacheFile   (const std::string &filename);
+    void unmapCacheFile ();
 public:
-    TriangleMesh() : m_mesh() {};
+         TriangleMesh();
         ~TriangleMesh();
     void addTriangle(const btVector3 &t1, const btVector3 &t2, 
                      const btVector3 &t3, const Material* m);
     void createBody(btCollisionObject::CollisionFlags flags=
                          (btCollisionObject::CollisionFlags)0);
+    bool loadCache  (const std::string &filename, unsigned int key,
+                     btCollisionObject::CollisionFlags flags=
+                         (btCollisionObject::CollisionFlags)0);
+    void saveCache  (const std::string &filename, unsigned int key) const;
+    void getTriangle(int n, btVector3 *t1, btVector3 *t2, btVector3 *t3) const;
+    int  getNumTriangles() const {return (int)m_triangleIndex2Material.size();}
     const Material* getMaterial(int n) const {return m_triangleIndex2Material[n];}
 };
 #endif
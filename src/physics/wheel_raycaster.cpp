@@ -0,0 +1,381 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "physics/wheel_raycaster.hpp"
+
+#include <algorithm>
+
+#include "LinearMath/btAabbUtil2.h"
+
+const float WheelRaycaster::MAX_PACKET_EXTENT = 8.0f;
+
+namespace
+{
+    /** Tests all triangles of a mesh, which are found when traversing the
+     *  bvh of the mesh with the aabb of a packet, against all rays of the
+     *  packet. The rays are stored as separate coordinate arrays, so that
+     *  the loop over the rays can be vectorised by the compiler. The test
+     *  is identical to btTriangleRaycastCallback::processTriangle, so the
+     *  results are the same as with btCollisionWorld::rayTest.
+     */
+    struct PacketTriangleCallback : public btNodeOverlapCallback
+    {
+        btStridingMeshInterface *m_mesh_interface;
+        int       m_num_rays;
+        btScalar  m_from_x[WheelRaycaster::MAX_PACKET_SIZE];
+        btScalar  m_from_y[WheelRaycaster::MAX_PACKET_SIZE];
+        btScalar  m_from_z[WheelRaycaster::MAX_PACKET_SIZE];
+        btScalar  m_to_x  [WheelRaycaster::MAX_PACKET_SIZE];
+        btScalar  m_to_y  [WheelRaycaster::MAX_PACKET_SIZE];
+        btScalar  m_to_z  [WheelRaycaster::MAX_PACKET_SIZE];
+        btScalar  m_fraction[WheelRaycaster::MAX_PACKET_SIZE];
+        btVector3 m_normal  [WheelRaycaster::MAX_PACKET_SIZE];
+        bool      m_hit     [WheelRaycaster::MAX_PACKET_SIZE];
+
+        /** The locked vertex and index data of m_sub_part, so that the
+         *  (virtual) lock is only called once per sub part and packet. */
+        int                  m_sub_part;
+        const unsigned char *m_vertex_base;
+        int                  m_stride;
+        const unsigned char *m_index_base;
+        int                  m_index_stride;
+        PHY_ScalarType       m_indices_type;
+
+        // --------------------------------------------------------------------
+        PacketTriangleCallback(btStridingMeshInterface *mesh_interface)
+            : m_mesh_interface(mesh_interface), m_num_rays(0), m_sub_part(-1)
+        {
+        }   // PacketTriangleCallback
+        // --------------------------------------------------------------------
+        ~PacketTriangleCallback()
+        {
+            if(m_sub_part>=0)
+                m_mesh_interface->unLockReadOnlyVertexBase(m_sub_part);
+        }   // ~PacketTriangleCallback
+        // --------------------------------------------------------------------
+        virtual void processNode(int sub_part, int triangle_index)
+        {
+            if(sub_part!=m_sub_part)
+            {
+                if(m_sub_part>=0)
+                    m_mesh_interface->unLockReadOnlyVertexBase(m_sub_part);
+                int            num_verts, num_faces;
+                PHY_ScalarType type;
+                m_mesh_interface->getLockedReadOnlyVertexIndexBase(
+                                  &m_vertex_base, num_verts, type, m_stride,
+                                  &m_index_base, m_index_stride, num_faces,
+                                  m_indices_type, sub_part);
+                m_sub_part = sub_part;
+            }
+
+            const int *gfx_base = (const int*)(m_index_base
+                                              +triangle_index*m_index_stride);
+            const btVector3 &scaling = m_mesh_interface->getScaling();
+            btVector3 triangle[3];
+            for(int j=2; j>=0; j--)
+            {
+                int index = m_indices_type==PHY_SHORT ? ((short*)gfx_base)[j]
+                                                      : gfx_base[j];
+                const btScalar *p =
+                    (const btScalar*)(m_vertex_base+index*m_stride);
+                triangle[j] = btVector3(p[0]*scaling.getX(),
+                                        p[1]*scaling.getY(),
+                                        p[2]*scaling.getZ());
+            }
+            testTriangle(triangle);
+        }   // processNode
+
+        // --------------------------------------------------------------------
+        void testTriangle(const btVector3 *triangle)
+        {
+            const btVector3 &v0 = triangle[0];
+            const btVector3 &v1 = triangle[1];
+            const btVector3 &v2 = triangle[2];
+            const btVector3 normal = (v1-v0).cross(v2-v0);
+            const btScalar nx = normal.getX();
+            const btScalar ny = normal.getY();
+            const btScalar nz = normal.getZ();
+            const btScalar dist = v0.dot(normal);
+            const btScalar edge_tolerance = normal.length2()*btScalar(-0.0001);
+
+            for(int r=0; r<m_num_rays; r++)
+            {
+                btScalar dist_a = nx*m_from_x[r] + ny*m_from_y[r]
+                                + nz*m_from_z[r] - dist;
+                btScalar dist_b = nx*m_to_x[r]   + ny*m_to_y[r]
+                                + nz*m_to_z[r]   - dist;
+                if(dist_a*dist_b >= btScalar(0.0)) continue;
+                btScalar distance = dist_a/(dist_a-dist_b);
+                if(distance >= m_fraction[r]) continue;
+
+                // Intersection point of the ray with the triangle plane
+                btScalar s  = btScalar(1.0)-distance;
+                btScalar px = s*m_from_x[r] + distance*m_to_x[r];
+                btScalar py = s*m_from_y[r] + distance*m_to_y[r];
+                btScalar pz = s*m_from_z[r] + distance*m_to_z[r];
+                btVector3 v0p(v0.getX()-px, v0.getY()-py, v0.getZ()-pz);
+                btVector3 v1p(v1.getX()-px, v1.getY()-py, v1.getZ()-pz);
+                if(v0p.cross(v1p).dot(normal) < edge_tolerance) continue;
+                btVector3 v2p(v2.getX()-px, v2.getY()-py, v2.getZ()-pz);
+                if(v1p.cross(v2p).dot(normal) < edge_tolerance) continue;
+                if(v2p.cross(v0p).dot(normal) < edge_tolerance) continue;
+
+                m_fraction[r] = distance;
+                m_normal[r]   = dist_a>0 ? normal : -normal;
+                m_hit[r]      = true;
+            }   // for r<m_num_rays
+        }   // testTriangle
+    };   // PacketTriangleCallback
+
+    // ------------------------------------------------------------------------
+    /** Interleaves the lower 16 bits of x and y, so that sorting by the
+     *  result keeps rays close to each other together. */
+    unsigned int interleaveBits(unsigned int x, unsigned int y)
+    {
+        unsigned int result = 0;
+        for(int i=0; i<16; i++)
+        {
+            result |= ((x>>i)&1) << (2*i);
+            result |= ((y>>i)&1) << (2*i+1);
+        }
+        return result;
+    }   // interleaveBits
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Casts a number of rays, and returns for each ray the closest rigid body
+ *  hit (like btDefaultVehicleRaycaster::castRay).
+ *  \param num_rays Number of rays.
+ *  \param from, to Start and end points of the rays.
+ *  \param results On return the hit point, normal and fraction of each ray.
+ *  \param objects On return the rigid body hit by each ray, or NULL.
+ */
+void WheelRaycaster::castRays(int num_rays, const btVector3 *from,
+                              const btVector3 *to,
+                              btVehicleRaycaster::btVehicleRaycasterResult *results,
+                              void **objects)
+{
+    m_rays.resize(num_rays);
+    for(int i=0; i<num_rays; i++)
+    {
+        m_rays[i].m_from     = from[i];
+        m_rays[i].m_to       = to[i];
+        m_rays[i].m_fraction = btScalar(1.0);
+        m_rays[i].m_object   = NULL;
+    }
+    createPackets();
+
+    // Test the objects in the same order as btCollisionWorld::rayTest, so
+    // that the closest hit is the same even if two hits have the same
+    // distance.
+    btCollisionObjectArray &all_objects = m_world->getCollisionObjectArray();
+    for(int i=0; i<all_objects.size(); i++)
+    {
+        btCollisionObject *obj = all_objects[i];
+        btVector3 obj_min, obj_max;
+        obj->getCollisionShape()->getAabb(obj->getWorldTransform(), obj_min,
+                                          obj_max);
+        if(obj->getCollisionShape()->getShapeType()
+            == TRIANGLE_MESH_SHAPE_PROXYTYPE)
+        {
+            // The track is split into chunks, so most packets are
+            // outside of a mesh.
+            for(unsigned int p=0; p<m_packets.size(); p++)
+            {
+                if(TestAabbAgainstAabb2(m_packets[p].m_aabb_min,
+                                        m_packets[p].m_aabb_max,
+                                        obj_min, obj_max))
+                    castPacketAgainstMesh(m_packets[p], obj);
+            }
+            continue;
+        }
+        for(unsigned int p=0; p<m_packets.size(); p++)
+        {
+            const Packet &packet = m_packets[p];
+            if(TestAabbAgainstAabb2(packet.m_aabb_min, packet.m_aabb_max,
+                                    obj_min, obj_max))
+                castPacketAgainstObject(packet, obj, obj_min, obj_max);
+        }
+    }   // for i<all_objects.size()
+
+    for(int i=0; i<num_rays; i++)
+    {
+        const Ray &ray = m_rays[i];
+        objects[i]     = NULL;
+        if(!ray.m_object) continue;
+        btRigidBody *body = btRigidBody::upcast(ray.m_object);
+        if(!body) continue;
+        results[i].m_hitPointInWorld.setInterpolate3(ray.m_from, ray.m_to,
+                                                     ray.m_fraction);
+        results[i].m_hitNormalInWorld = ray.m_normal;
+        results[i].m_hitNormalInWorld.normalize();
+        results[i].m_distFraction     = ray.m_fraction;
+        objects[i]                    = body;
+    }
+}   // castRays
+
+// ----------------------------------------------------------------------------
+/** Sorts the rays by the position of their start points in the x/y plane,
+ *  and groups neighbouring rays into packets.
+ */
+void WheelRaycaster::createPackets()
+{
+    m_order.clear();
+    m_packets.clear();
+    if(m_rays.size()==0) return;
+
+    btVector3 min = m_rays[0].m_from;
+    for(unsigned int i=1; i<m_rays.size(); i++)
+        min.setMin(m_rays[i].m_from);
+    for(unsigned int i=0; i<m_rays.size(); i++)
+    {
+        // Use cells of 1m, which is small enough to keep the wheels of
+        // one kart together.
+        btVector3 cell = m_rays[i].m_from - min;
+        unsigned int key = interleaveBits((unsigned int)cell.getX(),
+                                          (unsigned int)cell.getY());
+        m_order.push_back(std::make_pair(key, (int)i));
+    }
+    std::sort(m_order.begin(), m_order.end());
+
+    for(unsigned int i=0; i<m_order.size(); i++)
+    {
+        const Ray &ray = m_rays[m_order[i].second];
+        btVector3 ray_min = ray.m_from, ray_max = ray.m_from;
+        ray_min.setMin(ray.m_to);
+        ray_max.setMax(ray.m_to);
+        if(m_packets.size()>0)
+        {
+            Packet &packet = m_packets.back();
+            btVector3 new_min = packet.m_aabb_min, new_max = packet.m_aabb_max;
+            new_min.setMin(ray_min);
+            new_max.setMax(ray_max);
+            if(packet.m_num_rays < MAX_PACKET_SIZE                      &&
+               new_max.getX()-new_min.getX() <= MAX_PACKET_EXTENT       &&
+               new_max.getY()-new_min.getY() <= MAX_PACKET_EXTENT          )
+            {
+                packet.m_num_rays++;
+                packet.m_aabb_min = new_min;
+                packet.m_aabb_max = new_max;
+                continue;
+            }
+        }
+        Packet packet;
+        packet.m_first    = i;
+        packet.m_num_rays = 1;
+        packet.m_aabb_min = ray_min;
+        packet.m_aabb_max = ray_max;
+        m_packets.push_back(packet);
+    }   // for i<m_order.size()
+}   // createPackets
+
+// ----------------------------------------------------------------------------
+/** Tests all rays of a packet against a bvh triangle mesh (i.e. the track).
+ *  The bvh is only traversed once with the aabb of the packet.
+ *  \param packet The packet.
+ *  \param obj The collision object, its shape must be a
+ *         btBvhTriangleMeshShape.
+ */
+void WheelRaycaster::castPacketAgainstMesh(const Packet &packet,
+                                           btCollisionObject *obj)
+{
+    btBvhTriangleMeshShape *shape =
+        static_cast<btBvhTriangleMeshShape*>(obj->getCollisionShape());
+    const btTransform &transform = obj->getWorldTransform();
+    btTransform world_to_local = transform.inverse();
+
+    PacketTriangleCallback callback(shape->getMeshInterface());
+    callback.m_num_rays = packet.m_num_rays;
+    btVector3 aabb_min, aabb_max;
+    for(int r=0; r<packet.m_num_rays; r++)
+    {
+        const Ray &ray = m_rays[m_order[packet.m_first+r].second];
+        btVector3 from = world_to_local*ray.m_from;
+        btVector3 to   = world_to_local*ray.m_to;
+        callback.m_from_x[r]   = from.getX();
+        callback.m_from_y[r]   = from.getY();
+        callback.m_from_z[r]   = from.getZ();
+        callback.m_to_x[r]     = to.getX();
+        callback.m_to_y[r]     = to.getY();
+        callback.m_to_z[r]     = to.getZ();
+        callback.m_fraction[r] = ray.m_fraction;
+        callback.m_hit[r]      = false;
+        if(r==0)
+        {
+            aabb_min = from;
+            aabb_max = from;
+        }
+        aabb_min.setMin(from); aabb_min.setMin(to);
+        aabb_max.setMax(from); aabb_max.setMax(to);
+    }
+    shape->getOptimizedBvh()->reportAabbOverlappingNodex(&callback, aabb_min,
+                                                         aabb_max);
+    for(int r=0; r<packet.m_num_rays; r++)
+    {
+        if(!callback.m_hit[r]) continue;
+        Ray &ray       = m_rays[m_order[packet.m_first+r].second];
+        ray.m_fraction = callback.m_fraction[r];
+        ray.m_normal   = transform.getBasis()*callback.m_normal[r];
+        ray.m_object   = obj;
+    }
+}   // castPacketAgainstMesh
+
+// ----------------------------------------------------------------------------
+/** Tests all rays of a packet against any collision object, using the same
+ *  test as btCollisionWorld::rayTest.
+ *  \param packet The packet.
+ *  \param obj The collision object.
+ *  \param obj_min, obj_max The aabb of the collision object, which must
+ *         overlap the aabb of the packet.
+ */
+void WheelRaycaster::castPacketAgainstObject(const Packet &packet,
+                                             btCollisionObject *obj,
+                                             const btVector3 &obj_min,
+                                             const btVector3 &obj_max)
+{
+    for(int r=0; r<packet.m_num_rays; r++)
+    {
+        Ray &ray = m_rays[m_order[packet.m_first+r].second];
+        // rayTest stops once the closest hit fraction is zero.
+        if(ray.m_fraction==btScalar(0.0)) continue;
+        btScalar  hit_lambda = ray.m_fraction;
+        btVector3 hit_normal;
+        if(!btRayAabb(ray.m_from, ray.m_to, obj_min, obj_max, hit_lambda,
+                      hit_normal))
+            continue;
+
+        btTransform from_trans, to_trans;
+        from_trans.setIdentity();
+        from_trans.setOrigin(ray.m_from);
+        to_trans.setIdentity();
+        to_trans.setOrigin(ray.m_to);
+        btCollisionWorld::ClosestRayResultCallback callback(ray.m_from,
+                                                            ray.m_to);
+        callback.m_closestHitFraction = ray.m_fraction;
+        btCollisionWorld::rayTestSingle(from_trans, to_trans, obj,
+                                        obj->getCollisionShape(),
+                                        obj->getWorldTransform(), callback);
+        if(callback.m_collisionObject)
+        {
+            ray.m_fraction = callback.m_closestHitFraction;
+            ray.m_normal   = callback.m_hitNormalWorld;
+            ray.m_object   = obj;
+        }
+    }   // for r<packet.m_num_rays
+}   // castPacketAgainstObject
+
+/* EOF */
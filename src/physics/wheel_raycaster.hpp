@@ -0,0 +1,85 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_WHEEL_RAYCASTER_HPP
+#define HEADER_WHEEL_RAYCASTER_HPP
+
+#include <vector>
+
+#include "btBulletDynamicsCommon.h"
+
+/** Casts the suspension rays of all wheels of all karts in one batch. The
+ *  result for each ray is identical to btDefaultVehicleRaycaster::castRay
+ *  (closest hit with any rigid body), but the rays are sorted spatially
+ *  and grouped into small packets: each triangle mesh (i.e. the track) is
+ *  only traversed once per packet, and each triangle found is tested
+ *  against all rays of the packet. Other objects are only tested against
+ *  the rays of a packet if the bounding boxes overlap.
+ */
+class WheelRaycaster
+{
+public:
+    /** Maximum number of rays in a packet. */
+    enum {MAX_PACKET_SIZE = 16};
+
+private:
+    /** Maximum extent of a packet in the x/y plane, so that rays of karts
+     *  far apart are not combined into one packet. */
+    static const float MAX_PACKET_EXTENT;
+
+    /** The state of a ray while testing the objects. */
+    struct Ray
+    {
+        btVector3          m_from;
+        btVector3          m_to;
+        btVector3          m_normal;
+        btScalar           m_fraction;
+        btCollisionObject *m_object;
+    };   // Ray
+
+    /** A group of rays which are close to each other. */
+    struct Packet
+    {
+        /** Index of the first ray in m_order. */
+        int       m_first;
+        int       m_num_rays;
+        btVector3 m_aabb_min;
+        btVector3 m_aabb_max;
+    };   // Packet
+
+    btCollisionWorld                *m_world;
+    std::vector<Ray>                 m_rays;
+    /** Ray indices, sorted spatially. */
+    std::vector<std::pair<unsigned int, int> > m_order;
+    std::vector<Packet>              m_packets;
+
+    void createPackets();
+    void castPacketAgainstMesh(const Packet &packet, btCollisionObject *obj);
+    void castPacketAgainstObject(const Packet &packet, btCollisionObject *obj,
+                                 const btVector3 &obj_min,
+                                 const btVector3 &obj_max);
+
+public:
+         WheelRaycaster(btCollisionWorld *world) : m_world(world) {}
+    void castRays(int num_rays, const btVector3 *from, const btVector3 *to,
+                  btVehicleRaycaster::btVehicleRaycasterResult *results,
+                  void **objects);
+};   // WheelRaycaster
+
+#endif
+
+/* EOF */
@@ -51,15 +51,15 @@ void RaceManager::setWorld(World* world_arg)
 }
 Track* RaceManager::getTrack()
 {
-    return world->getTrack();
+    return getWorld()->getTrack();
 }
 Kart* RaceManager::getPlayerKart(const unsigned int n)
 {
-    return world->getPlayerKart(n);
+    return getWorld()->getPlayerKart(n);
 }
 Kart* RaceManager::getKart(const unsigned int n)
 {
-    return world->getKart(n);
+    return getWorld()->getKart(n);
 }
 //-----------------------------------------------------------------------------
 
@@ -69,6 +69,7 @@ RaceManager::RaceManager()
 {
     m_num_karts          = user_config->getDefaultNumKarts();
     m_difficulty         = RD_HARD;
+    m_robot_type         = RT_RANDOM;
     m_major_mode         = MAJOR_MODE_SINGLE;
     m_minor_mode         = MINOR_MODE_QUICK_RACE;
     m_track_number       = 0;
@@ -148,6 +149,20 @@ void RaceManager::setDifficulty(Difficulty diff)
     m_difficulty = diff;
 }   // setDifficulty
 
+//-----------------------------------------------------------------------------
+/** Returns the name of a robot type, which is used to select it on the
+ *  command line (e.g. for the AI benchmark).
+ *  \param t The robot type (not RT_RANDOM).
+ */
+const char *RaceManager::getRobotTypeName(RobotType t)
+{
+    switch(t)
+    {
+    case RT_DEFAULT: return "default";
+    default:         return "random";
+    }
+}   // getRobotTypeName
+
 //-----------------------------------------------------------------------------
 /** In case of non GP mode set the track to use.
  *  \param track Pointer to the track to use.
@@ -382,8 +397,7 @@ void RaceManager::exit_race()
         menu_manager->switchToMainMenu();
     }
     scene->clear();
-    delete world;
-    world          = 0;
+    setWorld(NULL);
     m_track_number = 0;
     m_active_race  = false;    
 }   // exit_Race
@@ -425,7 +439,7 @@ void RaceManager::rerunRace()
         m_kart_status[i].m_score         = m_kart_status[i].m_last_score;
         m_kart_status[i].m_overall_time -= m_kart_status[i].m_last_time;
     }
-    world->restartRace();
+    getWorld()->restartRace();
 }   // rerunRace
 
 /* EOF */
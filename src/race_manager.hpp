@@ -93,6 +93,11 @@ public:
     /** Difficulty. */
     enum Difficulty {RD_EASY, RD_MEDIUM, RD_HARD};
 
+    /** The AI classes that can drive an AI kart on a race track (see
+     *  World::loadRobot). RT_RANDOM selects a random class for each kart.
+     *  This is independent of the difficulty, which configures the AI. */
+    enum RobotType  {RT_RANDOM=-1, RT_DEFAULT, RT_COUNT};
+
     /** Different kart types: A local player, a player connected via network,
      *  an AI kart, the leader kart (currently not used), a ghost kart 
      *  (currently not used). */
@@ -126,6 +131,7 @@ private:
 
     std::vector<KartStatus>          m_kart_status;
     Difficulty                       m_difficulty;
+    RobotType                        m_robot_type;
     MajorRaceModeType                m_major_mode;
     MinorRaceModeType                m_minor_mode;
     typedef std::vector<std::string> PlayerKarts;
@@ -176,6 +182,7 @@ public:
     void         setTrack(const std::string& track);
     void         setGrandPrix(const GrandPrixData &gp){m_grand_prix = gp;            }
     void         setDifficulty(Difficulty diff);
+    void         setRobotType(RobotType t)      {m_robot_type = t;                   }
     void         setNumLaps(int num)            {m_num_laps.clear();
                                                  m_num_laps.push_back(num);          }
     void         setMajorMode(MajorRaceModeType mode)                                
@@ -192,6 +199,8 @@ public:
     unsigned int getNumPlayers()          const {return m_player_karts.size();       }
     int          getNumLaps()             const {return m_num_laps[m_track_number];  }
     Difficulty   getDifficulty()          const {return m_difficulty;                }
+    RobotType    getRobotType()           const {return m_robot_type;                }
+    static const char *getRobotTypeName(RobotType t);
     const std::string& getTrackName()     const {return m_tracks[m_track_number];    }
     const GrandPrixData *getGrandPrix()   const {return &m_grand_prix;               }
     unsigned int getFinishedKarts()       const {return m_num_finished_karts;        }
@@ -0,0 +1,157 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "robots/ai_properties.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdexcept>
+#include <sstream>
+
+#include "stk_config.hpp"
+#include "lisp/lisp.hpp"
+#include "lisp/parser.hpp"
+#include "lisp/writer.hpp"
+
+AIProperties *ai_properties = 0;
+
+const AIProperties::ParameterInfo AIProperties::m_info[AP_COUNT] =
+{
+    // name                  min    max    integer tunable
+    {"max-start-delay",      0.0f,  1.0f,  false,  false},
+    {"max-handicap-accel",   0.5f,  1.0f,  false,  false},
+    {"min-steps",            0.0f,  4.0f,  true,   true },
+    {"skidding-threshold",   1.0f,  6.0f,  false,  true },
+    {"brake-angle",          5.0f, 45.0f,  false,  true },
+    {"curve-inside",         0.0f,  0.5f,  false,  true },
+    {"overtake-distance",    2.0f, 30.0f,  false,  true }
+};
+
+const char *AIProperties::m_difficulty_names[NUM_DIFFICULTIES] =
+    {"easy", "medium", "hard"};
+
+//-----------------------------------------------------------------------------
+AIProperties::AIProperties()
+{
+    for(int d=0; d<NUM_DIFFICULTIES; d++)
+        for(int p=0; p<AP_COUNT; p++)
+            m_values[d][p] = STKConfig::UNDEFINED;
+}   // AIProperties
+
+//-----------------------------------------------------------------------------
+/** Loads the parameters of all difficulties. If a value is missing, an
+ *  error message is printed and STK is aborted.
+ *  \param filename Name of the file to load.
+ */
+void AIProperties::load(const std::string &filename)
+{
+    const lisp::Lisp* root = 0;
+
+    try
+    {
+        lisp::Parser parser;
+        root = parser.parse(filename);
+
+        const lisp::Lisp* const LISP = root->getLisp("ai");
+        if(!LISP)
+        {
+            std::ostringstream msg;
+            msg<<"No 'ai' node found in '"<<filename<<"'.";
+            throw std::runtime_error(msg.str());
+        }
+        for(int d=0; d<NUM_DIFFICULTIES; d++)
+        {
+            const lisp::Lisp* const difficulty =
+                LISP->getLisp(m_difficulty_names[d]);
+            if(!difficulty) continue;
+            for(int p=0; p<AP_COUNT; p++)
+                difficulty->get(m_info[p].m_name, m_values[d][p]);
+        }
+        m_files.push_back(filename);
+    }
+    catch(std::exception& err)
+    {
+        fprintf(stderr, "Error while parsing AI properties '%s':\n",
+                filename.c_str());
+        fprintf(stderr, "%s", err.what());
+        fprintf(stderr, "\n");
+    }
+    delete root;
+
+    for(int d=0; d<NUM_DIFFICULTIES; d++)
+    {
+        for(int p=0; p<AP_COUNT; p++)
+        {
+            if(m_values[d][p]>STKConfig::UNDEFINED) continue;
+            fprintf(stderr,"Missing value for '%s' of '%s' in '%s'.\n",
+                    m_info[p].m_name, m_difficulty_names[d],
+                    filename.c_str());
+            exit(-1);
+        }
+    }
+}   // load
+
+//-----------------------------------------------------------------------------
+/** Returns the names of all loaded files (separated by ', '), so that
+ *  results (e.g. of the AI benchmark) show which parameters were used.
+ */
+std::string AIProperties::getFiles() const
+{
+    std::string files;
+    for(unsigned int i=0; i<m_files.size(); i++)
+    {
+        if(i>0) files += ", ";
+        files += m_files[i];
+    }
+    return files;
+}   // getFiles
+
+//-----------------------------------------------------------------------------
+/** Writes the parameters of all difficulties in the format of ai.data.
+ *  \param filename Name of the file to write.
+ */
+void AIProperties::save(const std::string &filename) const
+{
+    try
+    {
+        lisp::Writer writer(filename);
+        writer.writeComment("Parameters of the AI for each difficulty,");
+        writer.writeComment("written by the AI tuner.");
+        writer.beginList("ai");
+        for(int d=0; d<NUM_DIFFICULTIES; d++)
+        {
+            writer.beginList(m_difficulty_names[d]);
+            for(int p=0; p<AP_COUNT; p++)
+            {
+                if(m_info[p].m_is_integer)
+                    writer.write(m_info[p].m_name, (int)m_values[d][p]);
+                else
+                    writer.write(m_info[p].m_name, m_values[d][p]);
+            }
+            writer.endList(m_difficulty_names[d]);
+        }
+        writer.endList("ai");
+    }
+    catch(std::exception& e)
+    {
+        fprintf(stderr, "Problems saving AI properties in '%s':\n",
+                filename.c_str());
+        fprintf(stderr, "%s\n", e.what());
+    }
+}   // save
+
+/* EOF */
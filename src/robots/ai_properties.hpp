@@ -0,0 +1,86 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_AI_PROPERTIES_HPP
+#define HEADER_AI_PROPERTIES_HPP
+
+#include <string>
+#include <vector>
+
+#include "race_manager.hpp"
+
+/** The parameters of the AI for each difficulty, loaded from ai.data.
+ *  Some parameters only make the AI easier to beat (e.g. the start delay),
+ *  the others are tunable: they change how well the AI drives, and can be
+ *  optimised with the AI tuner (see AITuner), which writes a new ai.data.
+ */
+class AIProperties
+{
+public:
+    /** All parameters, the names in ai.data are in m_info. */
+    enum Parameter {AP_MAX_START_DELAY,   AP_MAX_HANDICAP_ACCEL,
+                    AP_MIN_STEPS,         AP_SKIDDING_THRESHOLD,
+                    AP_BRAKE_ANGLE,       AP_CURVE_INSIDE,
+                    AP_OVERTAKE_DISTANCE, AP_COUNT};
+    enum {NUM_DIFFICULTIES = RaceManager::RD_HARD+1};
+
+private:
+    /** Name, range and type of a parameter. */
+    struct ParameterInfo
+    {
+        const char *m_name;
+        float       m_min, m_max;
+        bool        m_is_integer;
+        /** True if the parameter changes how well the AI drives. */
+        bool        m_tunable;
+    };   // ParameterInfo
+    static const ParameterInfo m_info[AP_COUNT];
+    static const char *m_difficulty_names[NUM_DIFFICULTIES];
+
+    float m_values[NUM_DIFFICULTIES][AP_COUNT];
+    /** The files loaded so far, later files replace values of earlier
+     *  ones. */
+    std::vector<std::string> m_files;
+
+public:
+                AIProperties();
+    void        load(const std::string &filename);
+    void        save(const std::string &filename) const;
+    std::string getFiles() const;
+    // ------------------------------------------------------------------------
+    /** Returns the value of a parameter for a difficulty. */
+    float       get(RaceManager::Difficulty d, Parameter p) const
+                                            {return m_values[d][p];         }
+    // ------------------------------------------------------------------------
+    /** Changes the value of a parameter, used by the AI tuner. */
+    void        set(RaceManager::Difficulty d, Parameter p, float v)
+                                            {m_values[d][p] = v;            }
+    // ------------------------------------------------------------------------
+    static const char *getName(Parameter p) {return m_info[p].m_name;       }
+    static float getMin(Parameter p)        {return m_info[p].m_min;        }
+    static float getMax(Parameter p)        {return m_info[p].m_max;        }
+    static bool  isInteger(Parameter p)     {return m_info[p].m_is_integer; }
+    static bool  isTunable(Parameter p)     {return m_info[p].m_tunable;    }
+    static const char *getDifficultyName(RaceManager::Difficulty d)
+                                            {return m_difficulty_names[d];  }
+};   // AIProperties
+
+extern AIProperties *ai_properties;
+
+#endif
+
+/* EOF */
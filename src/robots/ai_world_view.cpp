@@ -0,0 +1,86 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "robots/ai_world_view.hpp"
+
+#include "karts/kart.hpp"
+#include "modes/linear_world.hpp"
+#include "tracks/track.hpp"
+
+// ----------------------------------------------------------------------------
+/** Takes a snapshot of all karts.
+ *  \param karts All karts of the race, indexed by their world kart id.
+ *  \param world The world if it is a linear world (otherwise NULL), used
+ *         for the sector, lap and track coordinates of the karts.
+ */
+void AIWorldView::update(const std::vector<Kart*> &karts,
+                         const LinearWorld *world)
+{
+    const unsigned int n = karts.size();
+    m_xyz.resize(n);
+    m_velocity.resize(n);
+    m_velocity_lc.resize(n);
+    m_speed.resize(n);
+    m_kart_length.resize(n);
+    m_position.resize(n);
+    m_eliminated.resize(n);
+    m_attachment.resize(n);
+    m_powerup.resize(n);
+    m_sector.resize(n);
+    m_lap.resize(n);
+    m_distance_down_track.resize(n);
+    m_distance_to_center.resize(n);
+    m_on_road.resize(n);
+
+    for(unsigned int i=0; i<n; i++)
+    {
+        Kart *kart          = karts[i];
+        m_xyz[i]            = kart->getXYZ();
+        m_velocity[i]       = kart->getVelocity();
+        m_velocity_lc[i]    = kart->getVelocityLC();
+        m_speed[i]          = kart->getSpeed();
+        m_kart_length[i]    = kart->getKartLength();
+        m_position[i]       = kart->getPosition();
+        m_eliminated[i]     = kart->isEliminated();
+        m_attachment[i]     = kart->getAttachment()->getType();
+        m_powerup[i]        = kart->getPowerup()->getType();
+    }
+
+    if(!world)
+    {
+        for(unsigned int i=0; i<n; i++)
+        {
+            m_sector[i]              = Track::UNKNOWN_SECTOR;
+            m_lap[i]                 = 0;
+            m_distance_down_track[i] = 0.0f;
+            m_distance_to_center[i]  = 0.0f;
+            m_on_road[i]             = false;
+        }
+        return;
+    }
+    for(unsigned int i=0; i<n; i++)
+    {
+        const KartInfo &info     = world->m_kart_info[i];
+        m_sector[i]              = info.m_track_sector;
+        m_lap[i]                 = info.m_race_lap;
+        m_distance_down_track[i] = info.m_curr_track_coords.getY();
+        m_distance_to_center[i]  = info.m_curr_track_coords.getX();
+        m_on_road[i]             = info.m_on_road;
+    }
+}   // update
+
+/* EOF */
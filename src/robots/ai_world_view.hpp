@@ -0,0 +1,81 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_AI_WORLD_VIEW_HPP
+#define HEADER_AI_WORLD_VIEW_HPP
+
+#include <vector>
+
+#include "items/attachment.hpp"
+#include "items/powerup_manager.hpp"
+#include "utils/vec3.hpp"
+
+class Kart;
+class LinearWorld;
+
+/** A snapshot of the state of all karts that is used by the AI. It is
+ *  built once per frame after the physics, before the AI karts think, and
+ *  then only read by all AI karts (possibly in parallel). Each value is
+ *  stored in its own array indexed by the world kart id, so that loops
+ *  over all karts only touch the data they need, and no virtual functions
+ *  of the karts or the world are called in the AI.
+ */
+class AIWorldView
+{
+private:
+    std::vector<Vec3>           m_xyz;
+    std::vector<Vec3>           m_velocity;
+    /** Velocity in the local coordinate system of the kart. */
+    std::vector<Vec3>           m_velocity_lc;
+    std::vector<float>          m_speed;
+    std::vector<float>          m_kart_length;
+    std::vector<int>            m_position;
+    std::vector<char>           m_eliminated;
+    std::vector<attachmentType> m_attachment;
+    std::vector<PowerupType>    m_powerup;
+    /** The following values are only set in a linear world. */
+    std::vector<int>            m_sector;
+    std::vector<int>            m_lap;
+    std::vector<float>          m_distance_down_track;
+    std::vector<float>          m_distance_to_center;
+    std::vector<char>           m_on_road;
+
+public:
+         AIWorldView() {}
+    void update(const std::vector<Kart*> &karts, const LinearWorld *world);
+    // ------------------------------------------------------------------------
+    /** Returns the number of karts (including eliminated karts). */
+    int   getNumKarts() const                  {return (int)m_xyz.size();   }
+    const Vec3 &getXYZ(int k) const            {return m_xyz[k];            }
+    const Vec3 &getVelocity(int k) const       {return m_velocity[k];       }
+    const Vec3 &getVelocityLC(int k) const     {return m_velocity_lc[k];    }
+    float getSpeed(int k) const                {return m_speed[k];          }
+    float getKartLength(int k) const           {return m_kart_length[k];    }
+    int   getPosition(int k) const             {return m_position[k];       }
+    bool  isEliminated(int k) const            {return m_eliminated[k]!=0;  }
+    attachmentType getAttachment(int k) const  {return m_attachment[k];     }
+    PowerupType    getPowerup(int k) const     {return m_powerup[k];        }
+    int   getSector(int k) const               {return m_sector[k];         }
+    int   getLap(int k) const                  {return m_lap[k];            }
+    float getDistanceDownTrack(int k) const    {return m_distance_down_track[k];}
+    float getDistanceToCenter(int k) const     {return m_distance_to_center[k]; }
+    bool  isOnRoad(int k) const                {return m_on_road[k]!=0;     }
+};   // AIWorldView
+
+#endif
+
+/* EOF */
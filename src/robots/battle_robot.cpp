@@ -0,0 +1,364 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "robots/battle_robot.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+#include "race_manager.hpp"
+#include "stk_config.hpp"
+#include "modes/world.hpp"
+#include "network/network_manager.hpp"
+#include "robots/ai_properties.hpp"
+#include "robots/ai_world_view.hpp"
+#include "tracks/arena_graph.hpp"
+#include "tracks/track.hpp"
+
+/** Number of nodes ahead on the path to the target to steer to. */
+static const int   LOOKAHEAD_NODES    = 2;
+/** Below this path length the kart steers directly to the target. */
+static const float DIRECT_DISTANCE    = 8.0f;
+/** A new target is only chosen if it is this much closer than the old
+ *  one, so that the kart doesn't change its target all the time. */
+static const float TARGET_HYSTERESIS  = 5.0f;
+/** Karts within this distance are shot at. */
+static const float FIRE_DISTANCE      = 25.0f;
+/** Maximum angle between heading and target to fire (or to fire
+ *  backwards). */
+static const float FIRE_ANGLE         = 0.2f;
+/** A kart slower than this might be stuck. */
+static const float STUCK_SPEED        = 1.0f;
+/** Time a kart must be slow before it drives backwards. */
+static const float STUCK_TIME         = 1.0f;
+/** Time a stuck kart drives backwards. */
+static const float REVERSE_TIME       = 1.0f;
+/** Number of unsuccessful reverses before the kart is rescued. */
+static const int   MAX_REVERSES       = 3;
+
+// ----------------------------------------------------------------------------
+/** Normalises an angle to the range -pi to pi. */
+static float normalizeAngle(float angle)
+{
+    while(angle >  M_PI) angle -= 2*M_PI;
+    while(angle < -M_PI) angle += 2*M_PI;
+    return angle;
+}   // normalizeAngle
+
+// ----------------------------------------------------------------------------
+BattleRobot::BattleRobot(const std::string& kart_name, int position,
+                         const btTransform& init_pos, const Track *track) :
+    AutoKart(kart_name, position, init_pos)
+{
+    m_world = RaceManager::getWorld();
+    m_graph = track->getArenaGraph();
+    assert(m_graph != NULL);
+    const RaceManager::Difficulty d = race_manager->getDifficulty();
+    m_max_start_delay    = ai_properties->get(d, AIProperties::AP_MAX_START_DELAY);
+    m_skidding_threshold = ai_properties->get(d, AIProperties::AP_SKIDDING_THRESHOLD);
+    reset();
+}   // BattleRobot
+
+// ----------------------------------------------------------------------------
+void BattleRobot::reset()
+{
+    m_time_till_start  = -1.0f;
+    m_target           = -1;
+    m_target_distance  = 0.0f;
+    m_node             = -1;
+    m_has_steer_point  = false;
+    m_time_since_stuck = 0.0f;
+    m_reverse_time     = 0.0f;
+    m_num_reverses     = 0;
+    m_time_till_think  = 0.0f;
+    m_time_since_think = 0.0f;
+    m_has_thought      = false;
+    m_rescue_requested = false;
+    AutoKart::reset();
+}   // reset
+
+// ----------------------------------------------------------------------------
+/** Arenas have no driveline to move the kart along, so the kart is never
+ *  moved kinematically.
+ *  \param level The new simulation level.
+ */
+void BattleRobot::setSimulationLevel(SimulationLevel level)
+{
+    if(level==SL_KINEMATIC) level = SL_REDUCED;
+    Kart::setSimulationLevel(level);
+}   // setSimulationLevel
+
+// ----------------------------------------------------------------------------
+void BattleRobot::update(float dt)
+{
+    // The client does not do any AI computations.
+    if(network_manager->getMode()==NetworkManager::NW_CLIENT)
+    {
+        AutoKart::update(dt);
+        return;
+    }
+
+    if(m_world->isStartPhase())
+    {
+        if(m_time_till_start<0)
+            m_time_till_start = m_random.getFloat()*m_max_start_delay;
+        // Spread the AI decisions of the karts over several frames.
+        m_time_till_think = stk_config->m_ai_think_interval
+                          * (getWorldKartId()%4)*0.25f;
+        AutoKart::update(dt);
+        return;
+    }
+
+    // Apply the results of think() that modify the world.
+    if(m_has_thought)
+    {
+        if(m_rescue_requested) forceRescue();
+        m_rescue_requested = false;
+        m_has_thought      = false;
+        m_time_since_think = 0.0f;
+    }
+    updateSteering(dt);
+    AutoKart::update(dt);
+}   // update
+
+// ----------------------------------------------------------------------------
+/** Decides if the controls of this kart must be computed in this frame.
+ *  Decisions are made every ai-think-interval seconds, or in every frame
+ *  while the kart might be stuck.
+ *  \param dt Time step.
+ */
+AutoKart::ThinkRequest BattleRobot::needsThink(float dt)
+{
+    if(network_manager->getMode()==NetworkManager::NW_CLIENT ||
+       m_world->isStartPhase())
+        return TR_NONE;
+
+    m_time_since_think += dt;
+    m_time_till_think  -= dt;
+    if(getSpeed()<STUCK_SPEED && !isRescue()) return TR_URGENT;
+    return m_time_till_think>0 ? TR_NONE : TR_DUE;
+}   // needsThink
+
+// ----------------------------------------------------------------------------
+/** Computes the controls of this kart. This can be called in parallel for
+ *  several karts, so only this kart's data may be modified here.
+ */
+void BattleRobot::think()
+{
+    const float dt = m_time_since_think;
+    m_has_thought  = true;
+    if(m_time_till_think<=0)
+    {
+        float interval = getSimulationLevel()==SL_REDUCED
+                       ? stk_config->m_lod_ai_interval
+                       : stk_config->m_ai_think_interval;
+        m_time_till_think = std::max(0.0f, m_time_till_think+interval);
+    }
+
+    m_controls.m_look_back = false;
+    m_controls.m_fire      = false;
+    m_controls.m_nitro     = false;
+
+    const AIWorldView &view = m_world->getAIWorldView();
+    m_node = m_graph->getNode(getXYZ());
+    selectTarget(view);
+    handleSteering(view);
+    handleAcceleration(dt);
+    handleItems(view);
+}   // think
+
+// ----------------------------------------------------------------------------
+/** Selects the kart to chase: the kart with the shortest path to it. The
+ *  current target is kept unless another kart is much closer.
+ *  \param view Snapshot of all karts.
+ */
+void BattleRobot::selectTarget(const AIWorldView &view)
+{
+    const int old_target = m_target;
+    float old_distance   = -1.0f;
+    m_target = -1;
+    for(int k=0; k<view.getNumKarts(); k++)
+    {
+        if(k==getWorldKartId() || view.isEliminated(k)) continue;
+        const float d = m_graph->getDistance(m_node,
+                                             m_graph->getNode(view.getXYZ(k)));
+        if(d<0) continue;
+        if(k==old_target) old_distance = d;
+        if(m_target<0 || d<m_target_distance)
+        {
+            m_target          = k;
+            m_target_distance = d;
+        }
+    }
+    if(old_distance>=0 && m_target!=old_target &&
+       old_distance < m_target_distance+TARGET_HYSTERESIS)
+    {
+        m_target          = old_target;
+        m_target_distance = old_distance;
+    }
+}   // selectTarget
+
+// ----------------------------------------------------------------------------
+/** Determines the point to steer to: a node ahead on the path to the
+ *  target, or the (predicted) position of the target if it is close.
+ *  \param view Snapshot of all karts.
+ */
+void BattleRobot::handleSteering(const AIWorldView &view)
+{
+    m_has_steer_point = m_target>=0;
+    if(!m_has_steer_point) return;
+
+    const int target_node = m_graph->getNode(view.getXYZ(m_target));
+    if(target_node==m_node || m_target_distance<DIRECT_DISTANCE)
+    {
+        // Aim a bit ahead of the target.
+        m_steer_point = view.getXYZ(m_target) + view.getVelocity(m_target)*0.3f;
+        return;
+    }
+    const int ahead = m_graph->getNodeAhead(m_node, target_node,
+                                            LOOKAHEAD_NODES);
+    m_steer_point = m_graph->getCenter(ahead);
+}   // handleSteering
+
+// ----------------------------------------------------------------------------
+/** Sets acceleration and brake. A kart which is stuck (e.g. at a wall)
+ *  drives backwards for a while, and is rescued if this doesn't help.
+ *  \param dt Time since the last decision.
+ */
+void BattleRobot::handleAcceleration(float dt)
+{
+    m_controls.m_brake = false;
+    if(m_time_till_start>0)
+    {
+        m_time_till_start -= dt;
+        m_controls.m_accel = 0.0f;
+        return;
+    }
+    if(m_reverse_time>0)
+    {
+        m_reverse_time    -= dt;
+        m_controls.m_accel = 0.0f;
+        m_controls.m_brake = true;
+        return;
+    }
+    if(getSpeed()<STUCK_SPEED && !isRescue())
+    {
+        m_time_since_stuck += dt;
+        if(m_time_since_stuck>STUCK_TIME)
+        {
+            m_time_since_stuck = 0.0f;
+            m_num_reverses++;
+            if(m_num_reverses>MAX_REVERSES)
+            {
+                m_num_reverses     = 0;
+                m_rescue_requested = true;
+            }
+            else
+                m_reverse_time = REVERSE_TIME;
+        }
+    }
+    else if(getSpeed()>2*STUCK_SPEED)
+    {
+        m_time_since_stuck = 0.0f;
+        m_num_reverses     = 0;
+    }
+
+    // Slow down if the steer point is behind the kart.
+    m_controls.m_accel = 1.0f;
+    if(m_has_steer_point)
+    {
+        const Vec3 diff = m_steer_point - getXYZ();
+        const float angle = normalizeAngle(-atan2(diff.getX(), diff.getY())
+                                           - getHeading());
+        if(fabsf(angle)>0.5f*M_PI) m_controls.m_accel = 0.5f;
+    }
+}   // handleAcceleration
+
+// ----------------------------------------------------------------------------
+/** Decides if the powerup is used. Homing cakes are fired at any target in
+ *  range, bowling balls and plungers only if the target is straight ahead
+ *  (or straight behind, then they are fired backwards), and bubble gum is
+ *  dropped if the target is right behind the kart.
+ *  \param view Snapshot of all karts.
+ */
+void BattleRobot::handleItems(const AIWorldView &view)
+{
+    if(isRescue() || m_target<0 ||
+       m_powerup.getType()==POWERUP_NOTHING) return;
+
+    const Vec3  diff     = view.getXYZ(m_target) - getXYZ();
+    const float distance = diff.length();
+    const float angle    = normalizeAngle(-atan2(diff.getX(), diff.getY())
+                                          - getHeading());
+    switch(m_powerup.getType())
+    {
+    case POWERUP_BUBBLEGUM:
+        m_controls.m_fire = distance<DIRECT_DISTANCE &&
+                            fabsf(angle)>M_PI-2*FIRE_ANGLE;
+        break;
+    case POWERUP_CAKE:
+        m_controls.m_fire = distance<FIRE_DISTANCE;
+        break;
+    case POWERUP_BOWLING:
+    case POWERUP_PLUNGER:
+        if(distance>=FIRE_DISTANCE) break;
+        if(fabsf(angle)<FIRE_ANGLE)
+            m_controls.m_fire = true;
+        else if(fabsf(angle)>M_PI-FIRE_ANGLE)
+        {
+            m_controls.m_fire      = true;
+            m_controls.m_look_back = true;
+        }
+        break;
+    default:
+        // All other powerups don't need aiming.
+        m_controls.m_fire = true;
+        break;
+    }
+}   // handleItems
+
+// ----------------------------------------------------------------------------
+/** Steers towards the steer point. This is done every frame, even if the
+ *  kart did not think. When driving backwards the steering is inverted.
+ *  \param dt Time step.
+ */
+void BattleRobot::updateSteering(float dt)
+{
+    float steer_fraction = 0.0f;
+    if(m_has_steer_point)
+    {
+        const Vec3 diff   = m_steer_point - getXYZ();
+        const float angle = normalizeAngle(-atan2(diff.getX(), diff.getY())
+                                           - getHeading());
+        steer_fraction    = angle/getMaxSteerAngle();
+        if(m_reverse_time>0) steer_fraction = -steer_fraction;
+    }
+    m_controls.m_drift = fabsf(steer_fraction)>=m_skidding_threshold;
+    if     (steer_fraction >  1.0f) steer_fraction =  1.0f;
+    else if(steer_fraction < -1.0f) steer_fraction = -1.0f;
+
+    // Limit how fast the steering changes, like for the DefaultRobot.
+    const float max_change = dt/m_kart_properties->getTimeFullSteerAI();
+    const float old_steer  = m_controls.m_steer;
+    if(steer_fraction > old_steer+max_change)
+        steer_fraction = old_steer+max_change;
+    else if(steer_fraction < old_steer-max_change)
+        steer_fraction = old_steer-max_change;
+    m_controls.m_steer = steer_fraction;
+}   // updateSteering
+
+/* EOF */
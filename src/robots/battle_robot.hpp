@@ -0,0 +1,100 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_BATTLE_ROBOT_HPP
+#define HEADER_BATTLE_ROBOT_HPP
+
+#include "karts/auto_kart.hpp"
+#include "utils/random_generator.hpp"
+
+class AIWorldView;
+class ArenaGraph;
+class Track;
+class World;
+
+/** The AI for arenas. Arenas have no driveline, so instead of following
+ *  the driveline like the DefaultRobot, this AI uses the navigation graph
+ *  of the arena (see ArenaGraph): it chases the kart with the shortest
+ *  path to it, steers towards a node a bit ahead on this path (or directly
+ *  to the target once it is close), and fires its powerup when the target
+ *  is in range. The distances and paths are table lookups, so a decision
+ *  costs about as much as one of the race AI.
+ *  Like the DefaultRobot the decisions are made in think() (possibly in
+ *  parallel with other karts), and the steering is updated every frame.
+ */
+class BattleRobot : public AutoKart
+{
+private:
+    World            *m_world;
+    const ArenaGraph *m_graph;
+    RandomGenerator   m_random;
+
+    /** Maximum delay before accelerating at the start (from ai.data). */
+    float m_max_start_delay;
+    /** Steering fraction at which the kart starts to skid (from ai.data).*/
+    float m_skidding_threshold;
+
+    /** Time left before the kart accelerates at the start, or a negative
+     *  value if it was not yet determined. */
+    float m_time_till_start;
+    /** The world kart id of the kart chased, or -1. */
+    int   m_target;
+    /** Length of the path to the target. */
+    float m_target_distance;
+    /** The node the kart is on. */
+    int   m_node;
+    /** The point the kart steers to till the next decision. */
+    Vec3  m_steer_point;
+    /** False if the kart has no point to steer to (no target). */
+    bool  m_has_steer_point;
+
+    /** Time the kart has been driving slowly (i.e. might be stuck). */
+    float m_time_since_stuck;
+    /** Time left to drive backwards to get away from a wall. */
+    float m_reverse_time;
+    /** Number of times the kart drove backwards without getting free. */
+    int   m_num_reverses;
+
+    /** Time till the next scheduled AI decision. */
+    float m_time_till_think;
+    /** Time since the last AI decision. */
+    float m_time_since_think;
+    /** True if think() was called in this frame. */
+    bool  m_has_thought;
+    /** Set by think() if the kart must be rescued. The rescue is done in
+     *  update(), since think() must not modify the world. */
+    bool  m_rescue_requested;
+
+    void  selectTarget      (const AIWorldView &view);
+    void  handleSteering    (const AIWorldView &view);
+    void  handleAcceleration(float dt);
+    void  handleItems       (const AIWorldView &view);
+    void  updateSteering    (float dt);
+public:
+                 BattleRobot (const std::string& kart_name, int position,
+                              const btTransform& init_pos, const Track *track);
+    void         update      (float dt);
+    virtual ThinkRequest needsThink(float dt);
+    virtual void think       ();
+    virtual float getTimeSinceThink() const {return m_time_since_think;}
+    void         reset       ();
+    virtual void setSimulationLevel(SimulationLevel level);
+};   // BattleRobot
+
+#endif
+
+/* EOF */
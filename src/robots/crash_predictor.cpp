@@ -0,0 +1,248 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "robots/crash_predictor.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+#include "robots/ai_world_view.hpp"
+#include "tracks/track.hpp"
+
+/** Used to sort the paths by the minimum x coordinate of their boxes. */
+class PathCompare
+{
+    const std::vector<float> &m_min_x;
+public:
+    PathCompare(const std::vector<float> &min_x) : m_min_x(min_x) {}
+    bool operator()(int a, int b) const {return m_min_x[a]<m_min_x[b];}
+};   // PathCompare
+
+// ----------------------------------------------------------------------------
+/** Forgets all predictions, e.g. when a race is restarted.
+ */
+void CrashPredictor::reset()
+{
+    m_predictions.clear();
+    m_requests.clear();
+}   // reset
+
+// ----------------------------------------------------------------------------
+/** Requests a prediction for a kart, which is computed in the next call of
+ *  update(). The path of the kart is tested at num_steps-1 points, each
+ *  one kart length apart (starting one kart length ahead of the kart).
+ *  \param kart World id of the kart.
+ *  \param num_steps Number of steps to test.
+ *  \param future_sector The last future sector of the kart, used as
+ *         a hint to find the sector if the kart gets off the road.
+ */
+void CrashPredictor::requestPrediction(int kart, int num_steps,
+                                       int future_sector)
+{
+    if((int)m_predictions.size()<=kart)
+    {
+        Prediction p;
+        p.m_num_steps     = 0;
+        p.m_kart          = -1;
+        p.m_road          = false;
+        p.m_has_future    = false;
+        p.m_future_sector = 0;
+        p.m_sector        = Track::UNKNOWN_SECTOR;
+        m_predictions.resize(kart+1, p);
+    }
+    Prediction &p     = m_predictions[kart];
+    p.m_num_steps     = num_steps;
+    p.m_future_sector = future_sector;
+    m_requests.push_back(kart);
+}   // requestPrediction
+
+// ----------------------------------------------------------------------------
+/** Computes the path of all karts and their bounding boxes. The boxes
+ *  cover the time of the longest requested prediction, and are enlarged by
+ *  half the length of the longest kart, so that two karts which can get
+ *  closer than their length have overlapping boxes.
+ */
+void CrashPredictor::computePaths(const AIWorldView &view)
+{
+    m_paths.resize(view.getNumKarts());
+    float max_length = 0.0f;
+    for(int i=0; i<view.getNumKarts(); i++)
+    {
+        Path &p  = m_paths[i];
+        p.m_active = !view.isEliminated(i);
+        if(!p.m_active) continue;
+        p.m_xyz           = view.getXYZ(i);
+        const Vec3 &v     = view.getVelocity(i);
+        p.m_velocity      = Vec3(v.getX(), v.getY(), 0.0f);
+        p.m_forward_speed = view.getVelocityLC(i).getY();
+        p.m_length        = view.getKartLength(i);
+        const float speed = p.m_velocity.length();
+        p.m_step_time     = speed>0 ? p.m_length/speed : 0.0f;
+        max_length        = std::max(max_length, p.m_length);
+    }
+
+    float max_time = 0.0f;
+    for(unsigned int i=0; i<m_requests.size(); i++)
+    {
+        const int k = m_requests[i];
+        if(k>=(int)m_paths.size() || !m_paths[k].m_active) continue;
+        max_time = std::max(max_time, (m_predictions[k].m_num_steps-1)
+                                     *m_paths[k].m_step_time);
+    }
+
+    const float margin = 0.5f*max_length;
+    for(unsigned int i=0; i<m_paths.size(); i++)
+    {
+        Path &p = m_paths[i];
+        if(!p.m_active) continue;
+        const Vec3 end = p.m_xyz + p.m_velocity*max_time;
+        p.m_min_x = std::min(p.m_xyz.getX(), end.getX()) - margin;
+        p.m_max_x = std::max(p.m_xyz.getX(), end.getX()) + margin;
+        p.m_min_y = std::min(p.m_xyz.getY(), end.getY()) - margin;
+        p.m_max_y = std::max(p.m_xyz.getY(), end.getY()) + margin;
+    }
+}   // computePaths
+
+// ----------------------------------------------------------------------------
+/** Returns the first time at which a kart gets closer to another kart than
+ *  its length (in the x/y plane), or -1 if this doesn't happen during the
+ *  requested prediction. Only karts that are slower than the kart are
+ *  considered.
+ *  \param kart The kart for which the prediction was requested.
+ *  \param other The other kart.
+ */
+float CrashPredictor::getCrashTime(int kart, int other) const
+{
+    const Path &p = m_paths[kart];
+    const Path &o = m_paths[other];
+    if(p.m_forward_speed<=o.m_forward_speed || p.m_step_time<=0) return -1;
+
+    const float t0 = p.m_step_time;
+    const float t1 = (m_predictions[kart].m_num_steps-1)*p.m_step_time;
+    const Vec3  d  = o.m_xyz-p.m_xyz;
+    const Vec3  v  = o.m_velocity-p.m_velocity;
+    // The distance at time t is d+v*t, so solve |d+v*t|^2 < length^2,
+    // i.e. a*t^2 + 2*b*t + c < 0, in the x/y plane.
+    const float a  = v.getX()*v.getX() + v.getY()*v.getY();
+    const float b  = d.getX()*v.getX() + d.getY()*v.getY();
+    const float c  = d.getX()*d.getX() + d.getY()*d.getY()
+                   - p.m_length*p.m_length;
+    if(a==0) return c<0 ? t0 : -1;
+    const float disc = b*b-a*c;
+    if(disc<=0) return -1;
+    const float root = sqrtf(disc);
+    const float r1   = (-b-root)/a;
+    const float r2   = (-b+root)/a;
+    if(r2<=t0 || r1>t1) return -1;
+    return std::max(r1, t0);
+}   // getCrashTime
+
+// ----------------------------------------------------------------------------
+/** Tests a pair of karts (whose boxes overlap), and stores the crash for
+ *  the kart if it is earlier than all crashes found so far.
+ */
+void CrashPredictor::testPair(int kart, int other)
+{
+    if(m_crash_time[kart]<0) return;   // no prediction requested
+    const float t = getCrashTime(kart, other);
+    if(t>=0 && t<m_crash_time[kart])
+    {
+        m_crash_time[kart]          = t;
+        m_predictions[kart].m_kart = other;
+    }
+}   // testPair
+
+// ----------------------------------------------------------------------------
+/** Follows the path of a kart step by step to find the point where it gets
+ *  off the road, and the sector in which the kart will be.
+ */
+void CrashPredictor::predictRoad(int kart, const Track *track)
+{
+    Prediction &pr    = m_predictions[kart];
+    const Path &p     = m_paths[kart];
+    const float speed = p.m_velocity.length();
+    if(speed==0) return;
+    const Vec3 direction = p.m_velocity/speed;
+    for(int i=1; i<pr.m_num_steps; i++)
+    {
+        const Vec3 step = p.m_xyz + direction*(p.m_length*i);
+        track->findRoadSector(step, &pr.m_sector);
+        pr.m_has_future      = true;
+        pr.m_future_location = step;
+        if(pr.m_sector==Track::UNKNOWN_SECTOR)
+        {
+            pr.m_future_sector = track->findOutOfRoadSector(step,
+                                     Track::RS_DONT_KNOW, pr.m_future_sector);
+            pr.m_road = true;
+            break;
+        }
+        pr.m_future_sector = pr.m_sector;
+    }
+}   // predictRoad
+
+// ----------------------------------------------------------------------------
+/** Computes all requested predictions.
+ *  \param view The state of all karts in this frame.
+ *  \param track The track.
+ */
+void CrashPredictor::update(const AIWorldView &view, const Track *track)
+{
+    if(m_requests.size()==0) return;
+    computePaths(view);
+
+    // A negative time marks karts for which no prediction was requested.
+    m_crash_time.clear();
+    m_crash_time.resize(view.getNumKarts(), -1.0f);
+    for(unsigned int i=0; i<m_requests.size(); i++)
+    {
+        const int k = m_requests[i];
+        if(k>=view.getNumKarts() || !m_paths[k].m_active) continue;
+        Prediction &pr  = m_predictions[k];
+        pr.m_kart       = -1;
+        pr.m_road       = false;
+        pr.m_has_future = false;
+        m_crash_time[k] = 99999.9f;
+        predictRoad(k, track);
+    }
+
+    // Sweep and prune: sort the boxes by their minimum x coordinate, and
+    // only test the pairs whose boxes overlap.
+    std::vector<float> min_x(m_paths.size());
+    m_sorted.clear();
+    for(unsigned int i=0; i<m_paths.size(); i++)
+    {
+        if(!m_paths[i].m_active) continue;
+        min_x[i] = m_paths[i].m_min_x;
+        m_sorted.push_back(i);
+    }
+    std::sort(m_sorted.begin(), m_sorted.end(), PathCompare(min_x));
+    for(unsigned int i=0; i<m_sorted.size(); i++)
+    {
+        const Path &a = m_paths[m_sorted[i]];
+        for(unsigned int j=i+1; j<m_sorted.size(); j++)
+        {
+            const Path &b = m_paths[m_sorted[j]];
+            if(b.m_min_x>a.m_max_x) break;
+            if(b.m_min_y>a.m_max_y || b.m_max_y<a.m_min_y) continue;
+            testPair(m_sorted[i], m_sorted[j]);
+            testPair(m_sorted[j], m_sorted[i]);
+        }
+    }
+    m_requests.clear();
+}   // update
+
+/* EOF */
@@ -0,0 +1,101 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_CRASH_PREDICTOR_HPP
+#define HEADER_CRASH_PREDICTOR_HPP
+
+#include <vector>
+
+#include "utils/vec3.hpp"
+
+class AIWorldView;
+class Track;
+
+/** Predicts for the AI karts if they are going to crash into another kart
+ *  or get off the road, assuming that all karts keep their current
+ *  velocity. The path of each kart is a straight line in the x/y plane.
+ *  Each AI kart requests a prediction (for a number of steps of the length
+ *  of the kart) before the AI is computed, then update() computes all
+ *  predictions in one pass: the paths of all karts are only computed once,
+ *  and only pairs of karts whose swept bounding boxes overlap are tested
+ *  against each other.
+ */
+class CrashPredictor
+{
+public:
+    /** The result of a prediction. */
+    struct Prediction
+    {
+        /** Number of steps requested, 0 if no prediction is requested. */
+        int   m_num_steps;
+        /** The kart that will be hit first, or -1. */
+        int   m_kart;
+        /** True if the kart will get off the road. */
+        bool  m_road;
+        /** True if m_future_sector and m_future_location are set. */
+        bool  m_has_future;
+        /** The sector at the last step tested (the step at which the kart
+         *  gets off the road, or the last step). */
+        int   m_future_sector;
+        Vec3  m_future_location;
+        /** Sector of the last step, used as a hint in the next frame. */
+        int   m_sector;
+    };   // Prediction
+
+private:
+    /** The path of a kart in the current frame. */
+    struct Path
+    {
+        Vec3  m_xyz;
+        /** The velocity in the x/y plane. */
+        Vec3  m_velocity;
+        /** Forward speed of the kart. */
+        float m_forward_speed;
+        float m_length;
+        /** Time between two steps, i.e. to drive m_length. */
+        float m_step_time;
+        /** Bounding box of the path in the x/y plane. */
+        float m_min_x, m_max_x, m_min_y, m_max_y;
+        bool  m_active;
+    };   // Path
+
+    std::vector<Path>       m_paths;
+    std::vector<Prediction> m_predictions;
+    /** The karts for which a prediction was requested in this frame. */
+    std::vector<int>        m_requests;
+    /** Time of the first crash with a kart found so far for each kart. */
+    std::vector<float>      m_crash_time;
+    /** Indices of the active paths, sorted by m_min_x. */
+    std::vector<int>        m_sorted;
+
+    void  computePaths(const AIWorldView &view);
+    void  testPair    (int kart, int other);
+    float getCrashTime(int kart, int other) const;
+    void  predictRoad (int kart, const Track *track);
+
+public:
+         CrashPredictor() {}
+    void reset();
+    void requestPrediction(int kart, int num_steps, int future_sector);
+    void update(const AIWorldView &view, const Track *track);
+    /** Returns the prediction for the given kart, valid after update(). */
+    const Prediction &getPrediction(int kart) const {return m_predictions[kart];}
+};   // CrashPredictor
+
+#endif
+
+/* EOF */
@@ -39,11 +39,17 @@
 #include <ctime>
 #include <cstdio>
 #include <iostream>
+#include <algorithm>
 #include <plib/sg.h>
 #include "race_manager.hpp"
+#include "stk_config.hpp"
 #include "graphics/scene.hpp"
+#include "items/item_manager.hpp"
 #include "modes/linear_world.hpp"
 #include "network/network_manager.hpp"
+#include "robots/ai_properties.hpp"
+#include "robots/ai_world_view.hpp"
+#include "robots/crash_predictor.hpp"
 #include "robots/track_info.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
@@ -52,62 +58,69 @@
 const TrackInfo *DefaultRobot::m_track_info = NULL;
 int DefaultRobot::m_num_of_track_info_instances = 0;
 
+/** Number of sectors ahead of the kart in which items are considered. */
+static const int   ITEM_LOOKAHEAD_SECTORS  = 8;
+/** Maximum distance of an item to collect or avoid. */
+static const float ITEM_LOOKAHEAD_DISTANCE = 30.0f;
+/** Maximum distance of an item to collect from the line to the aim point. */
+static const float ITEM_MAX_LATERAL        = 3.0f;
+/** Approximate radius in which a kart hits an item. */
+static const float ITEM_RADIUS             = 0.9f;
+
 DefaultRobot::DefaultRobot(const std::string& kart_name,
                            int position, const btTransform& init_pos, 
                            const Track *track) :
     AutoKart(kart_name, position, init_pos)
 {
+    // The track info is now used by all AIs, so it must be counted for 
+    // each instance, otherwise it is deleted with the first AI.
     if(m_num_of_track_info_instances==0)
-    {
         m_track_info = new TrackInfo(track);
-        m_num_of_track_info_instances++;
-    }
+    m_num_of_track_info_instances++;
     reset();
     m_kart_length = m_kart_properties->getKartModel()->getLength();
     m_kart_width  = m_kart_properties->getKartModel()->getWidth();
     m_track = RaceManager::getTrack();
     m_world = dynamic_cast<LinearWorld*>(RaceManager::getWorld());
     assert(m_world != NULL);
+    m_item_manager = ItemManager::get();
     
     switch(race_manager->getDifficulty())
     {
     case RaceManager::RD_EASY:
         m_wait_for_players   = true;
-        m_max_handicap_accel = 0.9f;
         m_fallback_tactic    = FT_AVOID_TRACK_CRASH;
         m_item_tactic        = IT_TEN_SECONDS;
-        m_max_start_delay    = 0.5f;
-        m_min_steps          = 0;
-        m_skidding_threshold = 4.0f;
         m_nitro_level        = NITRO_NONE;
         m_handle_bomb        = false;
         break;
     case RaceManager::RD_MEDIUM:
         m_wait_for_players   = true;
-        m_max_handicap_accel = 0.95f;
         // FT_PARALLEL had problems on some tracks when suddenly a smaller 
         // section occurred (e.g. bridge in stone track): the AI would drive
         // over and over into the river
         m_fallback_tactic    = FT_FAREST_POINT;
         m_item_tactic        = IT_CALCULATE;
-        m_max_start_delay    = 0.4f;
-        m_min_steps          = 1;
-        m_skidding_threshold = 2.0f;
         m_nitro_level        = NITRO_SOME;
         m_handle_bomb        = true;
         break;
     case RaceManager::RD_HARD:
         m_wait_for_players   = false;
-        m_max_handicap_accel = 1.0f;
         m_fallback_tactic    = FT_FAREST_POINT;
         m_item_tactic        = IT_CALCULATE;
-        m_max_start_delay    = 0.1f;
-        m_min_steps          = 2;
-        m_skidding_threshold = 1.3f;
         m_nitro_level        = NITRO_ALL;
         m_handle_bomb        = true;
         break;
     }
+    // The numerical parameters are read from ai.data (see AIProperties).
+    const RaceManager::Difficulty d = race_manager->getDifficulty();
+    m_max_start_delay    = ai_properties->get(d, AIProperties::AP_MAX_START_DELAY);
+    m_max_handicap_accel = ai_properties->get(d, AIProperties::AP_MAX_HANDICAP_ACCEL);
+    m_min_steps          = (int)ai_properties->get(d, AIProperties::AP_MIN_STEPS);
+    m_skidding_threshold = ai_properties->get(d, AIProperties::AP_SKIDDING_THRESHOLD);
+    m_brake_angle        = ai_properties->get(d, AIProperties::AP_BRAKE_ANGLE);
+    m_curve_inside       = ai_properties->get(d, AIProperties::AP_CURVE_INSIDE);
+    m_overtake_distance  = ai_properties->get(d, AIProperties::AP_OVERTAKE_DISTANCE);
 }   // DefaultRobot
 
 //-----------------------------------------------------------------------------
@@ -117,11 +130,11 @@ DefaultRobot::DefaultRobot(const std::string& kart_name,
 DefaultRobot::~DefaultRobot()
 {
     m_num_of_track_info_instances--;
-  //m_item_to_collect = NULL;
 
     if(m_num_of_track_info_instances==0)
     {
         delete m_track_info;
+        m_track_info = NULL;
     }
 }   // ~DefaultRobot
 
@@ -130,10 +143,6 @@ DefaultRobot::~DefaultRobot()
 //line, then move forward while turning.
 void DefaultRobot::update(float dt)
 {
-    // This is used to enable firing an item backwards.
-    m_controls.m_look_back = false;
-    m_controls.m_nitro     = false;
-    m_track_sector         = m_world->m_kart_info[getWorldKartId()].m_track_sector;
     // The client does not do any AI computations.
     if(network_manager->getMode()==NetworkManager::NW_CLIENT) 
     {
@@ -144,13 +153,107 @@ void DefaultRobot::update(float dt)
     if(m_world->isStartPhase())
     {
         handleRaceStart();
+        // Spread the AI decisions of the karts over several frames.
+        m_time_till_think = stk_config->m_ai_think_interval
+                          * (getWorldKartId()%4)*0.25f;
         AutoKart::update(dt);
         return;
     }
 
-    /*Get information that is needed by more than 1 of the handling funcs*/
-    //Detect if we are going to crash with the track and/or kart
-    int steps = 0;
+    if(getSimulationLevel()==SL_KINEMATIC)
+    {
+        m_time_since_think = 0.0f;
+        updateKinematic(dt);
+        AutoKart::update(dt);
+        return;
+    }
+
+    // Apply the results of think() that modify the world.
+    if(m_has_thought)
+    {
+        if(m_rescue_requested) forceRescue();
+        m_rescue_requested = false;
+        m_has_thought      = false;
+        m_time_since_think = 0.0f;
+        m_collided         = false;
+    }
+    // The steering is updated every frame, even if the kart didn't think.
+    updateSteering(dt);
+
+    /*And obviously general kart stuff*/
+    AutoKart::update(dt);
+}   // update
+
+//-----------------------------------------------------------------------------
+/** Decides if the controls of this kart must be computed in this frame.
+ *  This is called before think(), and before any kart is updated. The AI
+ *  decisions are only made every ai-think-interval seconds (or every
+ *  lod-ai-interval seconds for karts far away from all players), in
+ *  between only the steering is updated. In an emergency the kart thinks
+ *  in every frame.
+ *  \param dt Time step.
+ */
+AutoKart::ThinkRequest DefaultRobot::needsThink(float dt)
+{
+    m_track_sector = m_world->getAIWorldView().getSector(getWorldKartId());
+    if(network_manager->getMode()==NetworkManager::NW_CLIENT ||
+       m_world->isStartPhase() || getSimulationLevel()==SL_KINEMATIC)
+        return TR_NONE;
+
+    m_time_since_think += dt;
+    m_time_till_think  -= dt;
+    ThinkRequest request = isEmergency()         ? TR_URGENT
+                         : m_time_till_think>0   ? TR_NONE
+                                                 : TR_DUE;
+    if(request!=TR_NONE)
+    {
+        // The crashes of all karts are predicted together before think()
+        // is called.
+        m_steps = m_future_sector==Track::UNKNOWN_SECTOR ? 0 : calcSteps();
+        m_world->getCrashPredictor()->requestPrediction(getWorldKartId(),
+                                                        m_steps,
+                                                        m_future_sector);
+    }
+    return request;
+}   // needsThink
+
+//-----------------------------------------------------------------------------
+/** Returns true if the kart is in a situation in which it can not wait for
+ *  its next scheduled AI decision: a crash with a kart was predicted or has
+ *  happened, the kart is off the road, it might be stuck, or it has to try
+ *  to get rid of a bomb.
+ */
+bool DefaultRobot::isEmergency() const
+{
+    if(m_crashes.m_kart!=-1 || m_collided) return true;
+    if(!m_world->getAIWorldView().isOnRoad(getWorldKartId())) return true;
+    if(getSpeed()<2.0f && !isRescue()) return true;
+    return m_handle_bomb && getAttachment()->getType()==ATTACH_BOMB;
+}   // isEmergency
+
+//-----------------------------------------------------------------------------
+/** Computes the controls of this kart. This can be called in parallel for
+ *  several karts, so only this kart's data may be modified here, anything
+ *  else is done in update() (see m_rescue_requested).
+ */
+void DefaultRobot::think()
+{
+    // Time since the controls were computed the last time.
+    const float dt = m_time_since_think;
+    m_has_thought  = true;
+    // Schedule the next decision. A decision in an emergency before the
+    // scheduled time doesn't change the schedule.
+    if(m_time_till_think<=0)
+    {
+        float interval = getSimulationLevel()==SL_REDUCED
+                       ? stk_config->m_lod_ai_interval
+                       : stk_config->m_ai_think_interval;
+        m_time_till_think = std::max(0.0f, m_time_till_think+interval);
+    }
+
+    // This is used to enable firing an item backwards.
+    m_controls.m_look_back = false;
+    m_controls.m_nitro     = false;
 
     // This should not happen (anymore), but it keeps the game running
     // in case that m_future_sector becomes undefined.
@@ -160,41 +263,40 @@ void DefaultRobot::update(float dt)
         fprintf(stderr,"DefaultRobot: m_future_sector is undefined.\n");
         fprintf(stderr,"This shouldn't happen, but can be ignored.\n");
 #endif
-        forceRescue();
-        m_future_sector = 0;
-    }
-    else
-    {
-        steps = calcSteps();
+        m_rescue_requested = true;
+        m_future_sector    = 0;
     }
+
+    /*Get information that is needed by more than 1 of the handling funcs*/
+    //Detect if we are going to crash with the track and/or kart
     computeNearestKarts();
-    checkCrashes(steps, getXYZ());
+    checkCrashes();
     findCurve();
 
     // Special behaviour if we have a bomb attach: try to hit the kart ahead 
     // of us.
     bool commands_set = false;
     if(m_handle_bomb && getAttachment()->getType()==ATTACH_BOMB && 
-       m_kart_ahead)
+       m_kart_ahead>=0)
     {
+        const AIWorldView &view = m_world->getAIWorldView();
         // Use nitro if the kart is far ahead, or faster than this kart
         m_controls.m_nitro = m_distance_ahead>10.0f || 
-                             m_kart_ahead->getSpeed() > getSpeed();
+                             view.getSpeed(m_kart_ahead) > getSpeed();
         // If we are close enough, try to hit this kart
         if(m_distance_ahead<=10)
         {
-            Vec3 target = m_kart_ahead->getXYZ();
+            Vec3 target = view.getXYZ(m_kart_ahead);
 
             // If we are faster, try to predict the point where we will hit
             // the other kart
-            if(m_kart_ahead->getSpeed() < getSpeed())
+            if(view.getSpeed(m_kart_ahead) < getSpeed())
             {
                 float time_till_hit = m_distance_ahead
-                                    / (getSpeed()-m_kart_ahead->getSpeed());
-                target += m_kart_ahead->getVelocity()*time_till_hit;
+                                    / (getSpeed()-view.getSpeed(m_kart_ahead));
+                target += view.getVelocity(m_kart_ahead)*time_till_hit;
             }
-            float steer_angle = steerToPoint(m_kart_ahead->getXYZ().toFloat(), dt);
-            setSteering(steer_angle, dt);
+            setSteerPoint(view.getXYZ(m_kart_ahead));
             commands_set = true;
         }
         handleRescue(dt);
@@ -203,8 +305,8 @@ void DefaultRobot::update(float dt)
     {
         /*Response handling functions*/
         handleAcceleration(dt);
-        handleSteering(dt);
-        handleItems(dt, steps);
+        handleSteering();
+        handleItems(dt, m_steps);
         handleRescue(dt);
         handleBraking();
         // If a bomb is attached, nitro might already be set.
@@ -220,25 +322,125 @@ void DefaultRobot::update(float dt)
         // time in time trial at start up, so during the first 5 seconds
         // this is done at random only.
         if(race_manager->getMinorMode()!=RaceManager::MINOR_MODE_TIME_TRIAL ||
-          (m_world->getTime()<3.0f && rand()%50==1))
+          (m_world->getTime()<3.0f && m_random.get(50)==1))
         {
             m_controls.m_nitro = false;
             m_controls.m_fire  = true;
         }
     }
+}   // think
 
-    /*And obviously general kart stuff*/
-    AutoKart::update(dt);
-    m_collided = false;
-}   // update
+//-----------------------------------------------------------------------------
+/** Only allows the kart to be moved kinematically if it is driving normally
+ *  on the road, otherwise it stays in the physics world.
+ *  \param level The new simulation level.
+ */
+void DefaultRobot::setSimulationLevel(SimulationLevel level)
+{
+    if(level==SL_KINEMATIC && getSimulationLevel()!=SL_KINEMATIC)
+    {
+        const KartInfo &kart_info = m_world->m_kart_info[getWorldKartId()];
+        if(m_world->isStartPhase() || isRescue() || !isOnGround()    ||
+           !kart_info.m_on_road    || getHoT()==Track::NOHIT          ||
+           m_track_sector==Track::UNKNOWN_SECTOR                      ||
+           m_track->m_driveline.size()<2 || m_zipper_time_left>0.0f  ||
+           getAttachment()->getType()!=ATTACH_NOTHING)
+            level = SL_REDUCED;
+        else
+            m_kinematic_height = getXYZ().getZ()-getHoT();
+    }
+    // Stagger the AI updates of the karts.
+    if(level==SL_REDUCED && getSimulationLevel()==SL_FULL)
+        m_time_till_think = stk_config->m_lod_ai_interval
+                          * (getWorldKartId()%4+1)*0.25f;
+    // The steering target is outdated after driving kinematically.
+    if(level!=SL_KINEMATIC && getSimulationLevel()==SL_KINEMATIC)
+        m_time_till_think = 0.0f;
+    Kart::setSimulationLevel(level);
+}   // setSimulationLevel
+
+//-----------------------------------------------------------------------------
+/** Moves the kart along the driveline without physics. This is used for
+ *  karts far away from all players: the kart drives towards the driveline
+ *  a few meters ahead with the speed the AI would try to reach, and is
+ *  placed on the terrain. Other karts and projectiles are not hit in this
+ *  mode. If the kart can't be moved this way (e.g. because there is no
+ *  terrain, or an attachment affects its speed), it is added back to the
+ *  physics world.
+ *  \param dt Time step.
+ */
+void DefaultRobot::updateKinematic(float dt)
+{
+    const unsigned int num_sectors = m_track->m_driveline.size();
+    if(m_track_sector==Track::UNKNOWN_SECTOR || 
+       getAttachment()->getType()!=ATTACH_NOTHING)
+    {
+        setSimulationLevel(SL_REDUCED);
+        return;
+    }
+
+    // Find a point on the driveline at least 5m ahead, so that the
+    // heading changes smoothly.
+    unsigned int target = m_track_sector;
+    Vec3 dir;
+    for(unsigned int i=0; i<num_sectors; i++)
+    {
+        target = (target+1)%num_sectors;
+        dir    = m_track->m_driveline[target]-getXYZ();
+        dir.setZ(0);
+        if(dir.length2()>25.0f) break;
+    }
+    if(dir.length2()<0.01f)
+    {
+        setSimulationLevel(SL_REDUCED);
+        return;
+    }
+    dir.normalize();
+
+    // Approach the speed the kart would accelerate to.
+    m_controls.m_brake = false;
+    m_controls.m_steer = 0.0f;
+    m_controls.m_drift = false;
+    handleAcceleration(dt);
+    const float target_speed = getMaxSpeedOnTerrain()*m_controls.m_accel;
+    const float speed        = getSpeed() 
+                             + (target_speed-getSpeed())*std::min(1.0f, dt);
+
+    Vec3 xyz = getXYZ()+dir*(speed*dt);
+    float hot;
+    Vec3  normal;
+    const Material *material;
+    m_track->getTerrainInfo(xyz+Vec3(0, 0, 1.0f), &hot, &normal, &material);
+    // Let the physics handle everything that isn't simple driving.
+    if(hot==Track::NOHIT || !material || material->isReset() ||
+       material->isZipper() || normal.getZ()<0.7f)
+    {
+        setSimulationLevel(SL_REDUCED);
+        return;
+    }
+    xyz.setZ(hot+m_kinematic_height);
+
+    // Align the kart with the terrain.
+    Vec3 forward = dir-normal*dir.dot(normal);
+    forward.normalize();
+    Vec3 right   = forward.cross(normal);
+    btMatrix3x3 m(right.getX(), forward.getX(), normal.getX(),
+                  right.getY(), forward.getY(), normal.getY(),
+                  right.getZ(), forward.getZ(), normal.getZ());
+    setTrans(btTransform(m, xyz));
+    setSpeed(speed);
+    // The velocity is used by other karts and the AI.
+    m_body->setLinearVelocity(forward*speed);
+}   // updateKinematic
 
 //-----------------------------------------------------------------------------
 void DefaultRobot::handleBraking()
 {
     // In follow the leader mode, the kart should brake if they are ahead of
     // the leader (and not the leader, i.e. don't have initial position 1)
+    const AIWorldView &view = m_world->getAIWorldView();
     if(race_manager->getMinorMode() == RaceManager::MINOR_MODE_FOLLOW_LEADER &&
-       getPosition() < RaceManager::getKart(0)->getPosition() &&
+       getPosition() < view.getPosition(0) &&
        getInitialPosition()>1)
     {
         m_controls.m_brake = true;
@@ -246,38 +448,36 @@ void DefaultRobot::handleBraking()
     }
         
     const float MIN_SPEED = m_track->getWidth()[m_track_sector];
-    KartInfo &kart_info   = m_world->m_kart_info[getWorldKartId()];
+    const float distance_to_center = view.getDistanceToCenter(getWorldKartId());
     //We may brake if we are about to get out of the road, but only if the
     //kart is on top of the road, and if we won't slow down below a certain
     //limit.
-    if(m_crashes.m_road && kart_info.m_on_road && getVelocityLC().getY() > MIN_SPEED)
+    if(m_crashes.m_road && view.isOnRoad(getWorldKartId()) &&
+       getVelocityLC().getY() > MIN_SPEED)
     {
         float kart_ang_diff = m_track->m_angle[m_track_sector] -
                               RAD_TO_DEGREE(getHeading());
         kart_ang_diff = normalizeAngle(kart_ang_diff);
         kart_ang_diff = fabsf(kart_ang_diff);
 
-        const float MIN_TRACK_ANGLE = 20.0f;
-        const float CURVE_INSIDE_PERC = 0.25f;
-
         //Brake only if the road does not goes somewhat straight.
-        if(m_curve_angle > MIN_TRACK_ANGLE) //Next curve is left
+        if(m_curve_angle > m_brake_angle) //Next curve is left
         {
             //Avoid braking if the kart is in the inside of the curve, but
             //if the curve angle is bigger than what the kart can steer, brake
             //even if we are in the inside, because the kart would be 'thrown'
             //out of the curve.
-            if(!(m_world->getDistanceToCenterForKart(getWorldKartId()) > m_track->getWidth()[m_track_sector] *
-                 -CURVE_INSIDE_PERC || m_curve_angle > RAD_TO_DEGREE(getMaxSteerAngle())))
+            if(!(distance_to_center > m_track->getWidth()[m_track_sector] *
+                 -m_curve_inside || m_curve_angle > RAD_TO_DEGREE(getMaxSteerAngle())))
             {
                 m_controls.m_brake = false;
                 return;
             }
         }
-        else if(m_curve_angle < -MIN_TRACK_ANGLE) //Next curve is right
+        else if(m_curve_angle < -m_brake_angle) //Next curve is right
         {
-            if(!(m_world->getDistanceToCenterForKart(getWorldKartId()) < m_track->getWidth()[m_track_sector] *
-                 CURVE_INSIDE_PERC || m_curve_angle < -RAD_TO_DEGREE(getMaxSteerAngle())))
+            if(!(distance_to_center < m_track->getWidth()[m_track_sector] *
+                 m_curve_inside || m_curve_angle < -RAD_TO_DEGREE(getMaxSteerAngle())))
             {
                 m_controls.m_brake = false;
                 return;
@@ -288,7 +488,7 @@ void DefaultRobot::handleBraking()
         //to go through the curve at the widest angle, or if the kart
         //is not going straight in relation to the road.
         if(getVelocityLC().getY() > m_curve_target_speed ||
-           kart_ang_diff > MIN_TRACK_ANGLE)
+           kart_ang_diff > m_brake_angle)
         {
 #ifdef AI_DEBUG
         std::cout << "BRAKING" << std::endl;
@@ -301,21 +501,22 @@ void DefaultRobot::handleBraking()
 }   // handleBraking
 
 //-----------------------------------------------------------------------------
-void DefaultRobot::handleSteering(float dt)
+void DefaultRobot::handleSteering()
 {
     const unsigned int DRIVELINE_SIZE = (unsigned int)m_track->m_driveline.size();
     const size_t NEXT_SECTOR = (unsigned int)m_track_sector + 1 < DRIVELINE_SIZE
                              ? m_track_sector + 1 : 0;
-    float steer_angle = 0.0f;
+
+    const AIWorldView &view = m_world->getAIWorldView();
 
     /*The AI responds based on the information we just gathered, using a
      *finite state machine.
      */
     //Reaction to being outside of the road
-    if(fabsf(m_world->getDistanceToCenterForKart(getWorldKartId())) + 0.5f >
+    if(fabsf(view.getDistanceToCenter(getWorldKartId())) + 0.5f >
        m_track->getWidth()[m_track_sector])
     {
-        steer_angle = steerToPoint(m_track->m_driveline[NEXT_SECTOR], dt);
+        setSteerPoint(m_track->m_driveline[NEXT_SECTOR]);
 
 #ifdef AI_DEBUG
         std::cout << "- Outside of road: steer to center point." <<
@@ -329,25 +530,25 @@ void DefaultRobot::handleSteering(float dt)
         //-1 = left, 1 = right, 0 = no crash.
         if(m_start_kart_crash_direction == 1)
         {
-            steer_angle = steerToAngle(NEXT_SECTOR, -M_PI*0.5f);
+            setSteerAngle(NEXT_SECTOR, -M_PI*0.5f);
             m_start_kart_crash_direction = 0;
         }
         else if(m_start_kart_crash_direction == -1)
         {
-            steer_angle = steerToAngle(NEXT_SECTOR, M_PI*0.5f);
+            setSteerAngle(NEXT_SECTOR, M_PI*0.5f);
             m_start_kart_crash_direction = 0;
         }
         else
         {
-            if(m_world->getDistanceToCenterForKart(getWorldKartId()) >
-               m_world->getDistanceToCenterForKart(m_crashes.m_kart))
+            if(view.getDistanceToCenter(getWorldKartId()) >
+               view.getDistanceToCenter(m_crashes.m_kart))
             {
-                steer_angle = steerToAngle(NEXT_SECTOR, -M_PI*0.5f);
+                setSteerAngle(NEXT_SECTOR, -M_PI*0.5f);
                 m_start_kart_crash_direction = 1;
             }
             else
             {
-                steer_angle = steerToAngle(NEXT_SECTOR, M_PI*0.5f);
+                setSteerAngle(NEXT_SECTOR, M_PI*0.5f);
                 m_start_kart_crash_direction = -1;
             }
         }
@@ -368,20 +569,21 @@ void DefaultRobot::handleSteering(float dt)
             {
                 Vec3 straight_point;
                 findNonCrashingPoint(straight_point);
-                steer_angle = steerToPoint(straight_point, dt);
+                handleItemCollectionAndAvoidance(&straight_point);
+                setSteerPoint(straight_point);
             }
             break;
 
         case FT_PARALLEL:
-            steer_angle = steerToAngle(NEXT_SECTOR, 0.0f);
+            setSteerAngle(NEXT_SECTOR, 0.0f);
             break;
 
         case FT_AVOID_TRACK_CRASH:
             if(m_crashes.m_road)
             {
-                steer_angle = steerToAngle(m_track_sector, 0.0f);
+                setSteerAngle(m_track_sector, 0.0f);
             }
-            else steer_angle = 0.0f;
+            else m_steer_mode = STEER_STRAIGHT;
 
             break;
         }
@@ -389,81 +591,57 @@ void DefaultRobot::handleSteering(float dt)
 #ifdef AI_DEBUG
         std::cout << "- Fallback."  << std::endl;
 #endif
-        // Potentially adjust the point to aim for in order to either
-        // aim to collect item, or steer to avoid a bad item.
-        //if(m_item_behaviour!=ITEM_COLLECT_NONE)
-        //handleItemCollectionAndAvoidance(straight_point, last_node);
-
     }
-    setSteering(steer_angle, dt);
 }   // handleSteering
 
 //-----------------------------------------------------------------------------
-/*void DefaultRobot::handleItemCollectionAndAvoidance(Vec3 *straight_point, int m_sector)
+/** Adjusts the point to aim for in order to either collect an item, or to
+ *  steer around a bad item (banana, bubble gum) on the way to the point.
+ *  Only the items in the next sectors are evaluated, using the item lists
+ *  of the item manager, so the cost doesn't depend on the number of items
+ *  on the track.
+ *  \param straight_point The point the kart drives to, which is modified.
+ */
+void DefaultRobot::handleItemCollectionAndAvoidance(Vec3 *straight_point)
 {
-    const unsigned int DRIVELINE_SIZE = (unsigned int)m_track->m_driveline.size();
-    const size_t NEXT_SECTOR = (unsigned int)m_track_sector + 1 < DRIVELINE_SIZE 
-                             ? m_track_sector + 1 : 0;
-
-    // Angle of line from kart to aim_point
-    float kart_aim_angle = atan2(straight_point->getX()- getXYZ().getX(),
-                                 straight_point->getY()- getXYZ().getY());
-
-    if(m_item_to_collect)
-    {
-        if(handleSelectedItem(kart_aim_angle, straight_point, m_sector))
-        {
-            // Still aim at the previsouly selected item.
-            *straight_point = m_item_to_collect->getXYZ();
-            return;
-        }
-        // Otherwise remove the pre-selected item (and start
-        // looking for a new item).
-         m_item_to_collect = NULL;
-    } // m_item_to_collect
-
-    // Make sure we have a valid sector
-    if(m_sector==Track::UNKNOWN_SECTOR)
-       m_sector = NEXT_SECTOR;
-
-    int sector = m_track_sector;
-    float distance = 0;
-    const Item *item_to_collect = NULL;
-    const Item *item_to_avoid   = NULL;
-
-    const float max_item_lookahead_distance = 30.f;
-    while(distance < max_item_lookahead_distance)
+    if(m_track_sector==Track::UNKNOWN_SECTOR) return;
+    Vec3 aim  = *straight_point - getXYZ();
+    aim.setZ(0.0f);
+    const float distance = aim.length();
+    if(distance<=0.0f) return;
+
+    ItemManager::AIItemQuery query;
+    query.m_xyz           = getXYZ();
+    query.m_aim           = aim/distance;
+    query.m_max_distance  = std::min(distance, ITEM_LOOKAHEAD_DISTANCE);
+    query.m_max_lateral   = ITEM_MAX_LATERAL;
+    query.m_avoid_lateral = 0.5f*m_kart_width + ITEM_RADIUS;
+    for(int i=0; i<=Item::ITEM_NONE; i++)
+        query.m_weight[i] = 0.0f;
+    // A bonus box is less useful if the kart has a powerup already.
+    query.m_weight[Item::ITEM_BONUS_BOX]   =
+        m_powerup.getType()==POWERUP_NOTHING ? 1.0f : 0.2f;
+    query.m_weight[Item::ITEM_BIG_NITRO]   = 0.8f;
+    query.m_weight[Item::ITEM_SMALL_NITRO] = 0.4f;
+    query.m_weight[Item::ITEM_BANANA]      = -1.0f;
+    query.m_weight[Item::ITEM_BUBBLEGUM]   = -1.0f;
+    m_item_manager->evaluateAIItems(&query, m_track_sector,
+                                    ITEM_LOOKAHEAD_SECTORS);
+
+    if(query.m_avoid)
     {
-        int s_index = m_track_mesh;
-        const std::vector<Item *> &items_ahead = item->getXYZ();
-            ItemManager::get()->getItemsInQuads(s_index);
-        for(unsigned int i=0; i<items_ahead.size(); i++)
-        {
-            evaluateItems(items_ahead[i],  kart_aim_angle, 
-                          &item_to_avoid, &item_to_collect);
-        }   // for i<items_ahead;
-        distance += sgDistanceVec2
-                   (m_track->m_driveline[sector], m_track->m_driveline[NEXT_SECTOR]); 
-
-        sector = m_track->m_driveline[NEXT_SECTOR];
-        // Stop when we have reached the last quad
-        if(sector==m_sector) break;
-    }   // while (distance < max_item_lookahead_distance)
-
-    sgFloat Line1
-    sgFloat Line2;
-    Line1 = sgSetVec2(30.f, getXYZ().getX(), getXYZ().getY());
-    Line2 = sgSetVec2(30.f, straight_point->getX(), straight_point->getY());
-    sgVec2 *line_to_target = Line1 + Line2;
-
+        // Pass the item on the other side of the line to the aim point.
+        const Vec3 &xyz = query.m_avoid->getXYZ();
+        const Vec3 side(query.m_aim.getY(), -query.m_aim.getX(), 0.0f);
+        const float lateral = (xyz-getXYZ()).dot(side);
+        *straight_point = xyz + side*(lateral>0 ? -query.m_avoid_lateral
+                                                :  query.m_avoid_lateral);
+        return;
+    }
+    if(query.m_collect)
+        *straight_point = query.m_collect->getXYZ();
+}   // handleItemCollectionAndAvoidance
 
-    if(item_to_collect)
-    {
-        sgFloat collect(item_to_collect->getXYZ().getX(),
-                                item_to_collect->getXYZ().getY());
-        core::vector2df cp = line_to_target.getClosestPoint(collect);
-        Vec3 xyz(cp.X, item_to_collect->getXYZ().getY(), cp.Y);
-}//*/
 //-----------------------------------------------------------------------------
 void DefaultRobot::handleItems(const float DELTA, const int STEPS)
 {
@@ -514,9 +692,9 @@ void DefaultRobot::handleItems(const float DELTA, const int STEPS)
         {
             // Since cakes can be fired all around, just use a sane distance
             // with a bit of extra for backwards, as enemy will go towards cake
-            bool fire_backwards = (m_kart_behind && m_kart_ahead &&
+            bool fire_backwards = (m_kart_behind>=0 && m_kart_ahead>=0 &&
                                    m_distance_behind < m_distance_ahead) ||
-                                  !m_kart_ahead;
+                                  m_kart_ahead<0;
             float distance = fire_backwards ? m_distance_behind
                                             : m_distance_ahead;
             m_controls.m_fire = (fire_backwards && distance < 25.0f)     ||
@@ -531,9 +709,9 @@ void DefaultRobot::handleItems(const float DELTA, const int STEPS)
             // Bowling balls slower, so only fire on closer karts - but when
             // firing backwards, the kart can be further away, since the ball
             // acts a bit like a mine (and the kart is racing towards it, too)
-            bool fire_backwards = (m_kart_behind && m_kart_ahead && 
+            bool fire_backwards = (m_kart_behind>=0 && m_kart_ahead>=0 && 
                                    m_distance_behind < m_distance_ahead) ||
-                                  !m_kart_ahead;
+                                  m_kart_ahead<0;
             float distance = fire_backwards ? m_distance_behind 
                                             : m_distance_ahead;
             m_controls.m_fire = ( fire_backwards && distance < 30.0f)    || 
@@ -547,9 +725,9 @@ void DefaultRobot::handleItems(const float DELTA, const int STEPS)
         {
             // Plungers can be fired backwards and are faster,
             // so allow more distance for shooting.
-            bool fire_backwards = (m_kart_behind && m_kart_ahead && 
+            bool fire_backwards = (m_kart_behind>=0 && m_kart_ahead>=0 && 
                                    m_distance_behind < m_distance_ahead) ||
-                                  !m_kart_ahead;
+                                  m_kart_ahead<0;
             float distance = fire_backwards ? m_distance_behind 
                                             : m_distance_ahead;
             m_controls.m_fire = distance < 30.0f                         || 
@@ -582,37 +760,38 @@ void DefaultRobot::handleItems(const float DELTA, const int STEPS)
  */
 void DefaultRobot::computeNearestKarts()
 {
+    const AIWorldView &view = m_world->getAIWorldView();
     bool need_to_check = false;
     int my_position    = getPosition();
     // See if the kart ahead has changed:
-    if((m_kart_ahead && m_kart_ahead->getPosition()+1!=my_position) ||
-      (!m_kart_ahead && my_position>1))
+    if((m_kart_ahead>=0 && view.getPosition(m_kart_ahead)+1!=my_position) ||
+      (m_kart_ahead<0 && my_position>1))
        need_to_check = true;
     // See if the kart behind has changed:
-    if((m_kart_behind && m_kart_behind->getPosition()-1!=my_position) ||
-      (!m_kart_behind && my_position<(int)m_world->getCurrentNumKarts()))
+    if((m_kart_behind>=0 && view.getPosition(m_kart_behind)-1!=my_position) ||
+      (m_kart_behind<0 && my_position<(int)m_world->getCurrentNumKarts()))
         need_to_check = true;
     if(!need_to_check) return;
 
-    m_kart_behind    = m_kart_ahead      = NULL;
+    m_kart_behind    = m_kart_ahead      = -1;
     m_distance_ahead = m_distance_behind = 9999999.9f;
-    float my_dist = m_world->getDistanceDownTrackForKart(getWorldKartId());
-    for(unsigned int i=0; i<race_manager->getNumKarts(); i++)
+    const int me  = getWorldKartId();
+    float my_dist = view.getDistanceDownTrack(me);
+    for(int i=0; i<view.getNumKarts(); i++)
     {
-        Kart *k = m_world->getKart(i);
-        if(k->isEliminated() || k==this) continue;
-        if(k->getPosition()==my_position+1) 
+        if(view.isEliminated(i) || i==me) continue;
+        if(view.getPosition(i)==my_position+1) 
         {
-            m_kart_behind = k;
-            m_distance_behind = my_dist - m_world->getDistanceDownTrackForKart(i);
+            m_kart_behind = i;
+            m_distance_behind = my_dist - view.getDistanceDownTrack(i);
             if(m_distance_behind<0.0f)
                 m_distance_behind += m_track->getTrackLength();
         }
         else 
-            if(k->getPosition()==my_position-1)
+            if(view.getPosition(i)==my_position-1)
             {
-                m_kart_ahead = k;
-                m_distance_ahead = m_world->getDistanceDownTrackForKart(i) - my_dist;
+                m_kart_ahead = i;
+                m_distance_ahead = view.getDistanceDownTrack(i) - my_dist;
                 if(m_distance_ahead<0.0f)
                     m_distance_ahead += m_track->getTrackLength();
             }
@@ -673,11 +852,9 @@ void DefaultRobot::handleRaceStart()
     //5% in medium and less than 1% of the karts in hard.
     if(m_time_till_start <  0.0f)
     {
-        srand((unsigned)time(0));
-
         //Each kart starts at a different, random time, and the time is
         //smaller depending on the difficulty.
-        m_time_till_start = (float)rand() / RAND_MAX * m_max_start_delay;
+        m_time_till_start = m_random.getFloat() * m_max_start_delay;
     }
 }   // handleRaceStart
 
@@ -690,8 +867,8 @@ void DefaultRobot::handleRescue(const float DELTA)
         m_time_since_stuck += DELTA;
         if(m_time_since_stuck > 2.0f)
         {
-            forceRescue();
-            m_time_since_stuck=0.0f;
+            m_rescue_requested = true;
+            m_time_since_stuck = 0.0f;
         }   // m_time_since_stuck > 2.0f
     }
     else
@@ -753,7 +930,8 @@ void DefaultRobot::handleNitroAndZipper()
     // anyway. Since the kart is faster with nitro, estimate a 50% time
     // decrease (additionally some nitro will be saved when top speed
     // is reached).
-    if(m_world->getLapForKart(getWorldKartId())==race_manager->getNumLaps()-1 &&
+    const AIWorldView &view = m_world->getAIWorldView();
+    if(view.getLap(getWorldKartId())==race_manager->getNumLaps()-1 &&
        m_nitro_level == NITRO_ALL)
     {
         float finish = m_world->getEstimatedFinishTime(getWorldKartId());
@@ -764,22 +942,18 @@ void DefaultRobot::handleNitroAndZipper()
         }
     }
 
-    // A kart within this distance is considered to be overtaking (or to be
-    // overtaken).
-    const float overtake_distance = 10.0f;
-
     // Try to overtake a kart that is close ahead, except 
     // when we are already much faster than that kart
     // --------------------------------------------------
-    if(m_kart_ahead && m_distance_ahead < overtake_distance &&
-       m_kart_ahead->getSpeed()+5.0f > getSpeed())
+    if(m_kart_ahead>=0 && m_distance_ahead < m_overtake_distance &&
+       view.getSpeed(m_kart_ahead)+5.0f > getSpeed())
     {
         m_controls.m_nitro = true;
         return;
     }
 
-    if(m_kart_behind && m_distance_behind < overtake_distance &&
-       m_kart_behind->getSpeed() > getSpeed())
+    if(m_kart_behind>=0 && m_distance_behind < m_overtake_distance &&
+       view.getSpeed(m_kart_behind) > getSpeed())
     {
         // Only prevent overtaking on highest level
         m_controls.m_nitro = m_nitro_level==NITRO_ALL;
@@ -788,21 +962,54 @@ void DefaultRobot::handleNitroAndZipper()
 }   // handleNitroAndZipper
 
 //-----------------------------------------------------------------------------
-float DefaultRobot::steerToAngle(const size_t SECTOR, const float ANGLE)
+/** Lets the kart steer towards a point till the next AI decision.
+ *  \param point The point to steer to.
+ */
+void DefaultRobot::setSteerPoint(const Vec3 &point)
 {
-    float angle = m_track->m_angle[SECTOR];
-
-    //Desired angle minus current angle equals how many angles to turn
-    float steer_angle = angle - getHeading();
+    m_steer_mode  = STEER_TO_POINT;
+    m_steer_point = point;
+}   // setSteerPoint
 
+//-----------------------------------------------------------------------------
+/** Lets the kart steer towards the direction of the track (plus an angle)
+ *  at a certain sector till the next AI decision.
+ *  \param SECTOR The sector of the driveline.
+ *  \param ANGLE  The angle to add to the direction of the track.
+ */
+void DefaultRobot::setSteerAngle(const size_t SECTOR, const float ANGLE)
+{
+    m_steer_mode    = STEER_TO_HEADING;
+    m_steer_heading = m_track->m_angle[SECTOR];
     if(hasViewBlockedByPlunger())
-        steer_angle += ANGLE/5;
+        m_steer_heading += ANGLE/5;
     else
-        steer_angle += ANGLE;
-    steer_angle = normalizeAngle(steer_angle);
+        m_steer_heading += ANGLE;
+}   // setSteerAngle
 
-    return steer_angle;
-}   // steerToAngle
+//-----------------------------------------------------------------------------
+/** Updates the steering towards the target set by the last AI decision.
+ *  This is cheap and done every frame, so that the kart steers correctly
+ *  even if the AI decisions are made less often.
+ *  \param dt Time step.
+ */
+void DefaultRobot::updateSteering(float dt)
+{
+    float steer_angle = 0.0f;
+    switch(m_steer_mode)
+    {
+    case STEER_TO_POINT:
+        steer_angle = steerToPoint(m_steer_point, dt);
+        break;
+    case STEER_TO_HEADING:
+        //Desired angle minus current angle equals how many angles to turn
+        steer_angle = normalizeAngle(m_steer_heading - getHeading());
+        break;
+    case STEER_STRAIGHT:
+        break;
+    }
+    setSteering(steer_angle, dt);
+}   // updateSteering
 
 //-----------------------------------------------------------------------------
 /** Computes the steering angle to reach a certain point. Note that the
@@ -857,196 +1064,61 @@ float DefaultRobot::steerToPoint(const Vec3 point, float dt)
 }   // steerToPoint
 
 //-----------------------------------------------------------------------------
-void DefaultRobot::checkCrashes(const int STEPS, const Vec3& pos)
+void DefaultRobot::checkCrashes()
 {
     // Right now there are 2 kind of 'crashes': with other karts and another
-    // with the track. The sight line is used to find if the karts crash with
-    // each other, but the first step is twice as big as other steps to avoid
-    // having karts too close in any direction. The crash with the track can
-    // tell when a kart is going to get out of the track so it steers.
-    Vec3 vel_normal;
-
-    // This is first used as a 2d-vector, but later on it is passed
-    // to m_track->findRoadSector, there it is used as a 3d-vector
-    // to find distance to plane, so z must be initialized to zero.
-    Vec3 step_coord;
-    float kart_distance;
-
-    step_coord.setZ(0.0);
-
-    m_crashes.clear();
-
-    const size_t NUM_KARTS = race_manager->getNumKarts();
-
-    // Protection against having vel_normal with nan values
-    const Vec3 &VEL = getVelocity();
-    vel_normal.setValue(VEL.getX(), VEL.getY(), 0.0);
-    float len=vel_normal.length();
-    // If the velocity is zero, no sense in checking for crashes in time
-    if(len==0) return;
-
-    // Time it takes to drive for m_kart_length units.
-    float dt = m_kart_length / len; 
-    vel_normal/=len;
-
-    for(int i=1; STEPS>i; ++i)
+    // with the track. Both are computed for all karts together by the
+    // crash predictor (see needsThink()), here only the results are used.
+    const CrashPredictor::Prediction &prediction = 
+        m_world->getCrashPredictor()->getPrediction(getWorldKartId());
+    m_crashes.m_kart = prediction.m_kart;
+    m_crashes.m_road = prediction.m_road;
+    if(prediction.m_has_future)
     {
-        step_coord = pos + vel_normal* m_kart_length * float(i);
-
-        // Find if we crash with any kart, as long as we haven't found one yet.
-        if(m_crashes.m_kart == -1)
-        {
-            for(unsigned int j=0; j<NUM_KARTS; ++j)
-            {
-                const Kart* kart = RaceManager::getKart(j);
-                if(kart==this||kart->isEliminated()) continue;   // ignore eliminated karts
-                const Kart *other_kart = RaceManager::getKart(j);
-                Vec3 other_kart_xyz = other_kart->getXYZ() + other_kart->getVelocity()*(i*dt);
-                kart_distance = (step_coord - other_kart_xyz).length_2d();
-
-                if(kart_distance < m_kart_length &&
-                   getVelocityLC().getY() > other_kart->getVelocityLC().getY())
-                   m_crashes.m_kart = j;
-            }
-        }
-
-        /*Find if we crash with the drivelines*/
-        m_track->findRoadSector(step_coord, &m_sector);
-
-#undef SHOW_FUTURE_PATH
-#ifdef SHOW_FUTURE_PATH
-
-        ssgaSphere *sphere = new ssgaSphere;
-
-#ifdef ERASE_PATH
-        static ssgaSphere *last_sphere = 0;
-
-        if(last_sphere) scene->remove(last_sphere);
-
-        last_sphere = sphere;
-#endif
-
-        sgVec3 center;
-        center[0] = step_coord[0];
-        center[1] = step_coord[1];
-        center[2] = pos[2];
-        sphere->setCenter(center);
-        sphere->setSize(m_kart_properties->getKartModel()->getLength());
-        if(m_sector == Track::UNKNOWN_SECTOR)
-        {
-            sgVec4 colour;
-            colour[0] = colour[3] = 255;
-            colour[1] = colour[2] = 0;
-            sphere->setColour(colour);
-        }
-        else if(i==1)
-        {
-            sgVec4 colour;
-            colour[0] = colour[1] = colour[2] = 0;
-            colour[3] = 255;
-            sphere->setColour(colour);
-        }
-        scene->add(sphere);
-#endif
-        m_future_location[0] = step_coord[0]; 
-        m_future_location[1] = step_coord[1];
-
-        if(m_sector == Track::UNKNOWN_SECTOR)
-        {
-            m_future_sector = m_track->findOutOfRoadSector(step_coord,
-            Track::RS_DONT_KNOW, m_future_sector);
-            m_crashes.m_road = true;
-            break;
-        }
-        else
-        {
-            m_future_sector = m_sector;
-        }
+        m_future_sector      = prediction.m_future_sector;
+        m_future_location[0] = prediction.m_future_location.getX();
+        m_future_location[1] = prediction.m_future_location.getY();
     }
 }   // checkCrashes
 
 //-----------------------------------------------------------------------------
 /** Find the sector that at the longest distance from the kart, that can be
- *  driven to without crashing with the track, then find towards which of
- *  the two edges of the track is closest to the next curve after wards,
- *  and return the position of that edge.
+ *  driven to without crashing with the track, and return the point of the
+ *  racing line in that sector (which is closer to the inner edge of the
+ *  next curve).
  */
 void DefaultRobot::findNonCrashingPoint(sgVec2 result)
 {
-    const unsigned int DRIVELINE_SIZE = (unsigned int)m_track->m_driveline.size();
-    
-    unsigned int sector = (unsigned int)m_track_sector + 1 < DRIVELINE_SIZE 
-                        ? m_track_sector + 1 : 0;
-    int target_sector;
-
-    Vec3 direction;
-    Vec3 step_track_coord;
-    float distance;
-    int steps;
-
-    //We exit from the function when we have found a solution
-    while(1)
-    {
-        //target_sector is the sector at the longest distance that we can drive
-        //to without crashing with the track.
-        target_sector = sector + 1 < DRIVELINE_SIZE ? sector + 1 : 0;
-
-        //direction is a vector from our kart to the sectors we are testing
-        direction = m_track->m_driveline[target_sector] - getXYZ();
-
-        float len=direction.length_2d();
-        steps = int(len / m_kart_length);
-        if(steps < 3) steps = 3;
-
-        //Protection against having vel_normal with nan values
-        if(len>0.0f) {
-            direction*= 1.0f/len;
-        }
-        Vec3 step_coord;
-        //Test if we crash if we drive towards the target sector
-        for(int i=2; i<steps; ++i)
-        {
-            step_coord = getXYZ()+direction*m_kart_length * float(i);
-
-            m_track->spatialToTrack(step_track_coord, step_coord,
-                                    sector);
-
-            distance = step_track_coord[0] > 0.0f ? step_track_coord[0]
-                       : -step_track_coord[0];
-
-            //If we are outside, the previous sector is what we are looking for
-            if(distance + m_kart_width * 0.5f > m_track->getWidth()[sector])
-            {
-                sgCopyVec2(result, m_track->m_driveline[sector]);
+    // The furthest sector that can be reached in a straight line is taken
+    // from the precomputed visibility table.
+    const int start  = m_track_sector==Track::UNKNOWN_SECTOR ? 0 
+                                                            : m_track_sector;
+    const int sector = m_track_info->getVisibleSector(start, getXYZ());
+    sgCopyVec2(result, m_track_info->getRacingLine(sector).toFloat());
 
 #ifdef SHOW_NON_CRASHING_POINT
-                ssgaSphere *sphere = new ssgaSphere;
+    ssgaSphere *sphere = new ssgaSphere;
 
-                static ssgaSphere *last_sphere = 0;
+    static ssgaSphere *last_sphere = 0;
 
-                if(last_sphere) scene->remove(last_sphere);
+    if(last_sphere) scene->remove(last_sphere);
 
-                last_sphere = sphere;
+    last_sphere = sphere;
 
-                sgVec3 center;
-                center[0] = result[0];
-                center[1] = result[1];
-                center[2] = getXYZ().getZ();
-                sphere->setCenter(center);
-                sphere->setSize(0.5f);
+    sgVec3 center;
+    center[0] = result[0];
+    center[1] = result[1];
+    center[2] = getXYZ().getZ();
+    sphere->setCenter(center);
+    sphere->setSize(0.5f);
 
-                sgVec4 colour;
-                colour[1] = colour[3] = 255;
-                colour[0] = colour[2] = 0;
-                sphere->setColour(colour);
+    sgVec4 colour;
+    colour[1] = colour[3] = 255;
+    colour[0] = colour[2] = 0;
+    sphere->setColour(colour);
 
-                scene->add(sphere);
+    scene->add(sphere);
 #endif
-                return;
-            }
-        }
-        sector = target_sector;
-    }
 }   // findNonCrashingPoint
 
 //-----------------------------------------------------------------------------
@@ -1054,7 +1126,7 @@ void DefaultRobot::reset()
 {
     m_time_since_last_shot       = 0.0f;
     m_start_kart_crash_direction = 0;
-    m_sector                     = Track::UNKNOWN_SECTOR;
+    m_steps                      = 0;
     m_inner_curve                = 0;
     m_curve_target_speed         = getMaxSpeedOnTerrain();
     m_curve_angle                = 0.0;
@@ -1065,10 +1137,17 @@ void DefaultRobot::reset()
     m_crash_time                 = 0.0f;
     m_collided                   = false;
     m_time_since_stuck           = 0.0f;
-    m_kart_ahead                 = NULL;
+    m_kart_ahead                 = -1;
     m_distance_ahead             = 0.0f;
-    m_kart_behind                = NULL;
+    m_kart_behind                = -1;
     m_distance_behind            = 0.0f;
+    m_time_till_think            = 0.0f;
+    m_time_since_think           = 0.0f;
+    m_kinematic_height           = 0.0f;
+    m_has_thought                = false;
+    m_rescue_requested           = false;
+    m_steer_mode                 = STEER_STRAIGHT;
+    m_steer_heading              = 0.0f;
 
     AutoKart::reset();
 }   // reset
@@ -1151,102 +1230,22 @@ void DefaultRobot::setSteering(float angle, float dt)
     }
 }   // setSteering
 
-//-----------------------------------------------------------------------------
-/** Finds the approximate radius of a track's curve. It needs two arguments,
- *  the number of the drivepoint that marks the beginning of the curve, and
- *  the number of the drivepoint that marks the ending of the curve.
- *
- *  Based on that you can construct any circle out of 3 points in it, we use
- *  the two arguments to use the drivelines as the first and last point; the
- *  middle sector is averaged.
- */
-float DefaultRobot::getApproxRadius(const int START, const int END) const
-{
-    const int MIDDLE = (START + END) / 2;
-
-    //If the START and END sectors are very close, their average will be one
-    //of them, and using twice the same point just generates a huge radius
-    //(too big to be of any use) but it also can generate a division by zero,
-    //so here is some special handling for that case.
-    if(MIDDLE == START || MIDDLE == END) return 99999.0f;
-
-    float X1, Y1, X2, Y2, X3, Y3;
-
-    //The next line is just to avoid compiler warnings.
-    X1 = X2 = X3 = Y1 = Y2 = Y3 = 0.0f;
-    if(m_inner_curve == -1)
-    {
-        X1 = m_track->m_left_driveline[START][0];
-        Y1 = m_track->m_left_driveline[START][1];
-
-        X2 = m_track->m_left_driveline[MIDDLE][0];
-        Y2 = m_track->m_left_driveline[MIDDLE][1];
-
-        X3 = m_track->m_left_driveline[END][0];
-        Y3 = m_track->m_left_driveline[END][1];
-    }
-    else if(m_inner_curve == 0)
-    {
-        X1 = m_track->m_driveline[START][0];
-        Y1 = m_track->m_driveline[START][1];
-
-        X2 = m_track->m_driveline[MIDDLE][0];
-        Y2 = m_track->m_driveline[MIDDLE][1];
-
-        X3 = m_track->m_driveline[END][0];
-        Y3 = m_track->m_driveline[END][1];
-    }
-    else if(m_inner_curve == 1)
-    {
-        X1 = m_track->m_right_driveline[START][0];
-        Y1 = m_track->m_right_driveline[START][1];
-
-        X2 = m_track->m_right_driveline[MIDDLE][0];
-        Y2 = m_track->m_right_driveline[MIDDLE][1];
-
-        X3 = m_track->m_right_driveline[END][0];
-        Y3 = m_track->m_right_driveline[END][1];
-    }
-
-    const float A = X2 - X1;
-    const float B = Y2 - Y1;
-    const float C = X3 - X1;
-    const float D = Y3 - Y1;
-
-    const float E = A * (X1+X2) + B * (Y1+Y2);
-    const float F = C * (X1+X3) + D * (Y1+Y3);
-
-    const float G = 2.0f * (A*(Y3-Y2) - B*(X3-X2));
-
-    const float pX = (D*E - B*F) / G;
-    const float pY = (A*F - C*E) / G;
-
-    const float radius = sqrt((X1-pX) * (X1-pX) + (Y1-pY) * (Y1-pY));
-
-    return radius;
-}   // getApproxRadius
-
 //-----------------------------------------------------------------------------
 /**FindCurve() gathers info about the closest sectors ahead: the curve
  * angle, the direction of the next turn, and the optimal speed at which the
  * curve can be travelled at it's widest angle.
  *
  * The number of sectors that form the curve is dependant on the kart's speed.
+ * The sectors and the target speed are looked up in the precomputed tables
+ * of the TrackInfo object.
  */
 void DefaultRobot::findCurve()
 {
-    const int DRIVELINE_SIZE = (unsigned int)m_track->m_driveline.size();
-    float total_dist = 0.0f;
-    int next_hint    = m_track_sector + 1;
-    int i;
-
-    for(i = m_track_sector; total_dist < getVelocityLC().getY(); i = next_hint)
-    {
-        next_hint = i + 1 < DRIVELINE_SIZE ? i + 1 : 0;
-        total_dist += sgDistanceVec2(m_track->m_driveline[i], m_track->m_driveline[next_hint]);
-    }
+    int i = m_track_info->getSectorAhead(m_track_sector, 
+                                         getVelocityLC().getY());
     m_curve_angle = normalizeAngle(m_track->m_angle[i] - m_track->m_angle[m_track_sector]);
     m_inner_curve = m_curve_angle > 0.0 ? -1 : 1;
 
-    m_curve_target_speed = getMaxSpeedOnTerrain();
+    m_curve_target_speed = std::min(getMaxSpeedOnTerrain(),
+                                    m_track_info->getTargetSpeed(m_track_sector));
 }   // findCurve
@@ -20,7 +20,9 @@
 #define HEADER_DEFAULT_H
 
 #include "karts/auto_kart.hpp"
+#include "utils/random_generator.hpp"
 
+class ItemManager;
 class Track;
 class LinearWorld;
 class TrackInfo;
@@ -87,15 +89,15 @@ private:
     float m_crash_time;
     int   m_collided;           // true if the kart collided with the track
 
-    /** Pointer to the closest kart ahead of this kart. NULL if this
+    /** World id of the closest kart ahead of this kart. -1 if this
      *  kart is first. */
-    Kart *m_kart_ahead;
+    int   m_kart_ahead;
     /** Distance to the kart ahead. */
     float m_distance_ahead;
 
-    /** Pointer to the closest kart behind this kart. NULL if this kart
+    /** World id of the closest kart behind this kart. -1 if this kart
      *  is last. */
-    Kart *m_kart_behind;
+    int   m_kart_behind;
     /** Distance to the kard behind. */
     float m_distance_behind;
 
@@ -118,6 +120,10 @@ private:
 
     /** Keep a pointer to world. */
     LinearWorld *m_world;
+
+    /** The item manager of the race, used to find items to collect
+     *  or avoid. */
+    const ItemManager *m_item_manager;
     /** Cache kart_info.m_track_sector. */
     int   m_track_sector;
 
@@ -131,6 +137,9 @@ private:
 
     /** Cache width of kart. */
     float m_kart_width;
+    /** Random number generator used by this AI, independent of the
+     *  generators used for items etc. */
+    RandomGenerator m_random;
     /** All AIs share the track info object, so that its information needs 
      *  only to be computed once. */
     static const TrackInfo *m_track_info;
@@ -145,40 +154,75 @@ private:
      */
     float m_skidding_threshold;
 
-    int   m_sector;
+    /** The AI only brakes for a curve if the curve angle (or the angle
+     *  between kart and track) is bigger than this angle (in degrees). */
+    float m_brake_angle;
+
+    /** The AI does not brake if it is this fraction of the track width on
+     *  the inside of a curve. */
+    float m_curve_inside;
+
+    /** A kart within this distance is considered to be overtaking (or to be
+     *  overtaken), which triggers the use of nitro. */
+    float m_overtake_distance;
+
+    /** Number of steps for which the crashes are predicted. */
+    int   m_steps;
+
+    /** Time till the next scheduled AI decision. */
+    float m_time_till_think;
+
+    /** Time since the last AI update. */
+    float m_time_since_think;
+
+    /** Height of the kart above the terrain while it is moved kinematically. */
+    float m_kinematic_height;
+
+    /** True if think() was called in this frame. */
+    bool  m_has_thought;
+
+    /** Set by think() if the kart must be rescued. The rescue is done in
+     *  update(), since think() must not modify the world. */
+    bool  m_rescue_requested;
+
+    /** What the kart steers towards till the next AI decision. */
+    enum {STEER_STRAIGHT, STEER_TO_POINT, STEER_TO_HEADING} m_steer_mode;
+
+    /** The point to steer to if m_steer_mode is STEER_TO_POINT. */
+    Vec3  m_steer_point;
+
+    /** The heading to steer to if m_steer_mode is STEER_TO_HEADING. */
+    float m_steer_heading;
 
     /*Functions called directly from update(). They all represent an action
      *that can be done, and end up setting their respective m_controls
      *variable, except handle_race_start() that isn't associated with any
      *specific action (more like, associated with inaction).
      */
+    void  updateKinematic(float dt);
     void  handleRaceStart();
     void  handleAcceleration(const float DELTA);
-    void  handleSteering(float dt);
+    void  handleSteering();
     void  handleItems(const float DELTA, const int STEPS);
     void  handleRescue(const float DELTA);
     void  handleBraking();
     void  handleNitroAndZipper();
     void  computeNearestKarts();
-    void  handleItemCollectionAndAvoidance(Vec3 *straight_point,
-                                           int m_sector);
-    bool  handleSelectedItem(float kart_aim_angle,
-                             Vec3 *straight_point, int m_sector);
-    void  evaluateItems(const Item *item, float kart_aim_angle, 
-                        const Item **item_to_avoid, 
-                        const Item **item_to_collect);
+    void  handleItemCollectionAndAvoidance(Vec3 *straight_point);
 
     /* Lower level functions not called directly from update() */
-    float steerToAngle(const size_t SECTOR, const float ANGLE);
+    void  setSteerAngle(const size_t SECTOR, const float ANGLE);
+    void  setSteerPoint(const Vec3 &point);
     float steerToPoint(const Vec3 point, float dt);
 
-    void  checkCrashes(const int STEPS, const Vec3& pos);
+    void  checkCrashes();
     void  findNonCrashingPoint(sgVec2 result);
 
     float normalizeAngle(float angle);
     int   calcSteps();
     void  setSteering(float angle, float dt);
-    float getApproxRadius(const int START, const int END) const;
+    void  updateSteering(float dt);
+    bool  isEmergency() const;
     void  findCurve();
 
 public:
@@ -186,7 +230,11 @@ public:
                               const btTransform& init_pos, const Track *track);
                 ~DefaultRobot();
     void         update      (float delta) ;
+    virtual ThinkRequest needsThink(float dt);
+    virtual void think       ();
+    virtual float getTimeSinceThink() const {return m_time_since_think;}
     void         reset       ();
+    virtual void setSimulationLevel(SimulationLevel level);
     virtual void crashed     (Kart *k) {if(k) m_collided = true;};
 };
 
@@ -19,15 +19,384 @@
 
 #include "robots/track_info.hpp"
 
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#ifndef WIN32
+#  include <unistd.h>
+#endif
+
+#include "file_manager.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
 
+/** Increase this if the computation or the layout of the cache file
+ *  changes. */
+static const unsigned int CACHE_VERSION               = 2;
+/** Distance the racing line keeps from the edges of the road. */
+static const float        RACING_LINE_MARGIN          = 1.0f;
+/** Number of relaxation steps used to compute the racing line. */
+static const int          RACING_LINE_ITERATIONS      = 200;
+/** Distance of the points used to compute the radius of a curve. */
+static const float        CURVE_SPAN                  = 8.0f;
+/** Radius used for straight sections. */
+static const float        MAX_CURVE_RADIUS            = 99999.0f;
+/** Lateral acceleration a kart can sustain in a curve. */
+static const float        MAX_LATERAL_ACCELERATION    = 20.0f;
+/** Deceleration used to compute where to brake before a curve. */
+static const float        BRAKE_DECELERATION          = 15.0f;
+/** Distance between the points tested for the visibility table. */
+static const float        VISIBILITY_STEP             = 1.0f;
+/** Distance a kart (i.e. half of its width) keeps from the edge of the
+ *  road when driving straight to a visible sector. */
+static const float        VISIBILITY_MARGIN           = 0.75f;
+
 TrackInfo::TrackInfo(const Track *track)
 {
     m_track = track;
     setupSteerInfo();
+    computeDistances();
+
+    const std::string cache = 
+        file_manager->getCacheFile(m_track->getIdent()+".ai");
+    const unsigned int key  = getCacheKey();
+    if(!loadCache(cache, key))
+    {
+        computeRacingLine();
+        computeCurveRadii();
+        computeTargetSpeeds();
+        computeVisibility();
+        saveCache(cache, key);
+    }
 }   // TrackInfo
 
+// ----------------------------------------------------------------------------
+/** Computes the distance table (see m_distance).
+ */
+void TrackInfo::computeDistances()
+{
+    const unsigned int n = m_track->m_driveline.size();
+    m_distance.resize(2*n+1);
+    m_distance[0] = 0.0f;
+    for(unsigned int i=0; i<2*n; i++)
+    {
+        const Vec3 &p    = m_track->m_driveline[i%n];
+        const Vec3 &next = m_track->m_driveline[(i+1)%n];
+        m_distance[i+1]  = m_distance[i] + (next-p).length_2d();
+    }
+}   // computeDistances
+
+// ----------------------------------------------------------------------------
+/** Returns the first sector at which the distance driven along the
+ *  driveline from the given sector is at least the given distance.
+ *  \param sector The sector to start at.
+ *  \param distance The distance to drive (at most one lap).
+ */
+int TrackInfo::getSectorAhead(int sector, float distance) const
+{
+    const int n = m_track->m_driveline.size();
+    if(distance<=0.0f || n==0) return sector;
+    std::vector<float>::const_iterator p = 
+        std::lower_bound(m_distance.begin()+sector, 
+                         m_distance.begin()+sector+n+1,
+                         m_distance[sector]+distance);
+    return (p-m_distance.begin())%n;
+}   // getSectorAhead
+
+// ----------------------------------------------------------------------------
+/** Computes the racing line: starting with the driveline, each point is
+ *  repeatedly moved towards the middle of its neighbours (which reduces
+ *  the curvature), but only sideways and without leaving the road.
+ */
+void TrackInfo::computeRacingLine()
+{
+    const unsigned int n = m_track->m_driveline.size();
+    m_racing_line_offset.clear();
+    m_racing_line_offset.resize(n, 0.0f);
+    m_racing_line = m_track->m_driveline;
+    if(n<3) return;
+
+    for(int iteration=0; iteration<RACING_LINE_ITERATIONS; iteration++)
+    {
+        for(unsigned int i=0; i<n; i++)
+        {
+            const Vec3 &center = m_track->m_driveline[i];
+            const Vec3  side   = m_track->m_right_driveline[i]-center;
+            const float len2   = side.length2_2d();
+            if(len2<=0.0f) continue;
+            const Vec3 middle  = (m_racing_line[(i+n-1)%n]
+                                 +m_racing_line[(i+1)%n]    )*0.5f;
+            float offset = ( (middle.getX()-center.getX())*side.getX()
+                            +(middle.getY()-center.getY())*side.getY())/len2;
+            const float width = m_track->getWidth()[i];
+            const float limit = width>RACING_LINE_MARGIN 
+                              ? 1.0f-RACING_LINE_MARGIN/width : 0.0f;
+            offset = std::max(-limit, std::min(limit, offset));
+            m_racing_line_offset[i] = offset;
+            m_racing_line[i]        = center+side*offset;
+        }   // for i<n
+    }   // for iteration
+}   // computeRacingLine
+
+// ----------------------------------------------------------------------------
+/** Computes the radius of the racing line in each sector, using the circle
+ *  through the racing line points about CURVE_SPAN before and after the
+ *  sector.
+ */
+void TrackInfo::computeCurveRadii()
+{
+    const unsigned int n = m_racing_line.size();
+    m_curve_radius.clear();
+    m_curve_radius.resize(n, MAX_CURVE_RADIUS);
+    if(n<3) return;
+    for(unsigned int i=0; i<n; i++)
+    {
+        const Vec3 &b = m_racing_line[i];
+        unsigned int prev = (i+n-1)%n, next = (i+1)%n;
+        for(unsigned int j=1; j<n/3; j++)
+        {
+            if((m_racing_line[prev]-b).length_2d()>=CURVE_SPAN) break;
+            prev = (prev+n-1)%n;
+        }
+        for(unsigned int j=1; j<n/3; j++)
+        {
+            if((m_racing_line[next]-b).length_2d()>=CURVE_SPAN) break;
+            next = (next+1)%n;
+        }
+        const Vec3 &a = m_racing_line[prev];
+        const Vec3 &c = m_racing_line[next];
+        // Radius of the circumscribed circle: |ab|*|bc|*|ca| / (4*area)
+        float cross = (b.getX()-a.getX())*(c.getY()-a.getY())
+                    - (b.getY()-a.getY())*(c.getX()-a.getX());
+        if(fabsf(cross)<0.0001f) continue;
+        float r = (b-a).length_2d()*(c-b).length_2d()*(a-c).length_2d()
+                / (2.0f*fabsf(cross));
+        m_curve_radius[i] = std::min(r, MAX_CURVE_RADIUS);
+    }   // for i<n
+}   // computeCurveRadii
+
+// ----------------------------------------------------------------------------
+/** Computes the target speed of each sector: the speed at which the curve
+ *  of this sector can be taken, reduced so that the kart can brake in time
+ *  for all following curves.
+ */
+void TrackInfo::computeTargetSpeeds()
+{
+    const unsigned int n = m_curve_radius.size();
+    m_target_speed.resize(n);
+    for(unsigned int i=0; i<n; i++)
+        m_target_speed[i] = sqrtf(MAX_LATERAL_ACCELERATION*m_curve_radius[i]);
+    if(n<2) return;
+
+    // Going backwards twice around the track makes sure that braking 
+    // for the curves at the beginning of the track is taken into account
+    // at the end of the track.
+    for(int k=2*n-1; k>=0; k--)
+    {
+        const unsigned int i    = k%n;
+        const unsigned int next = (i+1)%n;
+        const float distance    = (m_racing_line[next]-m_racing_line[i])
+                                  .length_2d();
+        const float v_next      = m_target_speed[next];
+        m_target_speed[i] = std::min(m_target_speed[i],
+                                     sqrtf(v_next*v_next
+                                           +2.0f*BRAKE_DECELERATION*distance));
+    }
+}   // computeTargetSpeeds
+
+// ----------------------------------------------------------------------------
+/** Computes the visibility table (see m_visible_sector): for each sector
+ *  the straight lines from several points across the road are tested.
+ */
+void TrackInfo::computeVisibility()
+{
+    const unsigned int n = m_track->m_driveline.size();
+    m_visible_sector.resize(n*NUM_VISIBILITY_OFFSETS);
+    for(unsigned int i=0; i<n; i++)
+    {
+        const Vec3 &center = m_track->m_driveline[i];
+        const Vec3  side   = m_track->m_right_driveline[i]-center;
+        for(int j=0; j<NUM_VISIBILITY_OFFSETS; j++)
+        {
+            // Use the middle of each part of the road.
+            const float offset = (2*j+1.0f)/NUM_VISIBILITY_OFFSETS - 1.0f;
+            m_visible_sector[i*NUM_VISIBILITY_OFFSETS+j] =
+                findVisibleSector(i, center+side*offset);
+        }
+    }
+}   // computeVisibility
+
+// ----------------------------------------------------------------------------
+/** Finds the furthest sector that can be reached in a straight line from
+ *  a point without getting off the road: the lines to the driveline points
+ *  of the following sectors are tested one after the other, until one of
+ *  them leaves the road.
+ *  \param start_sector The sector of the start point.
+ *  \param start The start point.
+ */
+int TrackInfo::findVisibleSector(int start_sector, const Vec3 &start) const
+{
+    const unsigned int n = m_track->m_driveline.size();
+    int sector = (start_sector+1)%n;
+    // Don't test more than one lap (e.g. on a circular track).
+    for(unsigned int count=0; count<n; count++)
+    {
+        const int target = (sector+1)%n;
+        Vec3  direction  = m_track->m_driveline[target]-start;
+        const float len  = direction.length_2d();
+        const int steps  = std::max(3, (int)(len/VISIBILITY_STEP));
+        if(len>0.0f) direction *= 1.0f/len;
+        for(int i=2; i<steps; i++)
+        {
+            Vec3 track_coord;
+            m_track->spatialToTrack(track_coord,
+                                    start+direction*(VISIBILITY_STEP*i),
+                                    sector);
+            if(fabsf(track_coord.getX())+VISIBILITY_MARGIN 
+                > m_track->getWidth()[sector])
+                return sector;
+        }
+        sector = target;
+    }
+    return sector;
+}   // findVisibleSector
+
+// ----------------------------------------------------------------------------
+/** Returns the furthest sector a kart at the given position can drive to in
+ *  a straight line without getting off the road.
+ *  \param sector The sector the kart is in.
+ *  \param xyz The position of the kart.
+ */
+int TrackInfo::getVisibleSector(int sector, const Vec3 &xyz) const
+{
+    const Vec3 &center = m_track->m_driveline[sector];
+    const Vec3  side   = m_track->m_right_driveline[sector]-center;
+    const float len2   = side.length2_2d();
+    float offset = 0.0f;
+    if(len2>0.0f)
+        offset = ( (xyz.getX()-center.getX())*side.getX()
+                  +(xyz.getY()-center.getY())*side.getY())/len2;
+    int j = (int)floorf((offset+1.0f)*0.5f*NUM_VISIBILITY_OFFSETS);
+    j = std::max(0, std::min(NUM_VISIBILITY_OFFSETS-1, j));
+    return m_visible_sector[sector*NUM_VISIBILITY_OFFSETS+j];
+}   // getVisibleSector
+
+// ----------------------------------------------------------------------------
+/** Computes a hash (FNV-1a) of the driveline, which is used to detect
+ *  outdated cache files.
+ */
+unsigned int TrackInfo::getCacheKey() const
+{
+    unsigned int hash = 2166136261u;
+    const std::vector<Vec3> *lines[2] = {&m_track->m_left_driveline,
+                                         &m_track->m_right_driveline};
+    for(unsigned int l=0; l<2; l++)
+    {
+        for(unsigned int i=0; i<lines[l]->size(); i++)
+        {
+            const float xyz[3] = {(*lines[l])[i].getX(), (*lines[l])[i].getY(),
+                                  (*lines[l])[i].getZ()};
+            for(unsigned int j=0; j<sizeof(xyz); j++)
+            {
+                hash ^= ((const unsigned char*)xyz)[j];
+                hash *= 16777619u;
+            }
+        }
+    }
+    return hash;
+}   // getCacheKey
+
+// ----------------------------------------------------------------------------
+/** Loads the racing line, curve radii, target speeds and the visibility
+ *  table from a cache file.
+ *  \return False if the file doesn't exist, is outdated or contains
+ *          invalid sector indices.
+ */
+bool TrackInfo::loadCache(const std::string &filename, unsigned int key)
+{
+    FILE *fd = fopen(filename.c_str(), "rb");
+    if(!fd) return false;
+    const unsigned int n = m_track->m_driveline.size();
+    unsigned int header[4];
+    bool ok = fread(header, sizeof(header), 1, fd)==1 &&
+              header[0]==CACHE_VERSION && header[1]==key &&
+              header[2]==n && header[3]==sizeof(float);
+    if(ok)
+    {
+        m_racing_line_offset.resize(n);
+        m_curve_radius.resize(n);
+        m_target_speed.resize(n);
+        m_visible_sector.resize(n*NUM_VISIBILITY_OFFSETS);
+        const unsigned int nv = m_visible_sector.size();
+        ok = n==0 ||
+             (fread(&m_racing_line_offset[0], sizeof(float), n, fd)==n &&
+              fread(&m_curve_radius[0],       sizeof(float), n, fd)==n &&
+              fread(&m_target_speed[0],       sizeof(float), n, fd)==n &&
+              fread(&m_visible_sector[0],     sizeof(int),  nv, fd)==nv  );
+        // A corrupt file must not lead to out of bounds sector indices.
+        for(unsigned int i=0; ok && i<nv; i++)
+            ok = m_visible_sector[i]>=0 && m_visible_sector[i]<(int)n;
+    }
+    fclose(fd);
+    if(!ok) return false;
+
+    m_racing_line.resize(n);
+    for(unsigned int i=0; i<n; i++)
+    {
+        const Vec3 &center = m_track->m_driveline[i];
+        m_racing_line[i] = center + (m_track->m_right_driveline[i]-center)
+                                  * m_racing_line_offset[i];
+    }
+    return true;
+}   // loadCache
+
+// ----------------------------------------------------------------------------
+/** Saves the racing line, curve radii, target speeds and the visibility
+ *  table to a cache file. As in TriangleMesh::saveCache the data is written
+ *  to a temporary file which is then renamed, so that a concurrent reader
+ *  never sees an incomplete cache file.
+ */
+void TrackInfo::saveCache(const std::string &filename, unsigned int key) const
+{
+    char suffix[32];
+#ifdef WIN32
+    sprintf(suffix, ".tmp");
+#else
+    sprintf(suffix, ".%d.tmp", (int)getpid());
+#endif
+    const std::string tmp_filename = filename+suffix;
+    FILE *fd = fopen(tmp_filename.c_str(), "wb");
+    if(!fd)
+    {
+        fprintf(stderr, "Warning: Can't write cache file '%s'.\n",
+                filename.c_str());
+        return;
+    }
+    const unsigned int n = m_racing_line_offset.size();
+    const unsigned int header[4] = {CACHE_VERSION, key, n, sizeof(float)};
+    bool ok = fwrite(header, sizeof(header), 1, fd)==1;
+    if(n>0)
+    {
+        ok = ok && fwrite(&m_racing_line_offset[0], sizeof(float), n, fd)==n;
+        ok = ok && fwrite(&m_curve_radius[0],       sizeof(float), n, fd)==n;
+        ok = ok && fwrite(&m_target_speed[0],       sizeof(float), n, fd)==n;
+        const unsigned int nv = m_visible_sector.size();
+        ok = ok && fwrite(&m_visible_sector[0],     sizeof(int),  nv, fd)==nv;
+    }
+    ok = fclose(fd)==0 && ok;
+#ifdef WIN32
+    // rename does not replace an existing file on windows.
+    if(ok) remove(filename.c_str());
+#endif
+    if(!ok || rename(tmp_filename.c_str(), filename.c_str())!=0)
+    {
+        fprintf(stderr, "Warning: Can't write cache file '%s'.\n",
+                filename.c_str());
+        remove(tmp_filename.c_str());
+    }
+}   // saveCache
+
 // ----------------------------------------------------------------------------
 /** Creates the steer-info array.
  */
@@ -20,13 +20,18 @@
 #ifndef HEADER_TRACK_INFO_HPP
 #define HEADER_TRACK_INFO_HPP
 
+#include <string>
 #include <vector>
 
+#include "utils/vec3.hpp"
+
 class Track;
 
 /** This class is used to pre-compute some track information used by the AI, 
  *  e.g. length of straight sections, turn radius etc.
  *  Each AI share this information, so it's only done once per track.
+ *  The information only depends on the driveline, so it is saved in a
+ *  cache file and only computed again if the driveline changes.
  */
 class TrackInfo
 {
@@ -51,11 +56,52 @@ class TrackInfo
     /** Pointer to the track. */
     const Track           *m_track;
 
+    /** Distance (in the x/y plane) along the driveline from sector 0 to
+     *  sector i. The table covers two laps (2*size+1 entries), so that the
+     *  distance between two sectors can be computed without wrapping. */
+    std::vector<float>     m_distance;
+    /** Position of the racing line in each sector, relative to the
+     *  driveline: -1 is the left, 1 the right side of the road. */
+    std::vector<float>     m_racing_line_offset;
+    /** The racing line, i.e. the line with the smallest curvature that
+     *  stays on the road. */
+    std::vector<Vec3>      m_racing_line;
+    /** Radius of the racing line in each sector. */
+    std::vector<float>     m_curve_radius;
+    /** The maximum speed in each sector, so that the kart can take this
+     *  curve and brake in time for the following curves. */
+    std::vector<float>     m_target_speed;
+    /** Number of points across the road for which the visibility table
+     *  is computed. */
+    enum {NUM_VISIBILITY_OFFSETS = 5};
+    /** The visibility table: the furthest sector that can be reached in a
+     *  straight line without leaving the road, for NUM_VISIBILITY_OFFSETS
+     *  points across the road in each sector. The entry for sector i and
+     *  point j is at i*NUM_VISIBILITY_OFFSETS+j. */
+    std::vector<int>       m_visible_sector;
+
     void  setupSteerInfo();
+    void  computeDistances();
+    void  computeRacingLine();
+    void  computeCurveRadii();
+    void  computeTargetSpeeds();
+    void  computeVisibility();
+    int   findVisibleSector(int start_sector, const Vec3 &start) const;
+    unsigned int getCacheKey() const;
+    bool  loadCache(const std::string &filename, unsigned int key);
+    void  saveCache(const std::string &filename, unsigned int key) const;
 
     DirectionType computeDirection(int i);
 public:
     TrackInfo(const Track *track);
+    int   getSectorAhead(int sector, float distance) const;
+    int   getVisibleSector(int sector, const Vec3 &xyz) const;
+    /** Returns the point of the racing line in the given sector. */
+    const Vec3& getRacingLine (int sector) const {return m_racing_line[sector];  }
+    /** Returns the radius of the racing line in the given sector. */
+    float getCurveRadius      (int sector) const {return m_curve_radius[sector]; }
+    /** Returns the highest speed a kart should have in the given sector. */
+    float getTargetSpeed      (int sector) const {return m_target_speed[sector]; }
 };   // TrackInfo
 
 #endif
@@ -119,6 +119,12 @@ void STKConfig::load(const std::string &filename)
     CHECK_NEG(m_skid_fadeout_time,         "skid-fadeout-time"          );
     CHECK_NEG(m_slowdown_factor,           "slowdown-factor"            );
     CHECK_NEG(m_near_ground,               "near-ground"                );
+    CHECK_NEG(m_lod_reduced_distance,      "lod-reduced-distance"       );
+    CHECK_NEG(m_lod_kinematic_distance,    "lod-kinematic-distance"     );
+    CHECK_NEG(m_lod_hysteresis,            "lod-hysteresis"             );
+    CHECK_NEG(m_lod_ai_interval,           "lod-ai-interval"            );
+    CHECK_NEG(m_ai_think_interval,         "ai-think-interval"          );
+    CHECK_NEG(m_ai_time_budget,            "ai-time-budget"             );
     CHECK_NEG(m_delay_finish_time,         "delay-finish-time"          );
     CHECK_NEG(m_music_credit_time,         "music-credit-time"          );
     m_kart_properties.checkAllSet(filename);
@@ -142,6 +148,9 @@ void STKConfig::init_defaults()
     m_delay_finish_time    = m_skid_fadeout_time       =
     m_slowdown_factor      = m_offroad_tolerance       =
     m_final_camera_time    = m_near_ground             = 
+    m_lod_reduced_distance = m_lod_kinematic_distance  =
+    m_lod_hysteresis       = m_lod_ai_interval         =
+    m_ai_think_interval    = m_ai_time_budget          =
         UNDEFINED;
     m_bubble_gum_counter       = -100;
     m_max_karts                = -100;
@@ -217,6 +226,12 @@ void STKConfig::getAllData(const lisp::Lisp* lisp)
     lisp->get("skid-fadeout-time",            m_skid_fadeout_time      );
     lisp->get("slowdown-factor",              m_slowdown_factor        );
     lisp->get("near-ground",                  m_near_ground            );
+    lisp->get("lod-reduced-distance",         m_lod_reduced_distance   );
+    lisp->get("lod-kinematic-distance",       m_lod_kinematic_distance );
+    lisp->get("lod-hysteresis",               m_lod_hysteresis         );
+    lisp->get("lod-ai-interval",              m_lod_ai_interval        );
+    lisp->get("ai-think-interval",            m_ai_think_interval      );
+    lisp->get("ai-time-budget",               m_ai_time_budget         );
     lisp->get("delay-finish-time",            m_delay_finish_time      );
     lisp->get("music-credit-time",            m_music_credit_time      );
     lisp->getVector("menu-background",        m_menu_background        );
@@ -81,6 +81,17 @@ public:
                                       *  ground anymore and the upright
                                       *  constraint is disabled to allow for
                                       *  more violent explosions.            */
+    float m_lod_reduced_distance;    /**<AI karts further away from all
+                                      *  players use a reduced simulation.   */
+    float m_lod_kinematic_distance;  /**<AI karts further away from all
+                                      *  players are moved kinematically.    */
+    float m_lod_hysteresis;          /**<Hysteresis for both lod distances.  */
+    float m_lod_ai_interval;         /**<Time between AI updates of karts
+                                      *  with a reduced simulation.          */
+    float m_ai_think_interval;       /**<Time between the AI decisions of a
+                                      *  kart.                               */
+    float m_ai_time_budget;          /**<Maximum time per frame for the AI
+                                      *  decisions, 0 for no limit.          */
     int   m_min_kart_version,        /**<The minimum and maximum .kart file  */
           m_max_kart_version;        /** version supported by this binary.   */
     int   m_min_track_version,       /**<The minimum and maximum .track file */
@@ -0,0 +1,296 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "telemetry.hpp"
+
+#include <stdlib.h>
+#include <SDL/SDL_thread.h>
+
+#include "race_manager.hpp"
+#include "karts/kart.hpp"
+#include "modes/linear_world.hpp"
+#include "modes/world.hpp"
+#include "tracks/track.hpp"
+
+Telemetry* telemetry = 0;
+
+/** Number of records after which the buffers are handed to the writer
+ *  thread. This is also the size that is preallocated for the buffers. */
+static const unsigned int HAND_OVER_SIZE = 1024;
+
+/** The telemetry object with an open file, which needs to be flushed if
+ *  exit() is called. */
+static Telemetry *open_telemetry = NULL;
+
+//-----------------------------------------------------------------------------
+/** Initialises the telemetry object, telemetry is disabled by default.
+ */
+Telemetry::Telemetry()
+{
+    m_enabled           = false;
+    m_rate              = 10.0f;
+    m_time_since_sample = 0.0f;
+    m_race_count        = 0;
+    m_file              = NULL;
+    m_thread            = NULL;
+    m_mutex             = NULL;
+    m_cond              = NULL;
+    m_data_ready        = false;
+    m_stop              = false;
+}   // Telemetry
+
+//-----------------------------------------------------------------------------
+Telemetry::~Telemetry()
+{
+    close();
+}   // ~Telemetry
+
+//-----------------------------------------------------------------------------
+/** Opens the telemetry file and starts the writer thread.
+ */
+void Telemetry::open()
+{
+    m_file = fopen(m_filename.c_str(), "w");
+    if(!m_file)
+    {
+        fprintf(stderr, "Can not open telemetry file '%s', telemetry disabled.\n",
+                m_filename.c_str());
+        m_enabled = false;
+        return;
+    }
+    m_kart_records.reserve       (2*HAND_OVER_SIZE);
+    m_event_records.reserve      (2*HAND_OVER_SIZE);
+    m_write_kart_records.reserve (2*HAND_OVER_SIZE);
+    m_write_event_records.reserve(2*HAND_OVER_SIZE);
+    m_data_ready = false;
+    m_stop       = false;
+    m_mutex      = SDL_CreateMutex();
+    m_cond       = SDL_CreateCond();
+    m_thread     = SDL_CreateThread(&Telemetry::writerThread, this);
+    open_telemetry = this;
+    // Make sure that all data is written if the program calls exit()
+    // (e.g. at the end of profiling or a history replay).
+    static bool at_exit_registered = false;
+    if(!at_exit_registered)
+    {
+        atexit(&Telemetry::atExit);
+        at_exit_registered = true;
+    }
+}   // open
+
+//-----------------------------------------------------------------------------
+/** Writes all outstanding data, stops the writer thread and closes the file.
+ */
+void Telemetry::close()
+{
+    if(!m_file) return;
+    handOver(/*wait*/true);
+    SDL_LockMutex(m_mutex);
+    m_stop = true;
+    SDL_CondSignal(m_cond);
+    SDL_UnlockMutex(m_mutex);
+    SDL_WaitThread(m_thread, NULL);
+    SDL_DestroyCond(m_cond);
+    SDL_DestroyMutex(m_mutex);
+    m_thread = NULL;
+    m_cond   = NULL;
+    m_mutex  = NULL;
+    fclose(m_file);
+    m_file   = NULL;
+    open_telemetry = NULL;
+}   // close
+
+//-----------------------------------------------------------------------------
+/** Called when the program exits to flush the telemetry file.
+ */
+void Telemetry::atExit()
+{
+    if(open_telemetry) open_telemetry->close();
+}   // atExit
+
+//-----------------------------------------------------------------------------
+/** Called at the start of a race. Opens the telemetry file if necessary, and
+ *  writes the race header.
+ *  \param world The world of the new race.
+ */
+void Telemetry::startRace(const World *world)
+{
+    if(!m_enabled) return;
+    if(!m_file)
+    {
+        open();
+        if(!m_file) return;
+    }
+    // Make sure all data of a previous race is written before the header
+    handOver(/*wait*/true);
+    SDL_LockMutex(m_mutex);
+    fprintf(m_file, "R,%d,%s,%d\n", m_race_count,
+            world->getTrack()->getIdent().c_str(),
+            race_manager->getNumKarts());
+    SDL_UnlockMutex(m_mutex);
+    m_race_count++;
+    // Take a sample at the very start of the race.
+    m_time_since_sample = 1.0f/m_rate;
+}   // startRace
+
+//-----------------------------------------------------------------------------
+/** Called at the end of a race, hands all data to the writer thread.
+ */
+void Telemetry::endRace()
+{
+    if(!m_file) return;
+    handOver(/*wait*/false);
+}   // endRace
+
+//-----------------------------------------------------------------------------
+/** Hands the buffers of the main thread to the writer thread.
+ *  \param wait If true, wait till all data has been written. Otherwise the
+ *         data is only handed over if the writer thread is idle.
+ */
+void Telemetry::handOver(bool wait)
+{
+    SDL_LockMutex(m_mutex);
+    if(wait)
+    {
+        while(m_data_ready) SDL_CondWait(m_cond, m_mutex);
+    }
+    if(!m_data_ready && (m_kart_records.size()>0 || m_event_records.size()>0))
+    {
+        // The write buffers are empty (and preallocated), so swapping
+        // is cheap and no memory is allocated.
+        m_kart_records.swap(m_write_kart_records);
+        m_event_records.swap(m_write_event_records);
+        m_data_ready = true;
+        SDL_CondBroadcast(m_cond);
+    }
+    if(wait)
+    {
+        while(m_data_ready) SDL_CondWait(m_cond, m_mutex);
+    }
+    SDL_UnlockMutex(m_mutex);
+}   // handOver
+
+//-----------------------------------------------------------------------------
+/** Takes a sample of the state of all karts (if it is time to do so), and
+ *  hands the data to the writer thread once enough data is collected.
+ *  \param world The world of the current race.
+ *  \param dt Time step size.
+ */
+void Telemetry::update(const World *world, float dt)
+{
+    if(!m_file) return;
+    m_time_since_sample += dt;
+    if(m_time_since_sample >= 1.0f/m_rate)
+    {
+        m_time_since_sample = 0.0f;
+        const LinearWorld *lw = dynamic_cast<const LinearWorld*>(world);
+        const unsigned int num_karts = race_manager->getNumKarts();
+        for(unsigned int i=0; i<num_karts; i++)
+        {
+            Kart *kart = world->getKart(i);
+            if(kart->isEliminated()) continue;
+            KartRecord r;
+            r.m_time        = world->getTime();
+            r.m_kart_id     = i;
+            const Vec3 &xyz = kart->getXYZ();
+            r.m_xyz[0]      = xyz.getX();
+            r.m_xyz[1]      = xyz.getY();
+            r.m_xyz[2]      = xyz.getZ();
+            const btVector3 &v = kart->getVelocity();
+            r.m_velocity[0] = v.getX();
+            r.m_velocity[1] = v.getY();
+            r.m_velocity[2] = v.getZ();
+            r.m_sector      = lw ? lw->getSectorForKart(i) : -1;
+            r.m_lap         = lw ? lw->getLapForKart(i)    : -1;
+            const KartControl &c = kart->getControls();
+            r.m_steer       = c.m_steer;
+            r.m_accel       = c.m_accel;
+            r.m_buttons     = c.getButtonsCompressed();
+            r.m_nitro       = kart->getEnergy();
+            r.m_attachment  = kart->getAttachment()->getType();
+            m_kart_records.push_back(r);
+        }   // for i<num_karts
+    }   // if sample
+    if(m_kart_records.size()+m_event_records.size() >= HAND_OVER_SIZE)
+        handOver(/*wait*/false);
+}   // update
+
+//-----------------------------------------------------------------------------
+void Telemetry::addEvent(EventType type, int kart_id, int other)
+{
+    if(!m_file) return;
+    EventRecord r;
+    r.m_time    = RaceManager::getWorld()->getTime();
+    r.m_type    = type;
+    r.m_kart_id = kart_id;
+    r.m_other   = other;
+    m_event_records.push_back(r);
+}   // addEvent
+
+//-----------------------------------------------------------------------------
+/** Writes the data in the write buffers to the file. Only called from the
+ *  writer thread, without holding the mutex.
+ */
+void Telemetry::writeRecords()
+{
+    for(unsigned int i=0; i<m_write_kart_records.size(); i++)
+    {
+        const KartRecord &r = m_write_kart_records[i];
+        fprintf(m_file, "K,%.3f,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,"
+                        "%.3f,%.3f,%d,%.2f,%d\n",
+                r.m_time, r.m_kart_id, r.m_xyz[0], r.m_xyz[1], r.m_xyz[2],
+                r.m_velocity[0], r.m_velocity[1], r.m_velocity[2],
+                r.m_sector, r.m_lap, r.m_steer, r.m_accel, r.m_buttons,
+                r.m_nitro, r.m_attachment);
+    }
+    for(unsigned int i=0; i<m_write_event_records.size(); i++)
+    {
+        const EventRecord &r = m_write_event_records[i];
+        fprintf(m_file, "E,%.3f,%d,%d,%d\n", r.m_time, r.m_type,
+                r.m_kart_id, r.m_other);
+    }
+    fflush(m_file);
+    m_write_kart_records.clear();
+    m_write_event_records.clear();
+}   // writeRecords
+
+//-----------------------------------------------------------------------------
+/** The writer thread: waits till data is handed over, and writes it.
+ *  \param data Pointer to the telemetry object.
+ */
+int Telemetry::writerThread(void *data)
+{
+    Telemetry *t = (Telemetry*)data;
+    SDL_LockMutex(t->m_mutex);
+    while(true)
+    {
+        while(!t->m_data_ready && !t->m_stop)
+            SDL_CondWait(t->m_cond, t->m_mutex);
+        if(!t->m_data_ready && t->m_stop) break;
+        // The write buffers are only accessed by this thread while
+        // m_data_ready is set, so the file output can be done unlocked.
+        SDL_UnlockMutex(t->m_mutex);
+        t->writeRecords();
+        SDL_LockMutex(t->m_mutex);
+        t->m_data_ready = false;
+        SDL_CondBroadcast(t->m_cond);
+    }
+    SDL_UnlockMutex(t->m_mutex);
+    return 0;
+}   // writerThread
+
+/* EOF */
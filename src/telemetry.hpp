@@ -0,0 +1,143 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_TELEMETRY_HPP
+#define HEADER_TELEMETRY_HPP
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+class  World;
+
+/** Writes telemetry data of a race (the state of all karts at a fixed rate,
+ *  and events like collisions, collected items and rescues) to a CSV file
+ *  for offline analysis. Telemetry is disabled by default and enabled with
+ *  the --telemetry command line option.
+ *  To keep the overhead in the main loop small, the main thread only copies
+ *  the data into a (preallocated) buffer. The buffers are handed over to a
+ *  separate writer thread, which does the (slow) formatting and file
+ *  output. The main thread never waits for the writer thread: if the
+ *  writer is still busy, the data is just kept in the buffer till the
+ *  next hand over.
+ *  The file contains three kinds of rows, distinguished by the first
+ *  column:
+ *    R,race,track,num_karts                  Start of a new race.
+ *    K,time,kart,x,y,z,vx,vy,vz,sector,lap,steer,accel,buttons,nitro,
+ *      attachment                            State of a kart.
+ *    E,time,event,kart,other                 An event (see EventType).
+ */
+class Telemetry
+{
+public:
+    /** The type of events that are recorded. */
+    enum EventType {EV_COLLISION, EV_ITEM_COLLECTED, EV_RESCUE};
+
+private:
+    /** The state of one kart at a certain time. */
+    struct KartRecord
+    {
+        float m_time;
+        int   m_kart_id;
+        float m_xyz[3];
+        float m_velocity[3];
+        int   m_sector;
+        int   m_lap;
+        float m_steer;
+        float m_accel;
+        int   m_buttons;
+        float m_nitro;
+        int   m_attachment;
+    };   // KartRecord
+
+    /** An event, e.g. a collision. For collisions m_other is the id of
+     *  the other kart (-1 for the track), for collected items it is the
+     *  item type. */
+    struct EventRecord
+    {
+        float m_time;
+        int   m_type;
+        int   m_kart_id;
+        int   m_other;
+    };   // EventRecord
+
+    /** True if telemetry is enabled. */
+    bool                     m_enabled;
+    /** Name of the telemetry file. */
+    std::string              m_filename;
+    /** Number of kart state samples per second. */
+    float                    m_rate;
+    /** Time since the last sample was taken. */
+    float                    m_time_since_sample;
+    /** Number of races written to the current file. */
+    int                      m_race_count;
+    FILE                    *m_file;
+
+    /** Buffers filled by the main thread. */
+    std::vector<KartRecord>  m_kart_records;
+    std::vector<EventRecord> m_event_records;
+    /** Buffers owned by the writer thread (while m_data_ready is true). */
+    std::vector<KartRecord>  m_write_kart_records;
+    std::vector<EventRecord> m_write_event_records;
+
+    SDL_Thread              *m_thread;
+    SDL_mutex               *m_mutex;
+    SDL_cond                *m_cond;
+    /** True if the write buffers contain data for the writer thread. */
+    bool                     m_data_ready;
+    /** Set to stop the writer thread. */
+    bool                     m_stop;
+
+    static int  writerThread(void *data);
+    static void atExit();
+    void        writeRecords();
+    void        handOver(bool wait);
+    void        open();
+
+public:
+          Telemetry();
+         ~Telemetry();
+    void  startRace(const World *world);
+    void  endRace();
+    void  update(const World *world, float dt);
+    void  close();
+    // ------------------------------------------------------------------------
+    /** Enables telemetry and sets the name of the file to write to. */
+    void  setFilename(const std::string &f) { m_filename = f; m_enabled=true;}
+    // ------------------------------------------------------------------------
+    /** Sets the number of samples per second. */
+    void  setRate(float r)                  { m_rate = r;                    }
+    // ------------------------------------------------------------------------
+    /** Returns true if telemetry is written. */
+    bool  isEnabled() const                 { return m_enabled;              }
+    // ------------------------------------------------------------------------
+    /** Records an event. This is cheap (and does nothing if telemetry is
+     *  disabled), so it can be called from anywhere in the simulation.
+     *  \param type Type of the event.
+     *  \param kart_id World id of the kart.
+     *  \param other Additional information, see EventRecord. */
+    void  addEvent(EventType type, int kart_id, int other=-1);
+};   // Telemetry
+
+extern Telemetry *telemetry;
+
+#endif
+
+/* EOF */
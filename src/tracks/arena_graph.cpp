@@ -0,0 +1,313 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "tracks/arena_graph.hpp"
+
+#include <math.h>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "material.hpp"
+#include "tracks/track.hpp"
+
+/** Smallest size of a grid cell. */
+static const float CELL_SIZE     = 2.0f;
+/** Maximum number of grid cells. The path tables have (number of nodes)^2
+ *  entries, so this limits their size to a few MB. */
+static const int   MAX_CELLS     = 1024;
+/** A cell is not a node if its terrain is steeper than this (the z
+ *  component of the normal, about 45 degrees). */
+static const float MIN_NORMAL_Z  = 0.7f;
+/** Two nodes are only connected if the slope between them (and to the
+ *  terrain between them) is at most this. */
+static const float MAX_SLOPE     = 0.6f;
+/** Costs of an edge to a direct and to a diagonal neighbour. */
+static const int   COST_STRAIGHT = 10;
+static const int   COST_DIAGONAL = 14;
+
+// ----------------------------------------------------------------------------
+/** Creates the graph of an arena. This must be called after the physics
+ *  model of the track is created, since it uses getTerrainInfo.
+ *  \param track The arena.
+ */
+ArenaGraph::ArenaGraph(const Track *track)
+{
+    Vec3 max;
+    track->getAABB(&m_min, &max);
+    m_cell_size = CELL_SIZE;
+    while(true)
+    {
+        m_num_cells_x = (int)((max.getX()-m_min.getX())/m_cell_size)+1;
+        m_num_cells_y = (int)((max.getY()-m_min.getY())/m_cell_size)+1;
+        if(m_num_cells_x*m_num_cells_y<=MAX_CELLS) break;
+        m_cell_size *= 1.25f;
+    }
+    createNodes(track, max.getZ()+1.0f);
+    computePaths(track, max.getZ()+1.0f);
+    computeCellToNode();
+    computeNearestStart(track->m_start_positions);
+}   // ArenaGraph
+
+// ----------------------------------------------------------------------------
+/** Returns the height of the terrain at a position, or Track::NOHIT if
+ *  there is no terrain or the kart can not drive there.
+ *  \param track The arena.
+ *  \param x, y The position.
+ *  \param top A z value above the whole arena.
+ *  \param check_slope If true, steep terrain is rejected.
+ */
+static float getTerrainHeight(const Track *track, float x, float y, float top,
+                              bool check_slope)
+{
+    float           hot;
+    Vec3            normal;
+    const Material *material;
+    track->getTerrainInfo(Vec3(x, y, top), &hot, &normal, &material);
+    if(hot==Track::NOHIT) return Track::NOHIT;
+    if(material && material->isReset()) return Track::NOHIT;
+    if(check_slope && normal.getZ()<MIN_NORMAL_Z) return Track::NOHIT;
+    return hot;
+}   // getTerrainHeight
+
+// ----------------------------------------------------------------------------
+/** Creates a node for each grid cell on which a kart can drive. The other
+ *  cells are marked with -1 in m_cell_to_node.
+ *  \param track The arena.
+ *  \param top A z value above the whole arena.
+ */
+void ArenaGraph::createNodes(const Track *track, float top)
+{
+    m_cell_to_node.resize(m_num_cells_x*m_num_cells_y);
+    m_node_xyz.clear();
+    for(int j=0; j<m_num_cells_y; j++)
+    {
+        for(int i=0; i<m_num_cells_x; i++)
+        {
+            const float x = m_min.getX()+(i+0.5f)*m_cell_size;
+            const float y = m_min.getY()+(j+0.5f)*m_cell_size;
+            const float h = getTerrainHeight(track, x, y, top, true);
+            if(h==Track::NOHIT)
+            {
+                m_cell_to_node[j*m_num_cells_x+i] = -1;
+                continue;
+            }
+            m_cell_to_node[j*m_num_cells_x+i] = m_node_xyz.size();
+            m_node_xyz.push_back(Vec3(x, y, h));
+        }
+    }
+}   // createNodes
+
+// ----------------------------------------------------------------------------
+/** Connects neighbouring nodes, and computes the shortest paths between all
+ *  pairs of nodes with one Dijkstra search from each node. Since the graph
+ *  is undirected, the predecessor of a node in the search from node t is the
+ *  next node on the path from this node to t.
+ *  \param track The arena.
+ *  \param top A z value above the whole arena.
+ */
+void ArenaGraph::computePaths(const Track *track, float top)
+{
+    const int n = m_node_xyz.size();
+
+    // The edges of all nodes, the edges of node i are the entries
+    // edge_start[i] to edge_start[i+1]-1.
+    std::vector<int> edge_start(n+1), edge_node, edge_cost;
+    const int dx[8] = {1, -1, 0,  0, 1, -1,  1, -1};
+    const int dy[8] = {0,  0, 1, -1, 1,  1, -1, -1};
+    for(int j=0; j<m_num_cells_y; j++)
+    {
+        for(int i=0; i<m_num_cells_x; i++)
+        {
+            const int from = m_cell_to_node[j*m_num_cells_x+i];
+            if(from<0) continue;
+            edge_start[from] = edge_node.size();
+            const Vec3 &a = m_node_xyz[from];
+            for(int k=0; k<8; k++)
+            {
+                const int ni = i+dx[k], nj = j+dy[k];
+                if(ni<0 || nj<0 || ni>=m_num_cells_x || nj>=m_num_cells_y)
+                    continue;
+                const int to = m_cell_to_node[nj*m_num_cells_x+ni];
+                if(to<0) continue;
+                // Diagonals are only used if both direct neighbours are
+                // nodes, so that paths don't cut the corners of walls.
+                if(dx[k]!=0 && dy[k]!=0 &&
+                   (m_cell_to_node[j*m_num_cells_x+ni]<0 ||
+                    m_cell_to_node[nj*m_num_cells_x+i]<0))
+                    continue;
+                const Vec3 &b   = m_node_xyz[to];
+                const float len = (dx[k]!=0 && dy[k]!=0 ? 1.414f : 1.0f)
+                                * m_cell_size;
+                if(fabsf(b.getZ()-a.getZ()) > MAX_SLOPE*len) continue;
+                // Check the terrain half way, to detect walls which are
+                // thinner than a cell.
+                const float h = getTerrainHeight(track, 0.5f*(a.getX()+b.getX()),
+                                                 0.5f*(a.getY()+b.getY()),
+                                                 top, false);
+                if(h==Track::NOHIT ||
+                   fabsf(h-a.getZ()) > MAX_SLOPE*0.5f*len ||
+                   fabsf(h-b.getZ()) > MAX_SLOPE*0.5f*len)
+                    continue;
+                edge_node.push_back(to);
+                edge_cost.push_back(dx[k]!=0 && dy[k]!=0 ? COST_DIAGONAL
+                                                         : COST_STRAIGHT);
+            }   // for k<8
+        }   // for i<m_num_cells_x
+    }   // for j<m_num_cells_y
+    edge_start[n] = edge_node.size();
+
+    m_next.resize(n*n);
+    m_distance.resize(n*n);
+    std::vector<int> dist(n), parent(n);
+    typedef std::pair<int, int> Entry;   // (distance, node)
+    for(int t=0; t<n; t++)
+    {
+        for(int i=0; i<n; i++)
+        {
+            dist[i]   = -1;
+            parent[i] = i;
+        }
+        std::priority_queue<Entry, std::vector<Entry>,
+                            std::greater<Entry> > queue;
+        dist[t] = 0;
+        queue.push(Entry(0, t));
+        while(!queue.empty())
+        {
+            const Entry e = queue.top();
+            queue.pop();
+            const int node = e.second;
+            if(e.first>dist[node]) continue;
+            for(int k=edge_start[node]; k<edge_start[node+1]; k++)
+            {
+                const int other = edge_node[k];
+                const int d     = e.first+edge_cost[k];
+                if(dist[other]>=0 && dist[other]<=d) continue;
+                dist[other]   = d;
+                parent[other] = node;
+                queue.push(Entry(d, other));
+            }
+        }   // while !queue.empty()
+        for(int i=0; i<n; i++)
+        {
+            m_next[i*n+t]     = parent[i];
+            m_distance[i*n+t] = dist[i]<0 || dist[i]>=UNREACHABLE
+                              ? UNREACHABLE : dist[i];
+        }
+    }   // for t<n
+}   // computePaths
+
+// ----------------------------------------------------------------------------
+/** Sets the nearest node for all grid cells which are not a node, with a
+ *  breadth first search starting at all nodes.
+ */
+void ArenaGraph::computeCellToNode()
+{
+    std::queue<int> queue;
+    for(unsigned int i=0; i<m_cell_to_node.size(); i++)
+        if(m_cell_to_node[i]>=0) queue.push(i);
+    while(!queue.empty())
+    {
+        const int cell = queue.front();
+        queue.pop();
+        const int i = cell%m_num_cells_x, j = cell/m_num_cells_x;
+        const int neighbour[4] = {i>0               ? cell-1             : -1,
+                                  i<m_num_cells_x-1 ? cell+1             : -1,
+                                  j>0               ? cell-m_num_cells_x : -1,
+                                  j<m_num_cells_y-1 ? cell+m_num_cells_x : -1};
+        for(int k=0; k<4; k++)
+        {
+            if(neighbour[k]<0 || m_cell_to_node[neighbour[k]]>=0) continue;
+            m_cell_to_node[neighbour[k]] = m_cell_to_node[cell];
+            queue.push(neighbour[k]);
+        }
+    }
+}   // computeCellToNode
+
+// ----------------------------------------------------------------------------
+/** Computes the start position nearest to each node. The length of the
+ *  path is used, so that a kart is not placed on the other side of a wall.
+ *  If no start position can be reached, the start position with the
+ *  smallest distance (in the x/y plane) is used.
+ *  \param start_positions The start positions of the arena.
+ */
+void ArenaGraph::computeNearestStart(const std::vector<Vec3> &start_positions)
+{
+    const int n = m_node_xyz.size();
+    m_nearest_start.resize(n);
+    if(n==0) return;
+    std::vector<int> start_node(start_positions.size());
+    for(unsigned int i=0; i<start_positions.size(); i++)
+        start_node[i] = getNode(start_positions[i]);
+
+    for(int node=0; node<n; node++)
+    {
+        int   best      = -1;
+        float best_dist = 0.0f;
+        for(unsigned int i=0; i<start_positions.size(); i++)
+        {
+            const float d = getDistance(node, start_node[i]);
+            if(d>=0 && (best<0 || d<best_dist))
+            {
+                best      = i;
+                best_dist = d;
+            }
+        }
+        for(unsigned int i=0; i<start_positions.size() && best<0; i++)
+        {
+            Vec3 diff = start_positions[i]-m_node_xyz[node];
+            diff.setZ(0);
+            const float d = diff.length2();
+            if(i==0 || d<best_dist)
+            {
+                m_nearest_start[node] = i;
+                best_dist             = d;
+            }
+        }
+        if(best>=0) m_nearest_start[node] = best;
+    }   // for node<n
+}   // computeNearestStart
+
+// ----------------------------------------------------------------------------
+/** Returns the index of the grid cell of a position. Positions outside of
+ *  the grid are moved to the nearest cell.
+ *  \param xyz The position.
+ */
+int ArenaGraph::getCell(const Vec3 &xyz) const
+{
+    int i = (int)((xyz.getX()-m_min.getX())/m_cell_size);
+    int j = (int)((xyz.getY()-m_min.getY())/m_cell_size);
+    if(i<0) i = 0; else if(i>=m_num_cells_x) i = m_num_cells_x-1;
+    if(j<0) j = 0; else if(j>=m_num_cells_y) j = m_num_cells_y-1;
+    return j*m_num_cells_x+i;
+}   // getCell
+
+// ----------------------------------------------------------------------------
+/** Returns the node which is n nodes ahead on the shortest path from 'from'
+ *  to 'to' (or 'to' if it is closer).
+ *  \param from The start node.
+ *  \param to The target node.
+ *  \param n Number of nodes to follow the path.
+ */
+int ArenaGraph::getNodeAhead(int from, int to, int n) const
+{
+    for(int i=0; i<n && from!=to; i++)
+        from = getNextNode(from, to);
+    return from;
+}   // getNodeAhead
+
+/* EOF */
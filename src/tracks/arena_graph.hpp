@@ -0,0 +1,103 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_ARENA_GRAPH_HPP
+#define HEADER_ARENA_GRAPH_HPP
+
+#include <vector>
+
+#include "utils/vec3.hpp"
+
+class Track;
+
+/** A navigation graph for arenas, which have no driveline. The arena is
+ *  covered by a grid in the x/y plane, and each grid cell on which a kart
+ *  can drive (the terrain below its centre is not too steep and is not a
+ *  reset material) is a node. Neighbouring nodes (including diagonals) are
+ *  connected if the height difference between them is small enough, so
+ *  walls and cliffs separate nodes.
+ *  The shortest paths between all pairs of nodes are computed once when
+ *  the arena is loaded, so the AI can look up the distance to any kart and
+ *  the next node on the way to it in constant time. The number of grid
+ *  cells is limited (the cells get bigger in large arenas), which keeps
+ *  the tables small.
+ *  The graph also stores the nearest start position of each node, which is
+ *  used to place karts after a rescue.
+ */
+class ArenaGraph
+{
+private:
+    /** Lower left corner of the grid. */
+    Vec3                        m_min;
+    /** Size of a grid cell in x and y direction. */
+    float                       m_cell_size;
+    int                         m_num_cells_x, m_num_cells_y;
+    /** The nearest node of each grid cell (for cells which are a node this
+     *  is the node itself), or -1 if the arena has no nodes. */
+    std::vector<int>            m_cell_to_node;
+    /** Centre of each node on the terrain. */
+    std::vector<Vec3>           m_node_xyz;
+    /** m_next[from*n+to] is the next node on the shortest path from node
+     *  'from' to node 'to' (with n the number of nodes). */
+    std::vector<unsigned short> m_next;
+    /** m_distance[from*n+to] is the length of the shortest path in units
+     *  of a tenth of the cell size, or UNREACHABLE. */
+    std::vector<unsigned short> m_distance;
+    /** Index of the nearest start position of each node. */
+    std::vector<int>            m_nearest_start;
+
+    void  createNodes(const Track *track, float top);
+    void  computePaths(const Track *track, float top);
+    void  computeCellToNode();
+    void  computeNearestStart(const std::vector<Vec3> &start_positions);
+    int   getCell(const Vec3 &xyz) const;
+public:
+    enum {UNREACHABLE = 0xffff};
+
+         ArenaGraph(const Track *track);
+    int  getNodeAhead(int from, int to, int n) const;
+    // ------------------------------------------------------------------------
+    /** Returns the number of nodes. */
+    int  getNumNodes() const             {return (int)m_node_xyz.size();   }
+    // ------------------------------------------------------------------------
+    /** Returns the node nearest to a position, or -1 if the graph is empty.
+     *  \param xyz The position. */
+    int  getNode(const Vec3 &xyz) const  {return m_cell_to_node[getCell(xyz)];}
+    // ------------------------------------------------------------------------
+    /** Returns the centre of a node on the terrain. */
+    const Vec3 &getCenter(int node) const {return m_node_xyz[node];        }
+    // ------------------------------------------------------------------------
+    /** Returns the next node on the shortest path from 'from' to 'to'. If
+     *  'to' can not be reached, 'from' is returned. */
+    int  getNextNode(int from, int to) const
+                          {return m_next[from*m_node_xyz.size()+to];       }
+    // ------------------------------------------------------------------------
+    /** Returns the length of the shortest path between two nodes, or a
+     *  negative value if 'to' can not be reached from 'from'. */
+    float getDistance(int from, int to) const
+    {
+        const unsigned short d = m_distance[from*m_node_xyz.size()+to];
+        return d==UNREACHABLE ? -1.0f : d*m_cell_size*0.1f;
+    }   // getDistance
+    // ------------------------------------------------------------------------
+    /** Returns the index of the start position nearest to a node. */
+    int  getNearestStart(int node) const {return m_nearest_start[node];    }
+};   // ArenaGraph
+
+#endif
+
+/* EOF */
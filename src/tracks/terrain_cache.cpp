@@ -0,0 +1,249 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "tracks/terrain_cache.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+#include "physics/triangle_mesh.hpp"
+
+/** Default size of a grid cell. */
+static const float CELL_SIZE       = 2.0f;
+/** Maximum number of cells, if the track is bigger the cells are enlarged. */
+static const int   MAX_CELLS       = 1<<22;
+/** Two layers closer than this are considered to have the same height. */
+static const float HEIGHT_EPSILON  = 0.01f;
+/** Points closer than this to a triangle edge are considered ambiguous. */
+static const float EDGE_EPSILON    = 0.001f;
+
+//-----------------------------------------------------------------------------
+TerrainCache::TerrainCache()
+{
+    m_cell_size   = CELL_SIZE;
+    m_num_cells_x = 0;
+    m_num_cells_y = 0;
+}   // TerrainCache
+
+//-----------------------------------------------------------------------------
+/** Adds a triangle of the static track geometry to the cache. build() must
+ *  be called once all triangles are added.
+ */
+void TerrainCache::addTriangle(const Vec3 &v1, const Vec3 &v2, const Vec3 &v3,
+                               const Material *material)
+{
+    Triangle t;
+    btVector3 normal = (v2-v1).cross(v3-v1);
+    // Store the vertices counter-clockwise in the x/y plane, so that the
+    // edge tests in isInside() don't depend on the orientation.
+    const Vec3 *v[3] = {&v1, &v2, &v3};
+    if(normal.getZ()<0)
+    {
+        v[1]   = &v3;
+        v[2]   = &v2;
+        normal = -normal;
+    }
+    float longest_edge = 0;
+    for(int i=0; i<3; i++)
+    {
+        t.m_x[i] = v[i]->getX();
+        t.m_y[i] = v[i]->getY();
+        longest_edge = std::max(longest_edge, (*v[(i+1)%3]-*v[i]).length());
+    }
+    // Bullet's ray/triangle test accepts hits up to 0.0001 times the
+    // height of the triangle outside of it, so points close to an edge
+    // can't be answered from the cache.
+    t.m_margin = EDGE_EPSILON + 0.0002f*longest_edge;
+    for(int i=0; i<3; i++)
+    {
+        int j = (i+1)%3;
+        float len = sqrtf((t.m_x[j]-t.m_x[i])*(t.m_x[j]-t.m_x[i])
+                         +(t.m_y[j]-t.m_y[i])*(t.m_y[j]-t.m_y[i]) );
+        t.m_tolerance[i] = t.m_margin*len;
+    }
+    float length = normal.length();
+    t.m_normal   = length>0 ? normal/length : btVector3(0, 0, 1);
+    t.m_d        = t.m_normal.dot(v1);
+    t.m_material = material;
+    m_triangles.push_back(t);
+}   // addTriangle
+
+//-----------------------------------------------------------------------------
+/** Adds all triangles of a mesh (e.g. a mesh loaded from a cache file).
+ */
+void TerrainCache::addMesh(const TriangleMesh &mesh)
+{
+    for(int i=0; i<mesh.getNumTriangles(); i++)
+    {
+        btVector3 v1, v2, v3;
+        mesh.getTriangle(i, &v1, &v2, &v3);
+        addTriangle(v1, v2, v3, mesh.getMaterial(i));
+    }
+}   // addMesh
+
+//-----------------------------------------------------------------------------
+/** Computes the range of cells a triangle (including its margin) overlaps.
+ */
+void TerrainCache::getCellRange(const Triangle &t, int *min_x, int *min_y,
+                                int *max_x, int *max_y) const
+{
+    float x0 = std::min(t.m_x[0], std::min(t.m_x[1], t.m_x[2])) - t.m_margin;
+    float x1 = std::max(t.m_x[0], std::max(t.m_x[1], t.m_x[2])) + t.m_margin;
+    float y0 = std::min(t.m_y[0], std::min(t.m_y[1], t.m_y[2])) - t.m_margin;
+    float y1 = std::max(t.m_y[0], std::max(t.m_y[1], t.m_y[2])) + t.m_margin;
+    *min_x = std::max(0, (int)floorf((x0-m_min.getX())/m_cell_size));
+    *min_y = std::max(0, (int)floorf((y0-m_min.getY())/m_cell_size));
+    *max_x = std::min(m_num_cells_x-1,
+                      (int)floorf((x1-m_min.getX())/m_cell_size));
+    *max_y = std::min(m_num_cells_y-1,
+                      (int)floorf((y1-m_min.getY())/m_cell_size));
+}   // getCellRange
+
+//-----------------------------------------------------------------------------
+/** Sorts all triangles into the grid cells.
+ *  \param aabb_min, aabb_max Bounding box of the track.
+ */
+void TerrainCache::build(const Vec3 &aabb_min, const Vec3 &aabb_max)
+{
+    m_min       = aabb_min;
+    m_cell_size = CELL_SIZE;
+    float dx    = aabb_max.getX()-aabb_min.getX();
+    float dy    = aabb_max.getY()-aabb_min.getY();
+    while(true)
+    {
+        m_num_cells_x = (int)(dx/m_cell_size)+1;
+        m_num_cells_y = (int)(dy/m_cell_size)+1;
+        if(m_num_cells_x*m_num_cells_y<=MAX_CELLS) break;
+        m_cell_size *= 2.0f;
+    }
+
+    // First count the triangles in each cell, then store them.
+    const int num_cells = m_num_cells_x*m_num_cells_y;
+    m_cell_start.clear();
+    m_cell_start.resize(num_cells+1, 0);
+    for(unsigned int i=0; i<m_triangles.size(); i++)
+    {
+        int min_x, min_y, max_x, max_y;
+        getCellRange(m_triangles[i], &min_x, &min_y, &max_x, &max_y);
+        for(int y=min_y; y<=max_y; y++)
+            for(int x=min_x; x<=max_x; x++)
+                m_cell_start[y*m_num_cells_x+x+1]++;
+    }
+    for(int i=0; i<num_cells; i++)
+        m_cell_start[i+1] += m_cell_start[i];
+
+    m_cell_triangles.resize(m_cell_start[num_cells]);
+    std::vector<int> next(m_cell_start.begin(), m_cell_start.end()-1);
+    for(unsigned int i=0; i<m_triangles.size(); i++)
+    {
+        int min_x, min_y, max_x, max_y;
+        getCellRange(m_triangles[i], &min_x, &min_y, &max_x, &max_y);
+        for(int y=min_y; y<=max_y; y++)
+            for(int x=min_x; x<=max_x; x++)
+                m_cell_triangles[next[y*m_num_cells_x+x]++] = i;
+    }
+}   // build
+
+//-----------------------------------------------------------------------------
+/** Tests if a point is inside of a triangle in the x/y plane.
+ *  \return 1 if the point is inside, 0 if it is outside, and -1 if the
+ *          point is too close to an edge to decide.
+ */
+int TerrainCache::isInside(const Triangle &t, float x, float y) const
+{
+    int result = 1;
+    for(int i=0; i<3; i++)
+    {
+        int j = (i+1)%3;
+        // The edge function is the distance of the point to the edge
+        // multiplied by the length of the edge.
+        float e = (t.m_x[j]-t.m_x[i])*(y-t.m_y[i])
+                - (t.m_y[j]-t.m_y[i])*(x-t.m_x[i]);
+        if(e < -t.m_tolerance[i]) return 0;
+        if(e <= t.m_tolerance[i]) result = -1;
+    }
+    return result;
+}   // isInside
+
+//-----------------------------------------------------------------------------
+/** Returns the height, normal and material of the terrain under the given
+ *  point, i.e. the same values as casting a ray straight down through all
+ *  static track geometry.
+ *  \param pos The point to test.
+ *  \param hot On return the height of the terrain (if QR_HIT is returned).
+ *  \param normal On return the (normalised) normal of the terrain.
+ *  \param material On return the material of the terrain.
+ *  \return QR_HIT if terrain was found, QR_NO_HIT if there is no terrain
+ *          under the point, or QR_UNKNOWN if a ray must be cast.
+ */
+TerrainCache::QueryResult TerrainCache::getTerrainInfo(const Vec3 &pos,
+                                                       float *hot,
+                                                       Vec3 *normal,
+                                               const Material **material) const
+{
+    if(m_cell_start.size()==0) return QR_UNKNOWN;
+    const float x  = pos.getX();
+    const float y  = pos.getY();
+    const float fx = (x-m_min.getX())/m_cell_size;
+    const float fy = (y-m_min.getY())/m_cell_size;
+    if(fx<0 || fy<0 || fx>=m_num_cells_x || fy>=m_num_cells_y)
+        return QR_UNKNOWN;
+    const int cell  = (int)fy*m_num_cells_x + (int)fx;
+    const int start = m_cell_start[cell];
+    const int end   = m_cell_start[cell+1];
+
+    // Find the highest triangle below the point.
+    int   best   = -1;
+    float best_h = 0;
+    for(int i=start; i<end; i++)
+    {
+        const Triangle &t = m_triangles[m_cell_triangles[i]];
+        int inside = isInside(t, x, y);
+        if(inside==0) continue;
+        if(inside<0) return QR_UNKNOWN;
+        float h = getHeight(t, x, y);
+        // The ray starts (nearly) on this triangle.
+        if(fabsf(h-pos.getZ())<HEIGHT_EPSILON) return QR_UNKNOWN;
+        if(h>pos.getZ()) continue;
+        if(best<0 || h>best_h)
+        {
+            best   = m_cell_triangles[i];
+            best_h = h;
+        }
+    }   // for i
+
+    if(best<0) return QR_NO_HIT;
+
+    // If another layer has (nearly) the same height but a different
+    // material, it depends on rounding errors which one the ray hits.
+    const Triangle &t = m_triangles[best];
+    for(int i=start; i<end; i++)
+    {
+        const Triangle &other = m_triangles[m_cell_triangles[i]];
+        if(other.m_material==t.m_material) continue;
+        if(isInside(other, x, y)==0) continue;
+        float h = getHeight(other, x, y);
+        if(h<=pos.getZ() && best_h-h<HEIGHT_EPSILON) return QR_UNKNOWN;
+    }
+
+    *hot      = best_h;
+    *normal   = t.m_normal;
+    *material = t.m_material;
+    return QR_HIT;
+}   // getTerrainInfo
+
+/* EOF */
@@ -0,0 +1,94 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_TERRAIN_CACHE_HPP
+#define HEADER_TERRAIN_CACHE_HPP
+
+#include <vector>
+
+#include "utils/vec3.hpp"
+
+class Material;
+class TriangleMesh;
+
+/** A 2.5D cache of the static track geometry, used to answer height of
+ *  terrain queries without casting a ray through the physics world. The
+ *  x/y plane of the track is divided into a grid, and each cell stores all
+ *  triangles overlapping it. Overlapping geometry (bridges, tunnels) simply
+ *  results in several layers of triangles in one cell, and a query returns
+ *  the highest layer below the query point - which is what a ray cast
+ *  straight down returns.
+ *  If the answer is ambiguous (the point is (nearly) on a triangle edge,
+ *  or two layers with different materials have (nearly) the same height),
+ *  or the point is outside of the grid, getTerrainInfo returns QR_UNKNOWN,
+ *  and the caller has to cast a ray.
+ */
+class TerrainCache
+{
+public:
+    enum QueryResult {QR_HIT, QR_NO_HIT, QR_UNKNOWN};
+
+private:
+    /** The data of a triangle needed to answer a query. */
+    struct Triangle
+    {
+        /** x/y coordinates of the vertices. */
+        float           m_x[3], m_y[3];
+        /** Tolerance for each edge, see isInside(). */
+        float           m_tolerance[3];
+        /** Distance from the edges in which a point is ambiguous. */
+        float           m_margin;
+        /** Normalised normal, pointing up. */
+        Vec3            m_normal;
+        /** Plane equation: m_normal * p = m_d. */
+        float           m_d;
+        const Material *m_material;
+    };   // Triangle
+
+    /** Size of a cell in x and y direction. */
+    float                 m_cell_size;
+    Vec3                  m_min;
+    int                   m_num_cells_x, m_num_cells_y;
+    std::vector<Triangle> m_triangles;
+    /** The triangles of cell i are
+     *  m_cell_triangles[m_cell_start[i]] ... m_cell_triangles[m_cell_start[i+1]-1].
+     */
+    std::vector<int>      m_cell_start;
+    std::vector<int>      m_cell_triangles;
+
+    int  isInside(const Triangle &t, float x, float y) const;
+    void getCellRange(const Triangle &t, int *min_x, int *min_y,
+                      int *max_x, int *max_y) const;
+    float getHeight(const Triangle &t, float x, float y) const
+    {
+        return (t.m_d - t.m_normal.getX()*x - t.m_normal.getY()*y)
+              / t.m_normal.getZ();
+    }   // getHeight
+
+public:
+         TerrainCache();
+    void addTriangle(const Vec3 &v1, const Vec3 &v2, const Vec3 &v3,
+                     const Material *material);
+    void addMesh    (const TriangleMesh &mesh);
+    void build(const Vec3 &aabb_min, const Vec3 &aabb_max);
+    QueryResult getTerrainInfo(const Vec3 &pos, float *hot, Vec3 *normal,
+                               const Material **material) const;
+};   // TerrainCache
+
+#endif
+
+/* EOF */
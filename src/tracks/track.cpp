@@ -19,6 +19,7 @@
 
 #include "track.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
@@ -43,6 +44,8 @@
 #include "physics/moving_physics.hpp"
 #include "physics/triangle_mesh.hpp"
 #include "race_manager.hpp"
+#include "tracks/arena_graph.hpp"
+#include "tracks/terrain_cache.hpp"
 #include "utils/ssg_help.hpp"
 #include "utils/string_utils.hpp"
 
@@ -51,7 +54,11 @@ const int   Track::QUAD_TRI_NONE   = -1;
 const int   Track::QUAD_TRI_FIRST  =  1;
 const int   Track::QUAD_TRI_SECOND =  2;
 const int   Track::UNKNOWN_SECTOR  = -1;
-Track      *Track::m_track         = NULL;
+
+/** Default size of a chunk of the track mesh. */
+static const float CHUNK_SIZE = 64.0f;
+/** Maximum number of chunks, if the track is bigger the chunks are enlarged. */
+static const int   MAX_CHUNKS = 256;
 
 //-------------------------------------------------------------------------------------------------
 Track::Track(std::string filename_)
@@ -64,7 +71,9 @@ Track::Track(std::string filename_)
     m_version          = 0;
     m_has_final_camera = false;
     m_is_arena         = false;
-    m_track            = this;
+    m_terrain_cache    = NULL;
+    m_arena_graph      = NULL;
+    m_non_collision_mesh = NULL;
     loadTrack(m_filename);
     loadDriveline();
 
@@ -73,6 +82,7 @@ Track::Track(std::string filename_)
 //-------------------------------------------------------------------------------------------------
 Track::~Track()
 {
+    delete m_arena_graph;
 }   // ~Track
 //-------------------------------------------------------------------------------------------------
 /** Removes the physical body from the world.
@@ -81,8 +91,9 @@ Track::~Track()
 void Track::cleanup()
 {
     ItemManager::destroy();
-    delete m_non_collision_mesh;
-    delete m_track_mesh;
+    deleteTrackMeshes();
+    delete m_terrain_cache;
+    m_terrain_cache = NULL;
 
     // remove temporary materials loaded by the material manager
     material_manager->popTempMaterial();
@@ -852,18 +863,148 @@ void Track::createPhysicsModel()
 {
     if(!m_model) return;
 
-    m_track_mesh         = new TriangleMesh();
-    m_non_collision_mesh = new TriangleMesh();
-    
+    // Divide the track into chunks, similar to the cells of the terrain cache.
+    m_chunk_size = CHUNK_SIZE;
+    while(true)
+    {
+        m_num_chunks_x = (int)((m_aabb_max.getX()-m_aabb_min.getX())/m_chunk_size)+1;
+        m_num_chunks_y = (int)((m_aabb_max.getY()-m_aabb_min.getY())/m_chunk_size)+1;
+        if(m_num_chunks_x*m_num_chunks_y<=MAX_CHUNKS) break;
+        m_chunk_size *= 2.0f;
+    }
+    createTrackMeshes();
+    if(user_config->m_terrain_cache)
+        m_terrain_cache  = new TerrainCache();
+
+    // The cache files of the chunks are called <track>-<chunk>.bvh
+    std::vector<std::string> cache_files;
+    for(unsigned int i=0; i<m_track_meshes.size(); i++)
+    {
+        std::ostringstream name;
+        name<<getIdent()<<"-"<<i<<".bvh";
+        cache_files.push_back(file_manager->getCacheFile(name.str()));
+    }
+    const std::string non_collision_cache =
+        file_manager->getCacheFile(getIdent()+"-nc.bvh");
+    unsigned int key = 0;
+    if(user_config->m_bvh_cache)
+    {
+        // Load the meshes and their BVHs from the cache if it is up to date.
+        key = getPhysicsCacheKey();
+        bool loaded = m_non_collision_mesh->loadCache(non_collision_cache, key,
+                                     btCollisionObject::CF_NO_CONTACT_RESPONSE);
+        for(unsigned int i=0; i<m_track_meshes.size() && loaded; i++)
+            loaded = m_track_meshes[i]->loadCache(cache_files[i], key);
+        if(loaded)
+        {
+            if(m_terrain_cache)
+            {
+                for(unsigned int i=0; i<m_track_meshes.size(); i++)
+                    m_terrain_cache->addMesh(*m_track_meshes[i]);
+                m_terrain_cache->addMesh(*m_non_collision_mesh);
+                m_terrain_cache->build(m_aabb_min, m_aabb_max);
+            }
+            return;
+        }
+        // Only some of the meshes might have been loaded.
+        deleteTrackMeshes();
+        createTrackMeshes();
+    }
+
     // Collect all triangles in the track_mesh
     sgMat4 mat;
     sgMakeIdentMat4(mat);
     convertTrackToBullet(m_model, mat);
-    m_track_mesh->createBody();
+    for(unsigned int i=0; i<m_track_meshes.size(); i++)
+        m_track_meshes[i]->createBody();
     m_non_collision_mesh->createBody(btCollisionObject::CF_NO_CONTACT_RESPONSE);
-    
+    if(m_terrain_cache)
+        m_terrain_cache->build(m_aabb_min, m_aabb_max);
+
+    if(user_config->m_bvh_cache)
+    {
+        for(unsigned int i=0; i<m_track_meshes.size(); i++)
+            m_track_meshes[i]->saveCache(cache_files[i], key);
+        m_non_collision_mesh->saveCache(non_collision_cache, key);
+    }
 }   // createPhysicsModel
 
+//-------------------------------------------------------------------------------------------------
+/** Creates the (empty) meshes of all chunks and the non-collision mesh.
+ */
+void Track::createTrackMeshes()
+{
+    for(int i=0; i<m_num_chunks_x*m_num_chunks_y; i++)
+        m_track_meshes.push_back(new TriangleMesh());
+    m_non_collision_mesh = new TriangleMesh();
+}   // createTrackMeshes
+
+//-------------------------------------------------------------------------------------------------
+/** Deletes all meshes, which also removes their bodies from the physics.
+ */
+void Track::deleteTrackMeshes()
+{
+    for(unsigned int i=0; i<m_track_meshes.size(); i++)
+        delete m_track_meshes[i];
+    m_track_meshes.clear();
+    delete m_non_collision_mesh;
+    m_non_collision_mesh = NULL;
+}   // deleteTrackMeshes
+
+//-------------------------------------------------------------------------------------------------
+/** Returns the index of the chunk containing the given point. Points
+ *  outside of the track are assigned to the closest chunk.
+ */
+int Track::getChunk(const btVector3 &xyz) const
+{
+    int x = (int)floorf((xyz.getX()-m_aabb_min.getX())/m_chunk_size);
+    int y = (int)floorf((xyz.getY()-m_aabb_min.getY())/m_chunk_size);
+    x = std::max(0, std::min(m_num_chunks_x-1, x));
+    y = std::max(0, std::min(m_num_chunks_y-1, y));
+    return y*m_num_chunks_x+x;
+}   // getChunk
+
+//-------------------------------------------------------------------------------------------------
+/** Computes a hash (FNV-1a) of the content of all files the collision
+ *  meshes are created from. A cache file saved with a different key is
+ *  outdated.
+ */
+unsigned int Track::getPhysicsCacheKey() const
+{
+    unsigned int hash = 2166136261u;
+    // The triangles of the chunks depend on the chunk layout.
+    const int layout[3] = {m_num_chunks_x, m_num_chunks_y, (int)m_chunk_size};
+    for(unsigned int j=0; j<sizeof(layout); j++)
+    {
+        hash ^= ((const unsigned char*)layout)[j];
+        hash *= 16777619u;
+    }
+    unsigned char buffer[16384];
+    for(unsigned int i=0; i<m_physics_files.size(); i++)
+    {
+        // Include the name, so that renaming a file changes the key.
+        const std::string &name = m_physics_files[i];
+        for(unsigned int j=0; j<name.size()+1; j++)
+        {
+            hash ^= (unsigned char)name.c_str()[j];
+            hash *= 16777619u;
+        }
+        FILE *fd = fopen(name.c_str(), "rb");
+        if(!fd) continue;
+        size_t n;
+        while((n=fread(buffer, 1, sizeof(buffer), fd))>0)
+        {
+            for(size_t j=0; j<n; j++)
+            {
+                hash ^= buffer[j];
+                hash *= 16777619u;
+            }
+        }
+        fclose(fd);
+    }   // for i<m_physics_files.size()
+    return hash;
+}   // getPhysicsCacheKey
+
 //-------------------------------------------------------------------------------------------------
 /** Convert the ssg track tree into its physics equivalents.
  */
@@ -903,8 +1044,14 @@ void Track::convertTrackToBullet(ssgEntity *track, sgMat4 m)
             }
             else
             {
-                m_track_mesh->addTriangle(vb1, vb2, vb3, material);
+                // Each triangle is only added to the chunk containing
+                // its center, so that a ray can't hit it twice.
+                int chunk = getChunk((vb1+vb2+vb3)/3.0f);
+                m_track_meshes[chunk]->addTriangle(vb1, vb2, vb3, material);
             }
+            // Both meshes are hit by the ray in getTerrainInfo.
+            if(m_terrain_cache)
+                m_terrain_cache->addTriangle(vb1, vb2, vb3, material);
         }
         
     }   // if(track isAKindOf leaf)
@@ -940,10 +1087,14 @@ void Track::loadTrackModel()
     // Add the track directory to the texture search path
     file_manager->pushTextureSearchPath(file_manager->getTrackFile("",getIdent()));
     file_manager->pushModelSearchPath  (file_manager->getTrackFile("",getIdent()));
+    // The materials decide which triangles are part of which mesh.
+    m_physics_files.clear();
+    m_physics_files.push_back(file_manager->getTextureFile("materials.dat"));
     // First read the temporary materials.dat file if it exists
     try
     {
         std::string materials_file = file_manager->getTrackFile("materials.dat",getIdent());
+        m_physics_files.push_back(materials_file);
         material_manager->pushTempMaterial(materials_file);
     }
     catch(std::exception& e)
@@ -952,6 +1103,7 @@ void Track::loadTrackModel()
         (void)e;
     }
     std::string path = file_manager->getTrackFile(getIdent()+".loc");
+    m_physics_files.push_back(path);
 
     FILE *fd = fopen(path.c_str(), "r");
     if(fd == NULL)
@@ -1158,7 +1310,9 @@ void Track::loadTrackModel()
                 }
             }   // if need_hat
 
-            ssgEntity *obj = loader->load(file_manager->getModelFile(fname),
+            std::string model_file = file_manager->getModelFile(fname);
+            m_physics_files.push_back(model_file);
+            ssgEntity *obj = loader->load(model_file,
                                           CB_TRACK, /*optimise*/ true,
                                           /*is_full_path*/ true);
             if(!obj)
@@ -1197,6 +1351,8 @@ void Track::loadTrackModel()
     SSGHelp::MinMax(m_model, &m_aabb_min, &m_aabb_max);
     RaceManager::getWorld()->getPhysics()->init(m_aabb_min, m_aabb_max);
     createPhysicsModel();
+    if(isArena() && !m_arena_graph)
+        m_arena_graph = new ArenaGraph(this);
 }   // loadTrack
 
 //-------------------------------------------------------------------------------------------------
@@ -1225,6 +1381,18 @@ void Track::itemCommand(sgVec3 *xyz, int type, int bNeedHeight )
 void Track::getTerrainInfo(const Vec3 &pos, float *hot, Vec3 *normal, 
                            const Material **material) const
 {
+    if(m_terrain_cache)
+    {
+        switch(m_terrain_cache->getTerrainInfo(pos, hot, normal, material))
+        {
+        case TerrainCache::QR_HIT:     return;
+        case TerrainCache::QR_NO_HIT:  *hot      = NOHIT;
+                                       *material = NULL;
+                                       return;
+        case TerrainCache::QR_UNKNOWN: break;   // cast a ray
+        }
+    }
+
     btVector3 to_pos(pos);
     to_pos.setZ(-100000.f);
 
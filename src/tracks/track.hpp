@@ -37,12 +37,13 @@
 #include "audio/music_information.hpp"
 #include "utils/vec3.hpp"
 
+class ArenaGraph;
+class TerrainCache;
 class TriangleMesh;
 
 class Track
 {
 private:
-    static Track*            m_track;
     float                    m_gravity;
     std::string              m_ident;
     std::string              m_screenshot;
@@ -54,8 +55,23 @@ private:
     std::string              m_filename;
     std::vector<std::string> m_groups;
     ssgBranch*               m_model;
-    TriangleMesh*            m_track_mesh;
+    /** The static track geometry, split into chunks on a grid in the x/y
+     *  plane. Each chunk has its own BVH and broadphase proxy, so karts
+     *  are only paired with nearby chunks. */
+    std::vector<TriangleMesh*> m_track_meshes;
+    /** Size of a chunk in x and y direction. */
+    float                    m_chunk_size;
+    int                      m_num_chunks_x, m_num_chunks_y;
     TriangleMesh*            m_non_collision_mesh;
+    /** Cache of the static geometry for getTerrainInfo, or NULL. */
+    TerrainCache*            m_terrain_cache;
+    /** The navigation graph of an arena (NULL for other tracks). It only
+     *  depends on the track model, so it is created when the arena is
+     *  used the first time, and kept for later races. */
+    ArenaGraph*              m_arena_graph;
+    /** All files the collision meshes are created from, used to detect
+     *  outdated cache files. */
+    std::vector<std::string> m_physics_files;
     bool                     m_has_final_camera;
     Vec3                     m_camera_final_pos;
     Vec3                     m_camera_final_hpr;
@@ -128,7 +144,6 @@ public:
 
                        Track              (std::string filename);
                       ~Track              ();
-    static Track*      get                ()       {return m_track;}
     bool               isArena            () const {return m_is_arena;}
     void               cleanup            ();
     void               addDebugToScene    (int type) const;
@@ -187,6 +202,8 @@ public:
                           y_offset + (v.getY()-m_driveline_min.getY()) * sy);
     }
     void  getAABB(Vec3 *min, Vec3 *max) const {*min=m_aabb_min; *max=m_aabb_max; }
+    /** Returns the navigation graph of an arena, or NULL. */
+    const ArenaGraph *getArenaGraph() const   {return m_arena_graph; }
 private:
     void  loadTrack                      (std::string filename);
     void  itemCommand                    (sgVec3 *xyz, int item_type, int bNeedHeight);
@@ -194,6 +211,10 @@ private:
     void  readDrivelineFromFile          (std::vector<Vec3>& line,
                                          const std::string& file_ext);
     void  convertTrackToBullet           (ssgEntity *track, sgMat4 m);
+    unsigned int getPhysicsCacheKey      () const;
+    void  createTrackMeshes              ();
+    void  deleteTrackMeshes              ();
+    int   getChunk                       (const btVector3 &xyz) const;
 
     float pointSideToLine(const Vec3& L1, const Vec3& L2,
                           const Vec3& P) const;
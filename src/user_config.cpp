@@ -104,6 +104,15 @@ void UserConfig::setDefaults()
     m_background_music  = "";
     m_profile           = 0;
     m_print_kart_sizes  = false;
+    m_no_graphics       = false;
+    m_batch_mode        = false;
+    m_broadphase        = 0;
+    m_broadphase_bench  = 0;
+    m_physics_threads   = 1;
+    m_ai_threads        = 1;
+    m_terrain_cache     = true;
+    m_simulation_lod    = true;
+    m_bvh_cache         = true;
     m_max_fps           = 124;
     m_sfx_volume        = 1.0f;
     m_use_kph           = false;
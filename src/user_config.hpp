@@ -196,6 +196,24 @@ public:
     int         m_profile;         // Positive number: time in seconds, neg: # laps. (used to profile AI)
     bool        m_print_kart_sizes; // print all kart sizes
                                    // 0 if no profiling. Never saved in config file!
+    bool        m_no_graphics;     // Don't render anything (used for benchmarks).
+                                   // Never saved in config file!
+    bool        m_batch_mode;      // All karts are AI karts, fixed dt, no
+                                   // start phase (used by batch races, see
+                                   // BatchRace). Never saved in config file!
+    int         m_broadphase;      // Physics::BroadphaseType to use, never saved.
+    int         m_broadphase_bench;// Number of objects for the broadphase
+                                   // benchmark, 0 if disabled. Never saved.
+    int         m_physics_threads; // Number of threads to solve the physics
+                                   // islands with. Never saved.
+    int         m_ai_threads;      // Number of threads to compute the AI
+                                   // with. Never saved.
+    bool        m_terrain_cache;   // Use a grid to answer height of terrain
+                                   // queries. Never saved.
+    bool        m_simulation_lod;  // Reduce the simulation of AI karts far
+                                   // away from all players. Never saved.
+    bool        m_bvh_cache;       // Load the track collision meshes from
+                                   // the cache directory. Never saved.
     float       m_sfx_volume;
     int         m_max_fps;
     std::string m_username;
@@ -0,0 +1,186 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "utils/profiler.hpp"
+
+Profiler *profiler = 0;
+
+Profiler::Profiler()
+{
+    m_enabled = false;
+    reset();
+}   // Profiler
+
+// ----------------------------------------------------------------------------
+/** Resets all accumulated times and the frame counter. */
+void Profiler::reset()
+{
+    m_clock.reset();
+    for(int i=0; i<PS_COUNT; i++)
+    {
+        m_start_time[i] = 0;
+        m_total_time[i] = 0.0;
+    }
+    m_reset_time  = m_clock.getTimeMicroseconds();
+    m_frame_count = 0;
+    m_bullet_nodes.clear();
+}   // reset
+
+// ----------------------------------------------------------------------------
+const char *Profiler::getSectionName(ProfileSection s)
+{
+    switch(s)
+    {
+    case PS_HISTORY     : return "history";
+    case PS_PHYSICS     : return "physics";
+    case PS_AI          : return "ai";
+    case PS_KARTS       : return "karts";
+    case PS_PROJECTILES : return "projectiles";
+    case PS_ITEMS       : return "items";
+    case PS_CALLBACKS   : return "callbacks";
+    default             : return "unknown";
+    }
+}   // getSectionName
+
+// ----------------------------------------------------------------------------
+/** Prints the accumulated time of each section, both as total time and as
+ *  average time per frame. Any time not covered by a section (e.g. lap
+ *  counting, or graphics if enabled) is reported as 'other'.
+ *  \param out The file to print the summary to.
+ */
+void Profiler::printSummary(FILE *out)
+{
+    float total = getElapsedTime();
+    int   frames = m_frame_count>0 ? m_frame_count : 1;
+    fprintf(out, "frames: %d  wall time: %.3f s  (%.1f frames/s)\n",
+            m_frame_count, total, total>0 ? m_frame_count/total : 0.0f);
+    fprintf(out, "%-12s %10s %12s %7s\n", "section", "total [s]",
+            "per frame[us]", "%");
+    float sum = 0.0f;
+    for(int i=0; i<PS_COUNT; i++)
+    {
+        float t = getSectionTime((ProfileSection)i);
+        sum    += t;
+        fprintf(out, "%-12s %10.4f %12.2f %6.2f%%\n",
+                getSectionName((ProfileSection)i), t,
+                m_total_time[i]/frames, total>0 ? 100.0f*t/total : 0.0f);
+    }
+    float other = total-sum;
+    fprintf(out, "%-12s %10.4f %12.2f %6.2f%%\n", "other", other,
+            other*1000000.0f/frames, total>0 ? 100.0f*other/total : 0.0f);
+
+    if(m_bullet_nodes.size()==0)
+    {
+        fprintf(out, "No bullet profile (configure with "
+                     "--enable-bullet-profile).\n");
+        return;
+    }
+    fprintf(out, "bullet (%% of parent, top level: %% of physics)\n");
+    printBulletNodes(out, -1, 1, frames);
+}   // printSummary
+
+// ----------------------------------------------------------------------------
+/** Adds the timings of bullet's profile tree, which contains the data of
+ *  the last call to stepSimulation, to the accumulated timings. This must
+ *  be called after each physics update.
+ */
+void Profiler::collectBulletProfile()
+{
+    if(!m_enabled) return;
+    CProfileIterator *iterator = CProfileManager::Get_Iterator();
+    collectBulletNodes(iterator, -1);
+    CProfileManager::Release_Iterator(iterator);
+}   // collectBulletProfile
+
+// ----------------------------------------------------------------------------
+/** Recursively adds the timings of all children of the current parent node
+ *  of the iterator.
+ *  \param iterator Bullet profile iterator.
+ *  \param parent Index of the node in m_bullet_nodes corresponding to the
+ *         current parent of the iterator (-1 for the root).
+ */
+void Profiler::collectBulletNodes(CProfileIterator *iterator, int parent)
+{
+    int child = 0;
+    for(iterator->First(); !iterator->Is_Done(); iterator->Next(), child++)
+    {
+        const char *name = iterator->Get_Current_Name();
+        unsigned int n;
+        for(n=0; n<m_bullet_nodes.size(); n++)
+        {
+            if(m_bullet_nodes[n].m_parent==parent &&
+               m_bullet_nodes[n].m_name  ==name     ) break;
+        }
+        if(n==m_bullet_nodes.size())
+        {
+            BulletNode node;
+            node.m_name       = name;
+            node.m_parent     = parent;
+            node.m_calls      = 0;
+            node.m_total_time = 0.0;
+            m_bullet_nodes.push_back(node);
+        }
+        m_bullet_nodes[n].m_calls      += iterator->Get_Current_Total_Calls();
+        m_bullet_nodes[n].m_total_time += iterator->Get_Current_Total_Time();
+
+        // Entering a child resets the iterator to the first child of the
+        // parent, so skip to the current child again afterwards.
+        iterator->Enter_Child(child);
+        collectBulletNodes(iterator, n);
+        iterator->Enter_Parent();
+        for(int i=0; i<child; i++) iterator->Next();
+    }
+}   // collectBulletNodes
+
+// ----------------------------------------------------------------------------
+/** Prints all children of a bullet profile node, and recursively their
+ *  children. Time of a node not covered by its children is printed as
+ *  'other'.
+ *  \param out The file to print to.
+ *  \param parent Index of the parent node, or -1 for the top level.
+ *  \param depth Depth of the children (used for indentation).
+ *  \param frames Number of frames (for the time per frame).
+ */
+void Profiler::printBulletNodes(FILE *out, int parent, int depth, int frames)
+{
+    // Top level nodes are compared with the physics time.
+    double parent_time = parent<0 ? m_total_time[PS_PHYSICS]*0.001
+                                  : m_bullet_nodes[parent].m_total_time;
+    double sum          = 0.0;
+    int    num_children = 0;
+    for(unsigned int i=0; i<m_bullet_nodes.size(); i++)
+    {
+        const BulletNode &node = m_bullet_nodes[i];
+        if(node.m_parent!=parent) continue;
+        num_children++;
+        sum += node.m_total_time;
+        fprintf(out, "%*s%-*s %10.4f %12.2f %6.2f%%\n", 2*depth, "",
+                44-2*depth, node.m_name, node.m_total_time*0.001,
+                node.m_total_time*1000.0/frames,
+                parent_time>0 ? 100.0*node.m_total_time/parent_time : 0.0);
+        printBulletNodes(out, i, depth+1, frames);
+    }
+    if(num_children>0 && parent>=0)
+    {
+        double other = parent_time-sum;
+        fprintf(out, "%*s%-*s %10.4f %12.2f %6.2f%%\n", 2*depth, "",
+                44-2*depth, "other", other*0.001, other*1000.0/frames,
+                parent_time>0 ? 100.0*other/parent_time : 0.0);
+    }
+}   // printBulletNodes
+
+/* EOF */
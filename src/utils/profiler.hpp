@@ -0,0 +1,127 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_PROFILER_HPP
+#define HEADER_PROFILER_HPP
+
+#include <stdio.h>
+#include <vector>
+
+#include "LinearMath/btQuickprof.h"
+
+/** A very simple profiler which accumulates the time spent in the various
+ *  subsystems of a race (physics, karts, items, ...). It is used by the
+ *  benchmark modes (e.g. --replay-bench) to print a summary at the end.
+ *  The time is taken from bullet's btClock, which has a microsecond
+ *  resolution on all supported platforms (SDL_GetTicks only has ms).
+ *  The profiler is disabled by default, in which case start/stop are
+ *  basically no-ops.
+ *  Additionally the hierarchical timings of bullet's internal profiler
+ *  (CProfileManager) are accumulated, which split the physics time into
+ *  broadphase, narrowphase, solver, integration, wheel raycasts etc.
+ *  Bullet resets its profile in each call to stepSimulation, so
+ *  collectBulletProfile() must be called after each physics update.
+ *  Bullet's timings are only available if STK is configured with
+ *  --enable-bullet-profile (otherwise BT_NO_PROFILE is defined).
+ */
+class Profiler
+{
+public:
+    /** The subsystems for which the time is measured. */
+    enum ProfileSection {PS_HISTORY, PS_PHYSICS, PS_AI, PS_KARTS,
+                         PS_PROJECTILES, PS_ITEMS, PS_CALLBACKS, PS_COUNT};
+private:
+    /** The clock used to measure all times. */
+    btClock       m_clock;
+    /** Time (in microseconds) at which a section was started. */
+    unsigned long m_start_time[PS_COUNT];
+    /** Accumulated time (in microseconds) for each section. */
+    double        m_total_time[PS_COUNT];
+    /** Time at which the profiler was reset. */
+    unsigned long m_reset_time;
+    /** Number of frames since the last reset. */
+    int           m_frame_count;
+    /** True if the profiler is collecting data. */
+    bool          m_enabled;
+
+    /** Accumulated data of one node of bullet's profile tree. */
+    struct BulletNode
+    {
+        /** Name of the node, bullet uses static strings. */
+        const char *m_name;
+        /** Index of the parent node, or -1 for a top level node. */
+        int         m_parent;
+        int         m_calls;
+        /** Accumulated time in milliseconds (bullet's unit). */
+        double      m_total_time;
+    };   // BulletNode
+    /** All bullet profile nodes in the order they were first seen. */
+    std::vector<BulletNode> m_bullet_nodes;
+
+    static const char *getSectionName(ProfileSection s);
+    void collectBulletNodes(CProfileIterator *iterator, int parent);
+    void printBulletNodes(FILE *out, int parent, int depth, int frames);
+public:
+         Profiler();
+    void reset();
+    void printSummary(FILE *out);
+    void collectBulletProfile();
+    // ------------------------------------------------------------------------
+    /** Enables or disables the profiler. */
+    void setEnabled(bool b)   { m_enabled = b;    }
+    // ------------------------------------------------------------------------
+    /** Returns true if the profiler is collecting data. */
+    bool isEnabled() const    { return m_enabled; }
+    // ------------------------------------------------------------------------
+    /** Called once per frame to count the number of frames. */
+    void nextFrame()          { if(m_enabled) m_frame_count++; }
+    // ------------------------------------------------------------------------
+    /** Returns the number of frames since the last reset. */
+    int  getFrameCount() const { return m_frame_count; }
+    // ------------------------------------------------------------------------
+    /** Returns the wall clock time in seconds since the last reset. */
+    float getElapsedTime()
+    {
+        return (m_clock.getTimeMicroseconds()-m_reset_time)*0.000001f;
+    }   // getElapsedTime
+    // ------------------------------------------------------------------------
+    /** Returns the accumulated time of a section in seconds. */
+    float getSectionTime(ProfileSection s) const
+    {
+        return (float)(m_total_time[s]*0.000001);
+    }   // getSectionTime
+    // ------------------------------------------------------------------------
+    /** Starts timing a section. */
+    void start(ProfileSection s)
+    {
+        if(!m_enabled) return;
+        m_start_time[s] = m_clock.getTimeMicroseconds();
+    }   // start
+    // ------------------------------------------------------------------------
+    /** Stops timing a section and adds the elapsed time to its total. */
+    void stop(ProfileSection s)
+    {
+        if(!m_enabled) return;
+        m_total_time[s] += m_clock.getTimeMicroseconds() - m_start_time[s];
+    }   // stop
+};   // Profiler
+
+extern Profiler *profiler;
+
+#endif
+
+/* EOF */
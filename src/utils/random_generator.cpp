@@ -19,52 +19,81 @@
 
 #include "random_generator.hpp"
 
-#include <stdlib.h>
 #include <ctime>
 
 std::vector<RandomGenerator*> RandomGenerator::m_all_random_generators;
+unsigned int RandomGenerator::m_master_seed = (unsigned int)std::time(0);
+unsigned int RandomGenerator::m_seed_state  = RandomGenerator::m_master_seed;
 
 RandomGenerator::RandomGenerator()
 {
-    m_a = 1103515245;
-    m_c = 12345;
     m_all_random_generators.push_back(this);
-    m_random_value = 3141591;
-    std::srand((unsigned int)std::time(0));
+    seed(nextSeed());
 }   // RandomGenerator
 
 // ----------------------------------------------------------------------------
+/** Removes this generator from the list of all generators, so that
+ *  generateAllSeeds does not access deleted objects.
+ */
+RandomGenerator::~RandomGenerator()
+{
+    std::vector<RandomGenerator*>::iterator i =
+        std::find(m_all_random_generators.begin(),
+                  m_all_random_generators.end(), this);
+    if(i!=m_all_random_generators.end())
+        m_all_random_generators.erase(i);
+}   // ~RandomGenerator
+
+// ----------------------------------------------------------------------------
+/** Returns the next seed from the seed sequence. This uses a 32 bit variant
+ *  of splitmix, which gives well distributed seeds even for consecutive
+ *  master seeds.
+ */
+unsigned int RandomGenerator::nextSeed()
+{
+    unsigned int z = (m_seed_state += 0x9e3779b9u);
+    z = (z ^ (z >> 16)) * 0x85ebca6bu;
+    z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+    return z ^ (z >> 16);
+}   // nextSeed
+
+// ----------------------------------------------------------------------------
+/** Seeds this generator. The full 128 bit state is filled using splitmix,
+ *  so that similar seeds still result in unrelated sequences.
+ *  \param s The seed to use.
+ */
+void RandomGenerator::seed(int s)
+{
+    unsigned int z = (unsigned int)s;
+    for(unsigned int i=0; i<4; i++)
+    {
+        z += 0x9e3779b9u;
+        unsigned int x = z;
+        x = (x ^ (x >> 16)) * 0x85ebca6bu;
+        x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+        m_state[i] = x ^ (x >> 16);
+    }
+    // The all-zero state is the only invalid state of xoshiro.
+    if(!m_state[0] && !m_state[1] && !m_state[2] && !m_state[3])
+        m_state[0] = 1;
+}   // seed
+
+// ----------------------------------------------------------------------------
+/** Restarts the seed sequence from the master seed, and seeds all existing
+ *  generators (in the order in which they were created). This is called at
+ *  the start of each race, so that all random numbers in a race only depend
+ *  on the master seed.
+ *  \return The seeds used for all generators.
+ */
 std::vector<int> RandomGenerator::generateAllSeeds()
 {
+    m_seed_state = m_master_seed;
     std::vector<int> all_seeds;
     for(unsigned int i=0; i<m_all_random_generators.size(); i++)
     {
-        int seed = rand();
+        int seed = (int)nextSeed();
         all_seeds.push_back(seed);
         m_all_random_generators[i]->seed(seed);
     }
     return all_seeds;
 }   // generateAllSeeds
-
-#if 0
-
-// ----------------------------------------------------------------------------
-int RandomGenerator::get(int n)
-{
-    // This generator is (currently) not good enough, i.e. it often gives
-    // long sequences of same numbers. And the seeding is not done (the
-    // mid term goal is to synchronise all random number generators on
-    // client and server to make less communication necessary).
-    // For now: just use standard random numbers:
-    return rand() % n;
-#ifdef NOT_USED_ATM
-    m_random_value = m_random_value*m_a+m_c;
-    // Note: the lower bits can have a very short cycle, e.g. for n = 4 the
-    // cycle length is 4, meaning that the same sequence 1,2,3,4 is repeated
-    // over and over again. The higher bits are more random, so the lower
-    // 8 bits are discarded.
-    return (m_random_value >> 8) % n;
-#endif
-}   // get
-
-#endif // if 0
@@ -24,26 +24,79 @@
 #include <vector>
 
 /** A random number generator. Each objects that needs a random number uses
-    its own number random generator. They are all seeded with number provided
-    by the server. This guarantees that in a network game all 'random' values
-    are actually identical among all machines.
-    The formula used is x(n+1)=(a*x(n)+c) % m, but m is assumed to be 2^32,
-    so the modulo operation can be skipped (for 4 byte integers).
+    its own number random generator. They are all seeded from one master
+    seed, so that all 'random' values only depend on that seed. Note that
+    the network code does not send the master seed to the clients yet, so
+    in a network game the random values are not identical on all machines.
+    The generator used is xoshiro128** (by Blackman and Vigna), which has a
+    32 bit output, a period of 2^128-1, and passes all common statistical
+    tests. It only needs a few shifts and xors per number, and since each
+    generator has its own state no global libc state is used.
+    All generators are seeded (in the order in which they were created)
+    from a single master seed, see generateAllSeeds(). Generators that are
+    created later receive the next seed from the same seed sequence, so
+    with the same master seed and the same race setup all random numbers
+    are reproducible.
  */
 class RandomGenerator
 {
 private:
-    unsigned int m_random_value;
-    unsigned int m_a, m_c;
+    /** The internal state of the xoshiro128** generator. */
+    unsigned int m_state[4];
     static std::vector<RandomGenerator*> m_all_random_generators;
+    /** The master seed from which all seeds are derived. */
+    static unsigned int m_master_seed;
+    /** State of the splitmix sequence used to create the seeds for the
+     *  individual generators. */
+    static unsigned int m_seed_state;
+
+    static unsigned int nextSeed();
+    // ------------------------------------------------------------------------
+    static unsigned int rotl(unsigned int x, int k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }   // rotl
+    // ------------------------------------------------------------------------
+    /** Returns the next 32 bit random number. */
+    unsigned int next()
+    {
+        const unsigned int result = rotl(m_state[1] * 5, 7) * 9;
+        const unsigned int t      = m_state[1] << 9;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3]  = rotl(m_state[3], 11);
+        return result;
+    }   // next
 
 public:
-    RandomGenerator();
+         RandomGenerator();
+        ~RandomGenerator();
+    void seed(int s);
 
-    std::vector<int> generateAllSeeds();
-    /** Returns a pseudo random number between 0 and n-1 inclusive */
-    int  get(int n)  {return rand() % n; }
-    void seed(int s) {m_random_value = s;}
+    static std::vector<int> generateAllSeeds();
+    // ------------------------------------------------------------------------
+    /** Sets the master seed, e.g. to the value received from the server,
+     *  or from a history file. */
+    static void setMasterSeed(unsigned int s) { m_master_seed = s;    }
+    // ------------------------------------------------------------------------
+    /** Returns the master seed. */
+    static unsigned int getMasterSeed()       { return m_master_seed; }
+    // ------------------------------------------------------------------------
+    /** Returns a pseudo random number between 0 and n-1 inclusive. The
+     *  upper bits are used (via a multiplication), since they are the
+     *  best random bits of xoshiro128**. Like a modulo operation this has
+     *  a small bias if n is not a power of 2 (at most n/2^32), which is
+     *  not noticeable for the small values of n used in the game. */
+    int  get(int n)
+    {
+        return (int)(((unsigned long long)next() * (unsigned int)n) >> 32);
+    }   // get
+    // ------------------------------------------------------------------------
+    /** Returns a pseudo random float in [0,1). */
+    float getFloat() { return (next() >> 8) * (1.0f/16777216.0f); }
 };  // RandomGenerator
 
 #endif // HEADER_RANDOM_GENERATOR_HPP
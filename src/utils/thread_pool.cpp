@@ -0,0 +1,140 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "utils/thread_pool.hpp"
+
+#include <SDL/SDL_thread.h>
+
+//-----------------------------------------------------------------------------
+/** Creates the worker threads.
+ *  \param num_threads Total number of threads to use, including the thread
+ *         calling run(). So num_threads-1 worker threads are created.
+ */
+ThreadPool::ThreadPool(int num_threads)
+{
+    m_mutex        = SDL_CreateMutex();
+    m_start_cond   = SDL_CreateCond();
+    m_done_cond    = SDL_CreateCond();
+    m_function     = NULL;
+    m_data         = NULL;
+    m_num_jobs     = 0;
+    m_next_job     = 0;
+    m_busy_workers = 0;
+    m_generation   = 0;
+    m_stop         = false;
+    // The worker info must not be reallocated once the threads are started.
+    m_worker_info.resize(num_threads>1 ? num_threads-1 : 0);
+    for(unsigned int i=0; i<m_worker_info.size(); i++)
+    {
+        m_worker_info[i].m_pool         = this;
+        m_worker_info[i].m_thread_index = i+1;
+        m_threads.push_back(SDL_CreateThread(&ThreadPool::workerMain,
+                                             &m_worker_info[i]));
+    }
+}   // ThreadPool
+
+//-----------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+    SDL_LockMutex(m_mutex);
+    m_stop = true;
+    SDL_CondBroadcast(m_start_cond);
+    SDL_UnlockMutex(m_mutex);
+    for(unsigned int i=0; i<m_threads.size(); i++)
+        SDL_WaitThread(m_threads[i], NULL);
+    SDL_DestroyCond(m_done_cond);
+    SDL_DestroyCond(m_start_cond);
+    SDL_DestroyMutex(m_mutex);
+}   // ~ThreadPool
+
+//-----------------------------------------------------------------------------
+/** Executes f(data, job, thread) for all 0<=job<num_jobs, and returns once
+ *  all jobs are done.
+ */
+void ThreadPool::run(JobFunction f, void *data, int num_jobs)
+{
+    if(m_threads.size()==0 || num_jobs<2)
+    {
+        for(int i=0; i<num_jobs; i++)
+            f(data, i, 0);
+        return;
+    }
+    SDL_LockMutex(m_mutex);
+    m_function     = f;
+    m_data         = data;
+    m_num_jobs     = num_jobs;
+    m_next_job     = 0;
+    m_busy_workers = (int)m_threads.size();
+    m_generation++;
+    SDL_CondBroadcast(m_start_cond);
+    SDL_UnlockMutex(m_mutex);
+
+    doJobs(0);
+
+    SDL_LockMutex(m_mutex);
+    while(m_busy_workers>0)
+        SDL_CondWait(m_done_cond, m_mutex);
+    SDL_UnlockMutex(m_mutex);
+}   // run
+
+//-----------------------------------------------------------------------------
+/** Fetches and executes jobs until all jobs are handed out.
+ *  \param thread Index of the calling thread.
+ */
+void ThreadPool::doJobs(int thread)
+{
+    while(true)
+    {
+        SDL_LockMutex(m_mutex);
+        int job = m_next_job++;
+        SDL_UnlockMutex(m_mutex);
+        if(job>=m_num_jobs) break;
+        m_function(m_data, job, thread);
+    }
+}   // doJobs
+
+//-----------------------------------------------------------------------------
+/** The main function of a worker thread: waits for new jobs and executes
+ *  them, till the pool is stopped.
+ *  \param data Pointer to the WorkerInfo of this thread.
+ */
+int ThreadPool::workerMain(void *data)
+{
+    WorkerInfo *info = (WorkerInfo*)data;
+    ThreadPool *pool = info->m_pool;
+    int generation   = 0;
+    SDL_LockMutex(pool->m_mutex);
+    while(true)
+    {
+        while(pool->m_generation==generation && !pool->m_stop)
+            SDL_CondWait(pool->m_start_cond, pool->m_mutex);
+        if(pool->m_stop) break;
+        generation = pool->m_generation;
+        SDL_UnlockMutex(pool->m_mutex);
+
+        pool->doJobs(info->m_thread_index);
+
+        SDL_LockMutex(pool->m_mutex);
+        pool->m_busy_workers--;
+        if(pool->m_busy_workers==0)
+            SDL_CondSignal(pool->m_done_cond);
+    }
+    SDL_UnlockMutex(pool->m_mutex);
+    return 0;
+}   // workerMain
+
+/* EOF */
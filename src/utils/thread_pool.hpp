@@ -0,0 +1,86 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_THREAD_POOL_HPP
+#define HEADER_THREAD_POOL_HPP
+
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+/** A small pool of worker threads to execute a number of independent jobs
+ *  in parallel. run() hands out the jobs one by one to the workers and to
+ *  the calling thread, and only returns once all jobs are done. Which
+ *  thread executes which job is not deterministic, so a job must only
+ *  write to data that belongs to this job (or to the thread index it is
+ *  called with), and results must be combined in job order afterwards.
+ */
+class ThreadPool
+{
+public:
+    /** The function executed for each job.
+     *  \param data The data pointer passed to run().
+     *  \param job Index of the job, 0<=job<num_jobs.
+     *  \param thread Index of the executing thread, 0 is the calling
+     *         thread, 0<=thread<getNumThreads(). */
+    typedef void (*JobFunction)(void *data, int job, int thread);
+
+private:
+    /** Information passed to a worker thread. */
+    struct WorkerInfo
+    {
+        ThreadPool *m_pool;
+        int         m_thread_index;
+    };   // WorkerInfo
+
+    std::vector<SDL_Thread*> m_threads;
+    std::vector<WorkerInfo>  m_worker_info;
+    SDL_mutex               *m_mutex;
+    /** Signalled when new jobs are available (or the pool is stopped). */
+    SDL_cond                *m_start_cond;
+    /** Signalled when the last worker has finished. */
+    SDL_cond                *m_done_cond;
+
+    JobFunction              m_function;
+    void                    *m_data;
+    int                      m_num_jobs;
+    /** Index of the next job to hand out. */
+    int                      m_next_job;
+    /** Number of workers that have not finished the current jobs. */
+    int                      m_busy_workers;
+    /** Incremented for each call to run(), so that a worker can detect
+     *  new jobs. */
+    int                      m_generation;
+    bool                     m_stop;
+
+    static int workerMain(void *data);
+    void       doJobs(int thread);
+
+public:
+         ThreadPool(int num_threads);
+        ~ThreadPool();
+    void run(JobFunction f, void *data, int num_jobs);
+    // ------------------------------------------------------------------------
+    /** Returns the number of threads including the calling thread. */
+    int  getNumThreads() const { return (int)m_threads.size()+1; }
+};   // ThreadPool
+
+#endif
+
+/* EOF */
@@ -0,0 +1,134 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "utils/worker_processes.hpp"
+
+#include <stdlib.h>
+#if !defined(WIN32) || defined(__CYGWIN__)
+#  include <unistd.h>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#endif
+
+//-----------------------------------------------------------------------------
+/** Returns true if worker processes can be used on this platform.
+ */
+bool WorkerProcesses::isSupported()
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+    return false;
+#else
+    return true;
+#endif
+}   // isSupported
+
+//-----------------------------------------------------------------------------
+/** Starts the worker processes. This must be called before the graphics
+ *  are initialised, so that each worker creates its own window and GL
+ *  context. If fork or pipe fail, the program is aborted.
+ *  \param num_workers Number of worker processes to start.
+ *  \param use_commands True if command pipes to the workers are needed.
+ *  \return The index of the worker (0<=index<num_workers) in a worker
+ *          process, or -1 in the parent process.
+ */
+int WorkerProcesses::start(int num_workers, bool use_commands)
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+    fprintf(stderr, "Worker processes are not supported.\n");
+    exit(-1);
+#else
+    for(int i=0; i<num_workers; i++)
+    {
+        int command_fd[2], result_fd[2];
+        if(pipe(result_fd)!=0 || (use_commands && pipe(command_fd)!=0))
+        {
+            fprintf(stderr, "Can not create pipes for worker %d.\n", i);
+            exit(-1);
+        }
+        // Avoid that buffered output is written by parent and child
+        fflush(stdout);
+        fflush(stderr);
+        pid_t pid = fork();
+        if(pid<0)
+        {
+            fprintf(stderr, "Can not start worker %d.\n", i);
+            exit(-1);
+        }
+        if(pid==0)
+        {
+            // Worker process: close the pipes of the other workers
+            for(unsigned int j=0; j<m_result_files.size(); j++)
+            {
+                if(m_command_files[j]) fclose(m_command_files[j]);
+                fclose(m_result_files[j]);
+            }
+            m_command_files.clear();
+            m_result_files.clear();
+            m_pids.clear();
+            close(result_fd[0]);
+            m_result_files.push_back(fdopen(result_fd[1], "w"));
+            if(use_commands)
+            {
+                close(command_fd[1]);
+                m_command_files.push_back(fdopen(command_fd[0], "r"));
+            }
+            else
+                m_command_files.push_back(NULL);
+            return i;
+        }
+        close(result_fd[1]);
+        m_result_files.push_back(fdopen(result_fd[0], "r"));
+        if(use_commands)
+        {
+            close(command_fd[0]);
+            m_command_files.push_back(fdopen(command_fd[1], "w"));
+        }
+        else
+            m_command_files.push_back(NULL);
+        m_pids.push_back(pid);
+    }   // for i<num_workers
+#endif
+    return -1;
+}   // start
+
+//-----------------------------------------------------------------------------
+/** Called in the parent process once all results are read. It closes all
+ *  pipes (so workers waiting for a command get an end of file), and waits
+ *  for all workers to finish.
+ */
+void WorkerProcesses::finish()
+{
+#if !defined(WIN32) || defined(__CYGWIN__)
+    for(unsigned int i=0; i<m_result_files.size(); i++)
+    {
+        if(m_command_files[i]) fclose(m_command_files[i]);
+        fclose(m_result_files[i]);
+    }
+    m_command_files.clear();
+    m_result_files.clear();
+    for(unsigned int i=0; i<m_pids.size(); i++)
+    {
+        int status;
+        waitpid(m_pids[i], &status, 0);
+        if(!WIFEXITED(status) || WEXITSTATUS(status)!=0)
+            fprintf(stderr, "Worker %d did not finish properly.\n", i);
+    }
+    m_pids.clear();
+#endif
+}   // finish
+
+/* EOF */
@@ -0,0 +1,63 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2009 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_WORKER_PROCESSES_HPP
+#define HEADER_WORKER_PROCESSES_HPP
+
+#include <stdio.h>
+#include <vector>
+
+/** Starts a number of worker processes (using fork), each connected to the
+ *  parent process with a result pipe (worker to parent) and optionally a
+ *  command pipe (parent to worker). This is used by the headless batch
+ *  modes (e.g. the GP simulation), which can't use threads since the race
+ *  code depends on many global objects.
+ *  Worker processes are not supported on windows (see isSupported()).
+ */
+class WorkerProcesses
+{
+private:
+    /** In the parent: the command pipe to each worker (or NULL if no
+     *  command pipes are used). In a worker: only one entry, the command
+     *  pipe from the parent. */
+    std::vector<FILE*> m_command_files;
+    /** In the parent: the result pipe from each worker. In a worker: only
+     *  one entry, the result pipe to the parent. */
+    std::vector<FILE*> m_result_files;
+    /** The process ids of all workers (only in the parent). */
+    std::vector<int>   m_pids;
+
+public:
+    static bool isSupported();
+    int  start (int num_workers, bool use_commands);
+    void finish();
+    // ------------------------------------------------------------------------
+    /** Returns the number of workers started (in the parent). */
+    int   getNumWorkers() const       { return (int)m_pids.size();  }
+    // ------------------------------------------------------------------------
+    /** In the parent returns the command pipe to worker i, in a worker the
+     *  command pipe from the parent (i must be 0). */
+    FILE *getCommandFile(int i) const { return m_command_files[i];  }
+    // ------------------------------------------------------------------------
+    /** In the parent returns the result pipe from worker i, in a worker the
+     *  result pipe to the parent (i must be 0). */
+    FILE *getResultFile(int i) const  { return m_result_files[i];   }
+};   // WorkerProcesses
+
+#endif
+
+/* EOF */